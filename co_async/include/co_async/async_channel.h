@@ -0,0 +1,198 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "co_async/utils/waiter_list.h"
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 有界协程通道, 缓冲区满时发送方挂起, 为空时接收方挂起, 形成天然的背压
+/// - 有接收方等待时发送的值直接交给接收方, 不经过缓冲区
+/// - close 后发送失败, 已缓冲的值仍可接收, 接收完后 receive 返回 std::nullopt
+/// - 被唤醒的协程在唤醒方的线程上恢复
+/// - 等待可以通过所在协程的 stop_token 取消, 此时抛出 OperationCancelled, 值没有发出或取出
+template <typename T>
+class AsyncChannel : public Noncopyable {
+public:
+    struct SendAwaiter : CancellableWaiter {
+        SendAwaiter(AsyncChannel& channel, T value)
+            : CancellableWaiter(channel.mutex_), channel_(channel), value_(std::move(value)) {}
+
+        constexpr bool await_ready() const noexcept { return false; }
+
+        template <typename P>
+        bool await_suspend(std::coroutine_handle<P> coroutine) {
+            prepare(coroutine);
+            return channel_.sendOrEnqueue(*this);
+        }
+
+        /// @brief 通道已关闭时返回 false
+        bool await_resume() const {
+            throwIfCancelled();
+            return sent_;
+        }
+
+        AsyncChannel& channel_;
+        T value_;
+        bool sent_{false};
+    };
+
+    struct ReceiveAwaiter : CancellableWaiter {
+        explicit ReceiveAwaiter(AsyncChannel& channel) : CancellableWaiter(channel.mutex_), channel_(channel) {}
+
+        constexpr bool await_ready() const noexcept { return false; }
+
+        template <typename P>
+        bool await_suspend(std::coroutine_handle<P> coroutine) {
+            prepare(coroutine);
+            return channel_.receiveOrEnqueue(*this);
+        }
+
+        /// @brief 通道已关闭且没有剩余的值时返回 std::nullopt
+        std::optional<T> await_resume() {
+            throwIfCancelled();
+            return std::move(value_);
+        }
+
+        AsyncChannel& channel_;
+        std::optional<T> value_;
+    };
+
+    explicit AsyncChannel(std::size_t capacity) : capacity_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("AsyncChannel capacity must be positive");
+        }
+    }
+
+    /// @brief bool sent = co_await channel.send(value)
+    SendAwaiter send(T value) { return SendAwaiter(*this, std::move(value)); }
+
+    /// @brief std::optional<T> value = co_await channel.receive()
+    ReceiveAwaiter receive() { return ReceiveAwaiter(*this); }
+
+    /// @brief 不挂起地发送, 通道已满或已关闭时返回 false
+    bool trySend(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_) {
+            return false;
+        }
+        if (auto* receiver = static_cast<ReceiveAwaiter*>(receivers_.popFront())) {
+            receiver->value_.emplace(std::move(value));
+            lock.unlock();
+            receiver->coroutine_.resume();
+            return true;
+        }
+        if (buffer_.size() >= capacity_) {
+            return false;
+        }
+        buffer_.push_back(std::move(value));
+        return true;
+    }
+
+    /// @brief 不挂起地接收, 没有值时返回 std::nullopt
+    std::optional<T> tryReceive() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (buffer_.empty()) {
+            return std::nullopt;
+        }
+        return popAndRefill(lock);
+    }
+
+    /// @brief 关闭通道, 在当前线程恢复所有等待的发送方 (返回 false) 和接收方 (返回 std::nullopt)
+    void close() {
+        ReadyList ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            ready.claimAll(senders_);
+            ready.claimAll(receivers_);
+        }
+        ready.resumeAll();
+    }
+
+    bool isClosed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffer_.size();
+    }
+
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    /// @brief 取出缓冲区头部的值, 有发送方等待时把它的值补入缓冲区并恢复它, 返回前释放 lock
+    T popAndRefill(std::unique_lock<std::mutex>& lock) {
+        T value = std::move(buffer_.front());
+        buffer_.pop_front();
+        auto* sender = static_cast<SendAwaiter*>(senders_.popFront());
+        if (sender) {
+            buffer_.push_back(std::move(sender->value_));
+            sender->sent_ = true;
+        }
+        lock.unlock();
+        if (sender) {
+            sender->coroutine_.resume();
+        }
+        return value;
+    }
+
+    /// @brief 能立即完成时返回 false, 否则排队并返回 true
+    bool sendOrEnqueue(SendAwaiter& sender) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_) {
+            return false;
+        }
+        if (auto* receiver = static_cast<ReceiveAwaiter*>(receivers_.popFront())) {
+            receiver->value_.emplace(std::move(sender.value_));
+            sender.sent_ = true;
+            lock.unlock();
+            receiver->coroutine_.resume();
+            return false;
+        }
+        if (buffer_.size() < capacity_) {
+            buffer_.push_back(std::move(sender.value_));
+            sender.sent_ = true;
+            return false;
+        }
+        if (sender.cancelIfStopped()) {
+            return false;
+        }
+        senders_.pushBack(sender);
+        return true;
+    }
+
+    bool receiveOrEnqueue(ReceiveAwaiter& receiver) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!buffer_.empty()) {
+            receiver.value_.emplace(popAndRefill(lock));
+            return false;
+        }
+        if (closed_ || receiver.cancelIfStopped()) {
+            return false;
+        }
+        receivers_.pushBack(receiver);
+        return true;
+    }
+
+private:
+    const std::size_t capacity_;
+    std::mutex mutex_;
+    bool closed_{false};
+    std::deque<T> buffer_;
+    WaiterList senders_;    // 节点为 SendAwaiter
+    WaiterList receivers_;  // 节点为 ReceiveAwaiter
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+
+#include "co_async/utils/waiter_list.h"
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 手动复位的协程事件, set 后所有等待者 (包括之后的) 都直接通过, 直到 reset
+/// 等待可以通过所在协程的 stop_token 取消 (如 when_any 中未胜出的分支), 此时抛出 OperationCancelled
+class AsyncEvent : public Noncopyable {
+public:
+    struct WaitAwaiter : CancellableWaiter {
+        explicit WaitAwaiter(AsyncEvent& event) : CancellableWaiter(event.mutex_), event_(event) {}
+
+        bool await_ready() { return event_.isSet(); }
+
+        template <typename P>
+        bool await_suspend(std::coroutine_handle<P> coroutine) {
+            prepare(coroutine);
+            return event_.enqueue(*this);
+        }
+
+        void await_resume() const { throwIfCancelled(); }
+
+        AsyncEvent& event_;
+    };
+
+    explicit AsyncEvent(bool set = false) : set_(set) {}
+
+    WaitAwaiter wait() { return WaitAwaiter(*this); }
+
+    /// @brief 设置事件并在当前线程恢复所有等待者
+    /// 等待者在持锁时被认领, 之后 cancel 不会再触碰它们, 释放锁后恢复时不与 cancel 竞争
+    void set() {
+        ReadyList ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            set_ = true;
+            ready.claimAll(waiters_);
+        }
+        ready.resumeAll();
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        set_ = false;
+    }
+
+    bool isSet() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return set_;
+    }
+
+private:
+    bool enqueue(CancellableWaiter& node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (set_ || node.cancelIfStopped()) {
+            return false;
+        }
+        waiters_.pushBack(node);
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    bool set_;
+    WaiterList waiters_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
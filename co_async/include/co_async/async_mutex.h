@@ -0,0 +1,113 @@
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+#include <utility>
+
+#include "co_async/utils/waiter_list.h"
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+class AsyncMutex;
+
+/// @brief 持有 AsyncMutex, 析构时解锁
+class AsyncLockGuard {
+public:
+    AsyncLockGuard(AsyncMutex& mutex, std::adopt_lock_t) noexcept : mutex_(&mutex) {}
+
+    AsyncLockGuard(AsyncLockGuard&& other) noexcept : mutex_(std::exchange(other.mutex_, nullptr)) {}
+
+    AsyncLockGuard& operator=(AsyncLockGuard&&) = delete;
+
+    ~AsyncLockGuard();
+
+private:
+    AsyncMutex* mutex_;
+};
+
+/// @brief 协程互斥锁, 获取不到锁时挂起协程而不是阻塞线程
+/// - 按等待顺序公平获取, unlock 时直接把锁交给第一个等待者并在当前线程恢复它
+/// - 可以在多个线程上使用; 等待可以通过所在协程的 stop_token 取消 (如 when_any 中未胜出的分支), 此时抛出
+///   OperationCancelled 且没有获得锁
+class AsyncMutex : public Noncopyable {
+public:
+    struct LockAwaiter : CancellableWaiter {
+        explicit LockAwaiter(AsyncMutex& mutex) : CancellableWaiter(mutex.mutex_), mutex_(mutex) {}
+
+        bool await_ready() { return mutex_.tryLock(); }
+
+        template <typename P>
+        bool await_suspend(std::coroutine_handle<P> coroutine) {
+            prepare(coroutine);
+            return mutex_.enqueue(*this);
+        }
+
+        void await_resume() const { throwIfCancelled(); }
+
+        AsyncMutex& mutex_;
+    };
+
+    struct ScopedLockAwaiter : LockAwaiter {
+        using LockAwaiter::LockAwaiter;
+
+        AsyncLockGuard await_resume() const {
+            throwIfCancelled();
+            return AsyncLockGuard(mutex_, std::adopt_lock);
+        }
+    };
+
+    /// @brief co_await mutex.lock() 获取锁, 需要手动 unlock
+    LockAwaiter lock() { return LockAwaiter(*this); }
+
+    /// @brief auto guard = co_await mutex.scopedLock() 获取锁, guard 析构时解锁
+    ScopedLockAwaiter scopedLock() { return ScopedLockAwaiter(*this); }
+
+    bool tryLock() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !std::exchange(locked_, true);
+    }
+
+    void unlock() {
+        WaiterNode* next;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            next = waiters_.popFront();
+            if (!next) {
+                locked_ = false;
+                return;
+            }
+        }
+        // 锁的所有权直接转交, locked_ 保持为 true
+        next->coroutine_.resume();
+    }
+
+private:
+    /// @brief 锁已释放时直接获取并返回 false, 否则排队并返回 true
+    bool enqueue(CancellableWaiter& node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!std::exchange(locked_, true)) {
+            return false;
+        }
+        if (node.cancelIfStopped()) {
+            return false;
+        }
+        waiters_.pushBack(node);
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    bool locked_{false};
+    WaiterList waiters_;
+};
+
+inline AsyncLockGuard::~AsyncLockGuard() {
+    if (mutex_) {
+        mutex_->unlock();
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+
+#include "co_async/utils/waiter_list.h"
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 协程计数信号量, 没有可用许可时挂起协程
+/// release 优先把许可交给等待者并在当前线程恢复它们, 剩余的许可才累加到计数中
+/// 等待可以通过所在协程的 stop_token 取消, 此时抛出 OperationCancelled 且没有获得许可
+class AsyncSemaphore : public Noncopyable {
+public:
+    struct AcquireAwaiter : CancellableWaiter {
+        explicit AcquireAwaiter(AsyncSemaphore& semaphore)
+            : CancellableWaiter(semaphore.mutex_), semaphore_(semaphore) {}
+
+        bool await_ready() { return semaphore_.tryAcquire(); }
+
+        template <typename P>
+        bool await_suspend(std::coroutine_handle<P> coroutine) {
+            prepare(coroutine);
+            return semaphore_.enqueue(*this);
+        }
+
+        void await_resume() const { throwIfCancelled(); }
+
+        AsyncSemaphore& semaphore_;
+    };
+
+    explicit AsyncSemaphore(std::size_t count) : count_(count) {}
+
+    AcquireAwaiter acquire() { return AcquireAwaiter(*this); }
+
+    bool tryAcquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == 0) {
+            return false;
+        }
+        count_--;
+        return true;
+    }
+
+    void release(std::size_t count = 1) {
+        ReadyList ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (count != 0 && ready.claimFront(waiters_)) {
+                count--;
+            }
+            count_ += count;
+        }
+        ready.resumeAll();
+    }
+
+    std::size_t available() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+private:
+    bool enqueue(CancellableWaiter& node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ != 0) {
+            count_--;
+            return false;
+        }
+        if (node.cancelIfStopped()) {
+            return false;
+        }
+        waiters_.pushBack(node);
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::size_t count_;
+    WaiterList waiters_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <concepts>
 #include <coroutine>
+#include <utility>
+
+#include "co_async/utils/non_void_helper.h"
 
 namespace pyc {
 namespace co_async {
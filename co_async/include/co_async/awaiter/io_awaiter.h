@@ -0,0 +1,83 @@
+#pragma once
+
+#include <coroutine>
+#include <stop_token>
+#include <utility>
+
+#include "co_async/io_loop.h"
+#include "co_async/timer_loop.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 等待文件描述符可读或可写, 可选超时
+/// await_resume 返回 true 表示就绪, false 表示超时. 协程帧被提前销毁时 awaiter 析构会注销等待和定时器
+/// 所在协程的 stop_token 被请求停止时提前在事件循环线程上恢复, 注销等待和定时器后抛出 OperationCancelled
+/// 在其他线程 (如 Scheduler 的工作线程) 上等待时由事件循环线程检查就绪标记并登记, 协程在事件循环线程上恢复
+struct IoAwaiter {
+    IoAwaiter(int fd, IoEvent event, TimerLoop::Clock::time_point deadline = TimerLoop::Clock::time_point::max())
+        : fd_(fd), event_(event), deadline_(deadline) {}
+
+    IoAwaiter(IoAwaiter&&) = delete;
+
+    ~IoAwaiter() {
+        if (waiting_) {
+            IoLoop::GetInstance().removeWaiter(*this);
+        }
+    }
+
+    /// @brief 就绪标记只能在事件循环线程上读取, 其他线程上总是挂起
+    bool await_ready() const {
+        return TimerLoop::GetInstance().inLoopThread() && IoLoop::GetInstance().consumeReady(fd_, event_);
+    }
+
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> coroutine) {
+        coroutine_ = coroutine;
+        stop_token_ = stopTokenOf(coroutine);
+        posted_.run_ = [](void* self) { static_cast<IoAwaiter*>(self)->start(); };
+        posted_.context_ = this;
+        TimerLoop::GetInstance().runInLoop(posted_);
+    }
+
+    /// @brief 在事件循环线程上登记 I/O 等待, 定时器和取消请求, 转交期间已就绪时直接恢复
+    void start() {
+        if (IoLoop::GetInstance().consumeReady(fd_, event_)) {
+            coroutine_.resume();
+            return;
+        }
+        IoLoop::GetInstance().addWaiter(*this);
+        if (deadline_ != TimerLoop::Clock::time_point::max()) {
+            timer_.coroutine_ = coroutine_;
+            TimerLoop::GetInstance().addTimer(deadline_, timer_);
+        }
+        cancel_.watch(coroutine_, std::move(stop_token_));
+    }
+
+    bool await_resume() {
+        const bool cancelled = cancel_.finish();
+        TimerLoop::GetInstance().cancelTimer(timer_);
+        if (waiting_) {
+            // 由定时器 (即超时) 或取消请求恢复
+            IoLoop::GetInstance().removeWaiter(*this);
+            if (cancelled) {
+                throw OperationCancelled();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    int fd_;
+    IoEvent event_;
+    TimerLoop::Clock::time_point deadline_;
+    std::coroutine_handle<> coroutine_{};
+    std::stop_token stop_token_{};
+    bool waiting_{false};  // 已登记到 IoLoop 且尚未被 I/O 事件恢复
+    TimerNode timer_;
+    TimerLoop::CancelRequest cancel_;
+    TimerLoop::Posted posted_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <coroutine>
+
+#include "co_async/scheduler.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 挂起当前协程并交给调度器, 之后在调度器的某个工作线程上恢复
+/// 调度后协程可能立即在其他线程恢复, 因此 await_suspend 在调度之后不能再访问 awaiter
+struct ScheduleAwaiter {
+    explicit ScheduleAwaiter(Scheduler& scheduler) : scheduler_(scheduler) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> coroutine) const { scheduler_.schedule(coroutine); }
+
+    constexpr void await_resume() const noexcept {}
+
+    Scheduler& scheduler_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -1,22 +1,51 @@
 #pragma once
 
 #include <coroutine>
+#include <stop_token>
+#include <utility>
 
 #include "co_async/timer_loop.h"
 
 namespace pyc {
 namespace co_async {
 
+/// @brief 定时器节点保存在 awaiter 中, 协程帧被提前销毁时 awaiter 析构会自动取消定时器
+/// 所在协程的 stop_token 被请求停止时提前在事件循环线程上恢复, 取消定时器后抛出 OperationCancelled
+/// 在其他线程 (如 Scheduler 的工作线程) 上等待时定时器由事件循环线程登记, 协程到期后在事件循环线程上恢复
 struct SleepAwaiter {
-    bool await_ready() const { return std::chrono::system_clock::now() >= expire_time_; }
+    explicit SleepAwaiter(TimerLoop::Clock::time_point expire_time) : expire_time_(expire_time) {}
 
-    void await_suspend(std::coroutine_handle<> coroutine) const {
-        TimerLoop::GetInstance().addTimer(expire_time_, coroutine);
+    SleepAwaiter(SleepAwaiter&&) = delete;
+
+    bool await_ready() const { return TimerLoop::Clock::now() >= expire_time_; }
+
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> coroutine) {
+        node_.coroutine_ = coroutine;
+        stop_token_ = stopTokenOf(coroutine);
+        posted_.run_ = [](void* self) { static_cast<SleepAwaiter*>(self)->start(); };
+        posted_.context_ = this;
+        TimerLoop::GetInstance().runInLoop(posted_);
     }
 
-    void await_resume() const noexcept {}
+    /// @brief 在事件循环线程上登记定时器和取消请求
+    void start() {
+        TimerLoop::GetInstance().addTimer(expire_time_, node_);
+        cancel_.watch(node_.coroutine_, std::move(stop_token_));
+    }
+
+    void await_resume() {
+        if (cancel_.finish()) {
+            TimerLoop::GetInstance().cancelTimer(node_);
+            throw OperationCancelled();
+        }
+    }
 
-    std::chrono::system_clock::time_point expire_time_;
+    TimerLoop::Clock::time_point expire_time_;
+    std::stop_token stop_token_{};
+    TimerNode node_;
+    TimerLoop::CancelRequest cancel_;
+    TimerLoop::Posted posted_;
 };
 
 }  // namespace co_async
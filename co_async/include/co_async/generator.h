@@ -0,0 +1,231 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "co_async/utils/frame_allocator.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 惰性同步生成器, 每次迭代恢复协程直到下一个 co_yield, 协程内不能 co_await
+/// co_yield 的值以指针形式保存, 临时对象在协程恢复前一直有效, 不需要复制
+template <typename T>
+class Generator {
+public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference = std::conditional_t<std::is_reference_v<T>, T, T&>;
+    using pointer = std::add_pointer_t<reference>;
+
+    struct promise_type : PooledFrame {
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(std::remove_reference_t<reference>& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        std::suspend_always yield_value(std::remove_reference_t<reference>&& value) noexcept {
+            value_ = std::addressof(value);
+            return {};
+        }
+
+        void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+        void return_void() noexcept {}
+
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+        void rethrowIfException() {
+            if (exception_) [[unlikely]] {
+                std::rethrow_exception(std::exchange(exception_, nullptr));
+            }
+        }
+
+        pointer value_{nullptr};
+        std::exception_ptr exception_{};
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Generator::value_type;
+        using reference = Generator::reference;
+        using pointer = Generator::pointer;
+
+        Iterator() = default;
+
+        explicit Iterator(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine) {}
+
+        Iterator& operator++() {
+            coroutine_.resume();
+            coroutine_.promise().rethrowIfException();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        reference operator*() const { return static_cast<reference>(*coroutine_.promise().value_); }
+
+        pointer operator->() const { return coroutine_.promise().value_; }
+
+        bool operator==(std::default_sentinel_t) const { return !coroutine_ || coroutine_.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> coroutine_{};
+    };
+
+    explicit Generator(std::coroutine_handle<promise_type> coroutine) noexcept : coroutine_(coroutine) {}
+
+    Generator(Generator&& other) noexcept : coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            coroutine_ = std::exchange(other.coroutine_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Generator() { destroy(); }
+
+    /// @brief 开始执行直到第一个 co_yield, 只能调用一次
+    Iterator begin() {
+        Iterator iterator(coroutine_);
+        return ++iterator;
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    void destroy() {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> coroutine_;
+};
+
+/// @brief 异步生成器, 协程内可以 co_await 其他任务, 消费方通过 co_await next() 逐个获取值
+/// 消费方与生成器之间通过对称转移切换, 不经过事件循环
+template <typename T>
+class AsyncGenerator {
+public:
+    using value_type = std::remove_cvref_t<T>;
+
+    struct promise_type : PooledFrame {
+        /// @brief co_yield 和结束时都切换回等待 next() 的消费方
+        struct YieldAwaiter {
+            constexpr bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) const noexcept {
+                return coroutine.promise().consumer_;
+            }
+
+            constexpr void await_resume() const noexcept {}
+        };
+
+        AsyncGenerator get_return_object() noexcept {
+            return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        YieldAwaiter final_suspend() const noexcept { return {}; }
+
+        YieldAwaiter yield_value(std::remove_reference_t<T>& value) noexcept {
+            value_ = std::addressof(value);
+            movable_ = false;
+            return {};
+        }
+
+        YieldAwaiter yield_value(std::remove_reference_t<T>&& value) noexcept {
+            value_ = std::addressof(value);
+            movable_ = true;
+            return {};
+        }
+
+        void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+        void return_void() noexcept {}
+
+        std::coroutine_handle<> consumer_{};
+        std::remove_reference_t<T>* value_{nullptr};
+        bool movable_{false};  // co_yield 的是右值, 可以移动给消费方, 左值则复制, 避免修改生成器中的变量
+        std::exception_ptr exception_{};
+    };
+
+    struct NextAwaiter {
+        bool await_ready() const noexcept { return !coroutine_ || coroutine_.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) const noexcept {
+            coroutine_.promise().consumer_ = consumer;
+            return coroutine_;
+        }
+
+        /// @brief 生成器结束时返回 std::nullopt, 生成器抛出的异常在这里重新抛出
+        std::optional<value_type> await_resume() const {
+            if (!coroutine_) {
+                return std::nullopt;
+            }
+            auto& promise = coroutine_.promise();
+            if (promise.exception_) [[unlikely]] {
+                std::rethrow_exception(std::exchange(promise.exception_, nullptr));
+            }
+            if (coroutine_.done()) {
+                return std::nullopt;
+            }
+            if (promise.movable_) {
+                return std::optional<value_type>(std::move(*promise.value_));
+            }
+            return std::optional<value_type>(*promise.value_);
+        }
+
+        std::coroutine_handle<promise_type> coroutine_;
+    };
+
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> coroutine) noexcept : coroutine_(coroutine) {}
+
+    AsyncGenerator(AsyncGenerator&& other) noexcept : coroutine_(std::exchange(other.coroutine_, nullptr)) {}
+
+    AsyncGenerator& operator=(AsyncGenerator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            coroutine_ = std::exchange(other.coroutine_, nullptr);
+        }
+        return *this;
+    }
+
+    ~AsyncGenerator() { destroy(); }
+
+    /// @brief 恢复生成器直到下一个 co_yield 或结束
+    NextAwaiter next() const noexcept { return NextAwaiter(coroutine_); }
+
+private:
+    void destroy() {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> coroutine_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <system_error>
+
+#include "co_async/awaiter/io_awaiter.h"
+#include "co_async/task.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 不超时
+inline constexpr auto kNoTimeout = std::chrono::steady_clock::duration::max();
+
+namespace detail {
+
+inline TimerLoop::Clock::time_point deadlineOf(std::chrono::steady_clock::duration timeout) {
+    return timeout == kNoTimeout ? TimerLoop::Clock::time_point::max() : TimerLoop::Clock::now() + timeout;
+}
+
+[[noreturn]] inline void throwErrno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] inline void throwTimeout(const char* what) {
+    throw std::system_error(ETIMEDOUT, std::generic_category(), what);
+}
+
+}  // namespace detail
+
+// 以下函数要求 fd 是非阻塞的, 先直接尝试系统调用, 返回 EAGAIN 时才挂起等待 IoLoop 通知
+// 出错或超时抛出 std::system_error, 超时的错误码为 ETIMEDOUT
+
+/// @brief 接受一个连接, 返回非阻塞的连接 fd
+inline Task<int> async_accept(int listen_fd, std::chrono::steady_clock::duration timeout = kNoTimeout) {
+    const auto deadline = detail::deadlineOf(timeout);
+    for (;;) {
+        const int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) {
+            co_return fd;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            detail::throwErrno("accept");
+        }
+        if (errno != EINTR && !co_await IoAwaiter(listen_fd, IoEvent::kRead, deadline)) {
+            detail::throwTimeout("accept");
+        }
+    }
+}
+
+/// @brief 读取最多 buffer.size() 字节, 返回读取的字节数, 返回 0 表示对端关闭
+inline Task<std::size_t> async_read(int fd, std::span<char> buffer,
+                                    std::chrono::steady_clock::duration timeout = kNoTimeout) {
+    const auto deadline = detail::deadlineOf(timeout);
+    for (;;) {
+        const ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        if (n >= 0) {
+            co_return static_cast<std::size_t>(n);
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            detail::throwErrno("read");
+        }
+        if (errno != EINTR && !co_await IoAwaiter(fd, IoEvent::kRead, deadline)) {
+            detail::throwTimeout("read");
+        }
+    }
+}
+
+/// @brief 写入 buffer 的全部内容, 超时作用于整个写入过程
+inline Task<void> async_write(int fd, std::span<const char> buffer,
+                              std::chrono::steady_clock::duration timeout = kNoTimeout) {
+    const auto deadline = detail::deadlineOf(timeout);
+    while (!buffer.empty()) {
+        const ssize_t n = ::write(fd, buffer.data(), buffer.size());
+        if (n >= 0) {
+            buffer = buffer.subspan(static_cast<std::size_t>(n));
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            detail::throwErrno("write");
+        }
+        if (errno != EINTR && !co_await IoAwaiter(fd, IoEvent::kWrite, deadline)) {
+            detail::throwTimeout("write");
+        }
+    }
+}
+
+/// @brief 在非阻塞 socket 上发起连接并等待完成
+inline Task<void> async_connect(int fd, const sockaddr* address, socklen_t length,
+                                std::chrono::steady_clock::duration timeout = kNoTimeout) {
+    if (::connect(fd, address, length) == 0) {
+        co_return;
+    }
+    if (errno != EINPROGRESS) {
+        detail::throwErrno("connect");
+    }
+    if (!co_await IoAwaiter(fd, IoEvent::kWrite, detail::deadlineOf(timeout))) {
+        detail::throwTimeout("connect");
+    }
+    int error = 0;
+    socklen_t error_length = sizeof(error);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_length) < 0) {
+        detail::throwErrno("getsockopt");
+    }
+    if (error != 0) {
+        throw std::system_error(error, std::generic_category(), "connect");
+    }
+}
+
+/// @brief 从 IoLoop 中注销并关闭 fd
+inline void close_fd(int fd) {
+    IoLoop::GetInstance().unregister(fd);
+    ::close(fd);
+}
+
+}  // namespace co_async
+}  // namespace pyc
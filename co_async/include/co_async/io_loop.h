@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "common/singleton.h"
+
+namespace pyc {
+namespace co_async {
+
+enum class IoEvent : std::uint8_t {
+    kRead = 0,
+    kWrite = 1,
+};
+
+struct IoAwaiter;
+
+/// @brief 基于 epoll 的 I/O 事件循环, 同时驱动 TimerLoop 中的定时器
+/// - 文件描述符在第一次等待时以边沿触发方式注册读写事件, 之后不再修改, 每次等待不需要 epoll_ctl
+/// - 每个文件描述符同一时刻最多一个协程等待读, 一个协程等待写
+/// - 没有等待者时收到的事件记录为就绪标记, 下一次等待直接返回, 避免边沿触发丢失事件
+/// 文件描述符必须是非阻塞的, 关闭前需调用 unregister (或使用 close_fd)
+/// 其他线程取消等待时通过 eventfd 唤醒 epoll_wait
+class IoLoop : public Singleton<IoLoop> {
+    friend class Singleton<IoLoop>;
+
+public:
+    /// @brief 运行直到没有 I/O 等待者也没有定时器
+    void runAll();
+
+    /// @brief 处理一轮事件: 恢复到期的定时器, 最多等待到下一个定时器到期, 恢复就绪的 I/O 等待者
+    void runOnce();
+
+    /// @brief 从 epoll 中移除文件描述符, 必须没有协程正在等待它
+    void unregister(int fd);
+
+    std::size_t waiterCount() const { return waiter_count_; }
+
+    // 以下接口供 IoAwaiter 使用
+    bool consumeReady(int fd, IoEvent event);
+    void addWaiter(IoAwaiter& awaiter);
+    void removeWaiter(IoAwaiter& awaiter);
+
+private:
+    struct FdState {
+        int fd_;
+        IoAwaiter* waiters_[2]{};
+        bool ready_[2]{};
+    };
+
+    IoLoop();
+    ~IoLoop();
+
+    FdState& registerFd(int fd);
+
+    /// @brief 唤醒阻塞在 epoll_wait 中的事件循环, 可在任意线程调用
+    static void wake();
+
+    void dispatch(int fd, IoEvent event);
+
+private:
+    int epoll_fd_;
+    int wake_fd_;
+    std::size_t waiter_count_{0};
+    std::unordered_map<int, std::unique_ptr<FdState>> fds_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
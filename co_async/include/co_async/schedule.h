@@ -0,0 +1,86 @@
+#pragma once
+
+#include <exception>
+#include <latch>
+#include <type_traits>
+#include <utility>
+
+#include "co_async/awaiter/concepts.h"
+#include "co_async/awaiter/schedule_awaiter.h"
+#include "co_async/scheduler.h"
+#include "co_async/task.h"
+#include "co_async/utils/uninitialized.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 切换到调度器的工作线程上继续执行
+/// 配合 when_all 使用时, 每个子任务先 co_await schedule_on 即可分散到所有工作线程并行执行
+inline ScheduleAwaiter schedule_on(Scheduler& scheduler) { return ScheduleAwaiter(scheduler); }
+
+/// @brief 不被任何人等待的协程, 立即开始执行, 结束时自动销毁协程帧
+struct DetachedTask {
+    struct promise_type : PooledFrame {
+        DetachedTask get_return_object() noexcept { return {}; }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        /// @brief 没有等待方可以接收异常, 与 std::thread 一致直接终止
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        void return_void() noexcept {}
+    };
+};
+
+template <typename F>
+DetachedTask spawnHelper(Scheduler& scheduler, F factory) {
+    co_await schedule_on(scheduler);
+    co_await factory();
+}
+
+/// @brief 在调度器上运行 factory() 返回的任务, 不等待其完成
+/// factory 被复制到新协程帧中, 在任务结束前一直有效, 因此带捕获的 lambda 协程也是安全的. 任务不应抛出异常
+template <typename F>
+    requires Awaitable<std::invoke_result_t<std::decay_t<F>&>>
+void spawn(Scheduler& scheduler, F&& factory) {
+    spawnHelper(scheduler, std::decay_t<F>(std::forward<F>(factory)));
+}
+
+template <typename T, typename A>
+DetachedTask syncWaitHelper(Scheduler& scheduler, A& awaitable, Uninitialized<T>& result,
+                            std::exception_ptr& exception, std::latch& done) {
+    co_await schedule_on(scheduler);
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await awaitable;
+        } else {
+            result.putValue(co_await awaitable);
+        }
+    } catch (...) {
+        exception = std::current_exception();
+    }
+    // 计数归零后等待方会销毁 result 等对象, 之后不能再访问它们
+    done.count_down();
+}
+
+/// @brief 在调度器上运行 awaitable 并阻塞当前线程直到完成, 返回结果或重新抛出异常, 不能在工作线程中调用
+template <Awaitable A>
+auto sync_wait(Scheduler& scheduler, A&& awaitable) -> typename AwaitableTraits<std::remove_cvref_t<A>>::RetType {
+    using RetType = typename AwaitableTraits<std::remove_cvref_t<A>>::RetType;
+    Uninitialized<RetType> result;
+    std::exception_ptr exception;
+    std::latch done(1);
+    syncWaitHelper<RetType>(scheduler, awaitable, result, exception, done);
+    done.wait();
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    if constexpr (!std::is_void_v<RetType>) {
+        return result.moveValue();
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
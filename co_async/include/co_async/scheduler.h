@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 多线程协程调度器, 每个工作线程一条运行队列, 空闲时从其他线程的队列窃取
+/// - 工作线程内调度的协程放入本线程队列尾部, 其他线程调度的协程轮流放入各工作线程的队列
+/// - 工作线程从自己队列头部取协程, 窃取时从其他队列尾部取走一半, 减少窃取次数
+/// - 没有协程可运行时工作线程休眠, 调度时按需唤醒
+/// 调度器上的协程可以等待定时器和 I/O: 登记由 TimerLoop::runInLoop 转交给事件循环线程, 协程之后在事件循环线程上
+/// 恢复, 需要继续在调度器上运行时再 co_await schedule_on
+class Scheduler : public Noncopyable {
+public:
+    explicit Scheduler(std::size_t thread_num = std::thread::hardware_concurrency());
+
+    ~Scheduler();
+
+    /// @brief 在工作线程上恢复 coroutine, 可以在任意线程调用
+    void schedule(std::coroutine_handle<> coroutine);
+
+    /// @brief 运行完已排队的协程后回收所有工作线程, 之后调度的协程不会再运行. 可重复调用, 不能在工作线程中调用
+    void shutdown();
+
+    /// @brief 当前线程是否为本调度器的工作线程
+    bool inWorkerThread() const;
+
+    std::size_t threadCount() const { return workers_.size(); }
+
+private:
+    struct alignas(64) Worker {
+        std::mutex mutex_;
+        std::deque<std::coroutine_handle<>> queue_;
+        std::atomic<std::size_t> size_{0};  // 供无锁判断是否为空
+        std::thread thread_;
+    };
+
+    void push(Worker& worker, std::coroutine_handle<> coroutine);
+
+    /// @brief 先从第 index 个工作线程自己的队列取, 取不到再从其他队列窃取, 都没有时返回空句柄
+    std::coroutine_handle<> pop(std::size_t index);
+
+    std::coroutine_handle<> steal(std::size_t index);
+
+    bool hasWork() const;
+
+    void workerThread(std::size_t index);
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::size_t> next_worker_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<std::size_t> idle_{0};  // 正在休眠或准备休眠的工作线程数
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -8,20 +8,25 @@
 namespace pyc {
 namespace co_async {
 
+/// @brief 睡眠任务, 未完成时被销毁会通过 SleepAwaiter 自动取消定时器
 template <typename T>
 struct TimerTask : public Task<T> {
     using Task<T>::Task;
-
-    ~TimerTask() { TimerLoop::GetInstance().deleteTask(this->coroutine_); }
 };
 
-inline TimerTask<void> sleep_until(std::chrono::system_clock::time_point expire_time) {
+inline TimerTask<void> sleep_until(std::chrono::steady_clock::time_point expire_time) {
     co_await SleepAwaiter(expire_time);
     co_return;
 }
 
-inline TimerTask<void> sleep_for(std::chrono::system_clock::duration duration) {
-    co_await SleepAwaiter(std::chrono::system_clock::now() + duration);
+/// @brief 系统时间会被调整, 转换为单调时钟的时间点后再等待
+inline TimerTask<void> sleep_until(std::chrono::system_clock::time_point expire_time) {
+    co_await SleepAwaiter(std::chrono::steady_clock::now() + (expire_time - std::chrono::system_clock::now()));
+    co_return;
+}
+
+inline TimerTask<void> sleep_for(std::chrono::steady_clock::duration duration) {
+    co_await SleepAwaiter(std::chrono::steady_clock::now() + duration);
     co_return;
 }
 
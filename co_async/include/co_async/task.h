@@ -2,8 +2,11 @@
 
 #include <coroutine>
 #include <exception>
+#include <stop_token>
 
 #include "co_async/awaiter/previous_awaiter.h"
+#include "co_async/utils/cancellation.h"
+#include "co_async/utils/frame_allocator.h"
 #include "co_async/utils/uninitialized.h"
 
 #ifdef CO_ASYNC_DEBUG
@@ -14,7 +17,7 @@ namespace pyc {
 namespace co_async {
 
 template <typename T>
-struct Promise {
+struct Promise : PooledFrame {
     Promise() noexcept {};
     Promise(Promise&&) = delete;
     ~Promise() noexcept {};
@@ -55,12 +58,13 @@ struct Promise {
     }
 
     std::coroutine_handle<> previous_{};
+    std::stop_token stop_token_{};
     std::exception_ptr exception_{};
     Uninitialized<T> result_;
 };
 
 template <>
-struct Promise<void> {
+struct Promise<void> : PooledFrame {
     Promise() noexcept = default;
     Promise(Promise&&) = delete;
     ~Promise() noexcept = default;
@@ -87,6 +91,7 @@ struct Promise<void> {
     }
 
     std::coroutine_handle<> previous_ = nullptr;
+    std::stop_token stop_token_{};
     std::exception_ptr result_ = nullptr;
 };
 
@@ -103,8 +108,11 @@ struct Task {
     struct Awaiter {
         constexpr bool await_ready() const noexcept { return false; }
 
-        std::coroutine_handle<> await_suspend(std::coroutine_handle<> coroutine) const noexcept {
+        /// @brief 子任务继承等待方的 stop_token, 取消可以沿 co_await 链传递到最内层的 awaiter
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> coroutine) const noexcept {
             coroutine_.promise().previous_ = coroutine;
+            coroutine_.promise().stop_token_ = stopTokenOf(coroutine);
             return coroutine_;
         }
 
@@ -120,18 +128,47 @@ struct Task {
     std::coroutine_handle<promise_type> coroutine_;
 };
 
-struct ReturnPreviousPromise {
+/// @brief 在协程到达最终挂起点并完全挂起后调用, 返回需要恢复的协程, 为空时不恢复
+/// 子任务在多个线程上汇合时必须在此时计数: 计数之后父协程可能立即在其他线程恢复并销毁子任务的协程帧,
+/// 若在协程体内计数, 之后到挂起前对协程帧的写入就会与销毁竞争
+struct ArriveCallback {
+    std::coroutine_handle<> (*arrive_)(void* context) = nullptr;
+    void* context_ = nullptr;
+};
+
+struct ReturnPreviousPromise : PooledFrame {
+    struct FinalAwaiter {
+        constexpr bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<ReturnPreviousPromise> coroutine) noexcept {
+            const auto& promise = coroutine.promise();
+            const auto& callback = promise.callback_;
+            std::coroutine_handle<> previous =
+                callback.arrive_ ? callback.arrive_(callback.context_) : promise.previous_;
+            if (previous) {
+                return previous;
+            }
+            return std::noop_coroutine();
+        }
+
+        constexpr void await_resume() const noexcept {}
+    };
+
     auto initial_suspend() noexcept { return std::suspend_always(); }
 
-    auto final_suspend() noexcept { return PreviousAwaiter(previous_); }
+    auto final_suspend() noexcept { return FinalAwaiter(); }
 
     void unhandled_exception() { throw; }
 
     void return_value(std::coroutine_handle<> coroutine) noexcept { previous_ = coroutine; }
 
+    void return_value(ArriveCallback callback) noexcept { callback_ = callback; }
+
     auto get_return_object() { return std::coroutine_handle<ReturnPreviousPromise>::from_promise(*this); }
 
     std::coroutine_handle<> previous_{};
+    ArriveCallback callback_{};
+    std::stop_token stop_token_{};  // 由 when_all / when_any 在启动前设置
 
     ReturnPreviousPromise& operator=(ReturnPreviousPromise&&) = delete;
 };
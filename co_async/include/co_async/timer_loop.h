@@ -1,42 +1,144 @@
+#pragma once
+
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <coroutine>
-#include <map>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
 
+#include "co_async/utils/cancellation.h"
+#include "co_async/utils/timing_wheel.h"
+#include "co_async/utils/waiter_list.h"
 #include "common/singleton.h"
 
-// 检查GCC版本是否小于 13
-#if defined(__GNUC__) && (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__ < 130000)
-namespace std {
-template <>
-struct hash<std::coroutine_handle<>> {
-    size_t operator()(const std::coroutine_handle<>& handle) const noexcept {
-        return hash<void*>{}(handle.address());
-    }
-};
-}  // namespace std
-#endif
-
 namespace pyc {
 namespace co_async {
 
+/// @brief 基于分层时间轮的定时器循环, 使用单调时钟 steady_clock, 精度为 kTick
+/// 定时器节点由调用者持有 (通常位于协程帧内的 awaiter 中), 添加和取消都是 O(1) 且不分配内存,
+/// 相同到期时间的多个定时器互不覆盖
+/// 定时器和 I/O 等待只能在事件循环线程上登记, 其他线程 (如 Scheduler 的工作线程) 上的 awaiter 通过 runInLoop
+/// 把登记转交给事件循环线程, 协程之后在事件循环线程上恢复. 除 runInLoop, postCancel 和 withdrawCancel 外的接口
+/// 都只能在事件循环线程上调用
 class TimerLoop : public Singleton<TimerLoop> {
     friend class Singleton<TimerLoop>;
 
 public:
-    void addTimer(std::chrono::system_clock::time_point expire_time, std::coroutine_handle<> task);
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto kTick = std::chrono::milliseconds(1);
+
+    /// @brief 挂起在事件循环上的等待的取消请求, 由 awaiter 持有
+    /// 所在协程的 stop_token 被请求停止时 (可能在其他线程) 登记到 TimerLoop 并唤醒事件循环,
+    /// 事件循环线程在下一轮以 cancelled_ 恢复协程, awaiter 再在事件循环线程上注销自己的定时器和 I/O 等待
+    struct CancelRequest : WaiterNode {
+        CancelRequest() = default;
+        CancelRequest(CancelRequest&&) = delete;
+
+        ~CancelRequest() { finish(); }
+
+        /// @brief 在事件循环线程上登记等待后调用, stop_token 通常由 stopTokenOf 取得
+        void watch(std::coroutine_handle<> coroutine, std::stop_token stop_token) {
+            coroutine_ = coroutine;
+            if (stop_token.stop_possible()) {
+                stop_callback_.emplace(std::move(stop_token), Post{this});
+            }
+        }
 
-    void deleteTask(std::coroutine_handle<> task);
+        /// @brief 在 await_resume 中调用, 注销回调并撤回未处理的请求, 返回协程是否因取消而恢复
+        bool finish() {
+            if (stop_callback_) {
+                stop_callback_.reset();
+                TimerLoop::GetInstance().withdrawCancel(*this);
+            }
+            return cancelled_;
+        }
+
+        struct Post {
+            void operator()() const noexcept { TimerLoop::GetInstance().postCancel(*request_); }
+
+            CancelRequest* request_;
+        };
+
+        std::optional<std::stop_callback<Post>> stop_callback_{};
+        bool cancelled_{false};  // 由事件循环线程在恢复协程前设置
+    };
+
+    /// @brief 从其他线程转交到事件循环线程执行的操作, 由 awaiter 持有, 执行前不能销毁
+    struct Posted : WaiterNode {
+        void (*run_)(void* context) = nullptr;
+        void* context_ = nullptr;
+    };
+
+    /// @brief 在事件循环线程上执行 posted.run_(posted.context_), 可在任意线程调用
+    /// 当前线程是事件循环线程时直接执行, 否则登记后唤醒事件循环, 由下一轮 runExpired 执行.
+    /// 转交之后协程可能随时在事件循环线程上恢复, 调用者不能再访问 awaiter
+    void runInLoop(Posted& posted);
+
+    /// @brief 当前线程是否为事件循环线程: 最近一次运行 runExpired 的线程, 尚未运行过时为创建者
+    bool inLoopThread() const {
+        return loop_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
 
+    /// @brief 在 expire_time 恢复 node.coroutine_, 到期时间向上取整到 tick, 不会提前恢复
+    void addTimer(Clock::time_point expire_time, TimerNode& node);
+
+    void cancelTimer(TimerNode& node);
+
+    /// @brief 运行直到没有定时器和待执行的转交操作
     void runAll();
 
+    /// @brief 执行转交的操作, 恢复被取消的等待和所有已到期的定时器, 返回执行和恢复的数量
+    /// 供其他事件循环 (如 IoLoop) 驱动定时器
+    std::size_t runExpired();
+
+    /// @brief 下一次需要检查定时器的时间, 没有定时器时返回 Clock::time_point::max()
+    Clock::time_point nextWakeTime() const;
+
+    std::size_t timerCount() const { return wheel_.size(); }
+
+    /// @brief 没有定时器也没有待执行的转交操作
+    bool empty() const { return wheel_.empty() && posted_count_.load(std::memory_order_acquire) == 0; }
+
+    /// @brief 登记取消请求并唤醒事件循环, 可在任意线程调用
+    void postCancel(CancelRequest& request);
+
+    /// @brief 撤回尚未处理的取消请求
+    void withdrawCancel(CancelRequest& request);
+
+    /// @brief 设置唤醒事件循环的函数, 供在其他事件循环 (如 IoLoop) 中驱动定时器时使用, 可以为空
+    void setWaker(void (*waker)());
+
 private:
-    TimerLoop() = default;
+    TimerLoop() : start_time_(Clock::now()), loop_thread_(std::this_thread::get_id()) {}
+
+    std::uint64_t toTick(Clock::time_point time_point, bool round_up) const;
+
+    /// @brief 逐个执行其他线程转交的操作, 返回执行的数量
+    std::size_t runPosted();
+
+    /// @brief 逐个恢复被取消的协程, 返回恢复的数量
+    std::size_t runCancelled();
+
+    /// @brief 唤醒 runAll 或设置了 waker 的事件循环, waker 在 cancel_mutex_ 内取得
+    void wake(void (*waker)());
 
 private:
-    using TimerMap = std::map<std::chrono::system_clock::time_point, std::coroutine_handle<>>;
-    TimerMap timer_map_;
-    std::unordered_map<std::coroutine_handle<>, TimerMap::iterator> search_table_;
+    const Clock::time_point start_time_;
+    TimingWheel wheel_;
+    std::atomic<std::thread::id> loop_thread_;
+
+    std::mutex cancel_mutex_;  // 保护以下成员, 其他线程登记取消请求和转交操作时使用
+    std::condition_variable cancel_cv_;
+    WaiterList cancel_requests_;  // 节点为 CancelRequest
+    WaiterList posted_;           // 节点为 Posted
+    std::atomic<std::size_t> posted_count_{0};  // 已登记但尚未执行完的转交操作, 供 empty 无锁判断
+    void (*waker_)() = nullptr;
 };
 
 }  // namespace co_async
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <stop_token>
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 等待被取消 (如 when_any 中未胜出的分支) 时由 awaiter 的 await_resume 抛出
+class OperationCancelled : public std::exception {
+public:
+    const char* what() const noexcept override { return "operation cancelled"; }
+};
+
+/// @brief 协程的 stop_token, 由 Task 在被 co_await 时从等待方继承, promise 没有 stop_token_ 时返回空的 token
+template <typename P>
+std::stop_token stopTokenOf(std::coroutine_handle<P> coroutine) noexcept {
+    if constexpr (requires { coroutine.promise().stop_token_; }) {
+        return coroutine.promise().stop_token_;
+    } else {
+        return {};
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 协程帧分配统计, 每个线程独立计数
+struct FrameAllocStats {
+    std::uint64_t allocations_{0};
+    std::uint64_t deallocations_{0};
+    std::uint64_t pool_hits_{0};    // 从空闲链表复用
+    std::uint64_t pool_misses_{0};  // 空闲链表为空, 向全局 operator new 申请
+    std::uint64_t oversized_{0};    // 超过 FramePool::kMaxPooledSize, 直接使用全局 operator new
+    std::uint64_t custom_{0};       // 使用 std::allocator_arg 传入的分配器
+};
+
+/// @brief 线程局部的协程帧内存池, 按 kGranularity 字节划分尺寸类别, 每个类别一条空闲链表
+/// - 分配和释放都不加锁; 在其他线程释放的内存块进入释放线程的空闲链表, 每个块都是独立申请的, 可以跨线程复用
+/// - 每个类别最多缓存 kMaxCachedPerClass 个块, 超出的直接归还全局 operator delete
+/// - 线程退出时归还所有缓存的块, 之后在该线程上释放的协程帧直接使用全局 operator delete
+class FramePool : public Noncopyable {
+public:
+    static constexpr std::size_t kGranularity = 64;
+    static constexpr std::size_t kMaxPooledSize = 4096;
+    static constexpr std::size_t kClassCount = kMaxPooledSize / kGranularity;
+    static constexpr std::size_t kMaxCachedPerClass = 256;
+
+    ~FramePool();
+
+    /// @brief 当前线程的内存池, 线程退出过程中内存池已销毁时返回 nullptr
+    static FramePool* local();
+
+    void* allocate(std::size_t size);
+
+    void deallocate(void* block, std::size_t size) noexcept;
+
+    /// @brief 归还所有缓存的块
+    void trim() noexcept;
+
+    const FrameAllocStats& stats() const { return stats_; }
+
+    FrameAllocStats& stats() { return stats_; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next_;
+    };
+
+    FramePool() = default;
+
+    static std::size_t classOf(std::size_t size) { return (size - 1) / kGranularity; }
+
+public:
+    /// @brief 实际申请的块大小, 可缓存的块按类别上限申请, 保证同一类别的块可以互相复用
+    static std::size_t blockSize(std::size_t size) {
+        return size > kMaxPooledSize ? size : (classOf(size) + 1) * kGranularity;
+    }
+
+private:
+    FreeBlock* free_lists_[kClassCount]{};
+    std::size_t cached_[kClassCount]{};
+    FrameAllocStats stats_;
+};
+
+/// @brief 当前线程的协程帧分配统计, 内存池已销毁时返回全零
+FrameAllocStats frameAllocStats();
+
+namespace detail {
+
+/// @brief 位于每个协程帧之前, 记录释放方式
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader {
+    /// @brief 为空表示由 FramePool 分配, 否则由传入的分配器分配
+    void (*deallocate_)(FrameHeader* header, std::size_t frame_size) noexcept;
+};
+
+inline constexpr std::size_t kFrameAlign = alignof(FrameHeader);
+inline constexpr std::size_t kHeaderSize = sizeof(FrameHeader);
+
+constexpr std::size_t alignFrameSize(std::size_t size) { return (size + kFrameAlign - 1) & ~(kFrameAlign - 1); }
+
+void* allocatePooledFrame(std::size_t size);
+
+void deallocateFrame(void* frame, std::size_t size) noexcept;
+
+void countCustomAllocation() noexcept;
+
+/// @brief 按帧对齐的分配单元, 传入的分配器重新绑定到这个类型
+struct alignas(kFrameAlign) FrameUnit {
+    std::byte data_[kFrameAlign];
+};
+
+/// @brief 内存布局: [FrameHeader][协程帧][分配器副本], 分配器副本在释放时取出用于归还内存
+template <typename Alloc>
+struct CustomFrame {
+    using UnitAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<FrameUnit>;
+    static_assert(alignof(UnitAlloc) <= kFrameAlign, "allocator alignment is too large");
+
+    static std::size_t unitCount(std::size_t size) {
+        return (kHeaderSize + alignFrameSize(size) + alignFrameSize(sizeof(UnitAlloc))) / kFrameAlign;
+    }
+
+    static UnitAlloc* storedAllocator(FrameHeader* header, std::size_t size) {
+        auto* storage = reinterpret_cast<std::byte*>(header) + kHeaderSize + alignFrameSize(size);
+        return std::launder(reinterpret_cast<UnitAlloc*>(storage));
+    }
+
+    static void* allocate(std::size_t size, const Alloc& alloc) {
+        UnitAlloc unit_alloc(alloc);
+        FrameUnit* units = std::allocator_traits<UnitAlloc>::allocate(unit_alloc, unitCount(size));
+        auto* header = ::new (units) FrameHeader{&deallocate};
+        auto* storage = reinterpret_cast<std::byte*>(header) + kHeaderSize + alignFrameSize(size);
+        ::new (storage) UnitAlloc(std::move(unit_alloc));
+        countCustomAllocation();
+        return header + 1;
+    }
+
+    static void deallocate(FrameHeader* header, std::size_t size) noexcept {
+        UnitAlloc* stored = storedAllocator(header, size);
+        UnitAlloc unit_alloc(std::move(*stored));
+        stored->~UnitAlloc();
+        std::allocator_traits<UnitAlloc>::deallocate(unit_alloc, reinterpret_cast<FrameUnit*>(header),
+                                                     unitCount(size));
+    }
+};
+
+}  // namespace detail
+
+/// @brief 协程 promise 的基类, 使协程帧从 FramePool 分配
+/// 协程的第一个参数 (成员函数为对象之后的第一个参数) 为 std::allocator_arg 时, 改用紧随其后的分配器分配
+struct PooledFrame {
+    static void* operator new(std::size_t size) { return detail::allocatePooledFrame(size); }
+
+    template <typename Alloc, typename... Args>
+    static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+        return detail::CustomFrame<Alloc>::allocate(size, alloc);
+    }
+
+    template <typename This, typename Alloc, typename... Args>
+    static void* operator new(std::size_t size, const This&, std::allocator_arg_t, const Alloc& alloc,
+                              const Args&...) {
+        return detail::CustomFrame<Alloc>::allocate(size, alloc);
+    }
+
+    static void operator delete(void* frame, std::size_t size) noexcept { detail::deallocateFrame(frame, size); }
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+namespace pyc {
+namespace co_async {
+
+class TimingWheel;
+
+/// @brief 侵入式定时器节点, 由等待方 (通常是协程帧中的 awaiter) 持有, 插入和取消都不需要分配内存
+/// 节点析构时自动从所在的时间轮中取消
+struct TimerNode {
+    TimerNode() = default;
+    TimerNode(const TimerNode&) = delete;
+    TimerNode& operator=(const TimerNode&) = delete;
+
+    ~TimerNode();
+
+    bool linked() const noexcept { return next_ != nullptr; }
+
+    void unlink() noexcept {
+        if (next_) {
+            prev_->next_ = next_;
+            next_->prev_ = prev_;
+            prev_ = next_ = nullptr;
+        }
+    }
+
+    TimerNode* prev_{nullptr};
+    TimerNode* next_{nullptr};
+    TimingWheel* wheel_{nullptr};
+    std::uint64_t expire_tick_{0};
+    std::coroutine_handle<> coroutine_{};
+};
+
+/// @brief 分层时间轮, 以 tick 为单位, 共 kLevels 层, 每层 kSlots 个槽位
+/// - 第 L 层的一个槽位覆盖 kSlots^L 个 tick, 定时器按剩余时间放入对应层, 到达该槽位时再降级到下一层
+/// - 插入和取消都是 O(1) 的链表操作, 同一 tick 到期的定时器互不影响
+/// - 每层用位图记录非空槽位, 推进时直接跳到下一个非空槽位, 长时间空闲后推进不需要逐 tick 遍历
+/// 超过最高层范围 (kSlots^kLevels 个 tick) 的定时器先放在最高层, 降级时按真实到期时间重新插入
+class TimingWheel {
+public:
+    static constexpr int kLevelBits = 8;
+    static constexpr int kLevels = 4;
+    static constexpr std::uint64_t kSlots = 1 << kLevelBits;
+
+    TimingWheel();
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+    ~TimingWheel();
+
+    /// @brief 插入定时器, 到期时间为 node.expire_tick_, 已到期的定时器直接进入到期列表
+    void add(TimerNode& node);
+
+    /// @brief 取消定时器, 未插入或已取出的定时器不受影响
+    void cancel(TimerNode& node);
+
+    /// @brief 推进到 now_tick, 期间到期的定时器按到期顺序进入到期列表
+    void advance(std::uint64_t now_tick);
+
+    /// @brief 取出一个到期的定时器, 没有时返回 nullptr
+    TimerNode* popExpired();
+
+    /// @brief 下一次需要推进的 tick, 可能是到期或降级, 没有定时器时返回 UINT64_MAX
+    std::uint64_t nextTick() const;
+
+    std::uint64_t currentTick() const { return current_tick_; }
+
+    /// @brief 尚未取出的定时器数量 (包括到期列表中的)
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Level {
+        std::array<TimerNode, kSlots> slots_;
+        std::array<std::uint64_t, kSlots / 64> bitmap_{};
+    };
+
+    static void initList(TimerNode& head);
+    static void pushBack(TimerNode& head, TimerNode& node);
+    static void spliceAll(TimerNode& from, TimerNode& to);
+    static bool listEmpty(const TimerNode& head) { return head.next_ == &head; }
+
+    /// @brief 第 level 层从 slot 的下一个槽位开始循环查找第一个非空槽位的位置, 没有时返回 -1
+    int findNextSlot(int level, std::uint64_t slot) const;
+
+    /// @brief 时间轮中 (不含到期列表) 下一个需要处理的 tick
+    std::uint64_t nextWheelTick() const;
+
+    void insert(TimerNode& node);
+    void cascade(int level, std::uint64_t slot);
+
+private:
+    std::uint64_t current_tick_{0};
+    std::size_t size_{0};
+    std::array<Level, kLevels> levels_;
+    TimerNode expired_;
+};
+
+inline TimerNode::~TimerNode() {
+    if (wheel_) {
+        wheel_->cancel(*this);
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+#include "co_async/utils/cancellation.h"
+
+namespace pyc {
+namespace co_async {
+
+class WaiterList;
+
+/// @brief 侵入式等待者节点, 由 awaiter 继承, 排队不需要分配内存
+struct WaiterNode {
+    WaiterNode() = default;
+    WaiterNode(const WaiterNode&) = delete;
+    WaiterNode& operator=(const WaiterNode&) = delete;
+
+    bool linked() const noexcept { return list_ != nullptr; }
+
+    WaiterNode* prev_{nullptr};
+    WaiterNode* next_{nullptr};
+    WaiterList* list_{nullptr};  // 所在的链表, 取消等待时从中移除
+    std::coroutine_handle<> coroutine_{};
+};
+
+/// @brief 先进先出的等待者链表, 本身不加锁, 由所属的同步原语保护
+class WaiterList {
+public:
+    WaiterList() = default;
+    WaiterList(const WaiterList&) = delete;
+    WaiterList& operator=(const WaiterList&) = delete;
+
+    bool empty() const noexcept { return head_ == nullptr; }
+
+    void pushBack(WaiterNode& node) noexcept {
+        node.prev_ = tail_;
+        node.next_ = nullptr;
+        node.list_ = this;
+        if (tail_) {
+            tail_->next_ = &node;
+        } else {
+            head_ = &node;
+        }
+        tail_ = &node;
+    }
+
+    WaiterNode* popFront() noexcept {
+        WaiterNode* node = head_;
+        if (node) {
+            remove(*node);
+        }
+        return node;
+    }
+
+    void remove(WaiterNode& node) noexcept {
+        (node.prev_ ? node.prev_->next_ : head_) = node.next_;
+        (node.next_ ? node.next_->prev_ : tail_) = node.prev_;
+        node.prev_ = node.next_ = nullptr;
+        node.list_ = nullptr;
+    }
+
+private:
+    WaiterNode* head_{nullptr};
+    WaiterNode* tail_{nullptr};
+};
+
+/// @brief 唤醒方在持锁时从 WaiterList 中认领的节点, 释放锁后依次恢复
+/// 认领的节点已不属于任何 WaiterList (linked() 为 false), 取消等待不会再修改它, 因此遍历和恢复都不需要加锁;
+/// 认领之后到恢复之前节点所在的协程帧不能被销毁
+class ReadyList {
+public:
+    ReadyList() = default;
+    ReadyList(const ReadyList&) = delete;
+    ReadyList& operator=(const ReadyList&) = delete;
+
+    /// @brief 认领 list 的头节点, list 为空时返回 false, 需持有保护 list 的锁
+    bool claimFront(WaiterList& list) noexcept {
+        WaiterNode* node = list.popFront();
+        if (!node) {
+            return false;
+        }
+        (tail_ ? tail_->next_ : head_) = node;
+        tail_ = node;
+        return true;
+    }
+
+    /// @brief 认领 list 中的所有节点, 需持有保护 list 的锁
+    void claimAll(WaiterList& list) noexcept {
+        while (claimFront(list)) {
+        }
+    }
+
+    /// @brief 依次恢复认领的协程, 恢复前先取出后继节点, 被恢复的协程可以立即销毁自己的节点
+    void resumeAll() noexcept {
+        WaiterNode* node = std::exchange(head_, nullptr);
+        tail_ = nullptr;
+        while (node) {
+            WaiterNode* next = std::exchange(node->next_, nullptr);
+            node->coroutine_.resume();
+            node = next;
+        }
+    }
+
+private:
+    WaiterNode* head_{nullptr};
+    WaiterNode* tail_{nullptr};
+};
+
+/// @brief 可以取消的同步原语等待者, 由 awaiter 继承
+/// 挂起期间所在协程的 stop_token 被请求停止时, 在持有同步原语的锁时把节点从等待链表中移除,
+/// 然后在请求停止的线程上恢复协程, await_resume 抛出 OperationCancelled; 已被唤醒方认领的节点不受影响
+struct CancellableWaiter : WaiterNode {
+    explicit CancellableWaiter(std::mutex& list_mutex) : list_mutex_(list_mutex) {}
+
+    CancellableWaiter(CancellableWaiter&&) = delete;
+
+    /// @brief 协程帧在等待期间被销毁时退出等待
+    ~CancellableWaiter() {
+        stop_callback_.reset();
+        if (linked()) {
+            cancel();
+        }
+    }
+
+    /// @brief 在 await_suspend 中排队之前调用
+    template <typename P>
+    void prepare(std::coroutine_handle<P> coroutine) {
+        coroutine_ = coroutine;
+        stop_token_ = stopTokenOf(coroutine);
+        if (stop_token_.stop_possible()) {
+            stop_callback_.emplace(stop_token_, Canceller{this});
+        }
+    }
+
+    /// @brief 排队前在持有同步原语的锁时调用, 已请求停止时标记为取消, 调用方不再排队
+    /// 先登记回调再持锁检查, 回调执行时节点还未排队的情况不会丢失取消
+    bool cancelIfStopped() noexcept {
+        cancelled_ = stop_token_.stop_requested();
+        return cancelled_;
+    }
+
+    void throwIfCancelled() const {
+        if (cancelled_) [[unlikely]] {
+            throw OperationCancelled();
+        }
+    }
+
+    /// @brief 节点仍在等待链表中时移除并返回 true
+    bool cancel() {
+        std::lock_guard<std::mutex> lock(list_mutex_);
+        if (!linked()) {
+            return false;
+        }
+        list_->remove(*this);
+        return true;
+    }
+
+    struct Canceller {
+        void operator()() const noexcept {
+            if (waiter_->cancel()) {
+                waiter_->cancelled_ = true;
+                waiter_->coroutine_.resume();
+            }
+        }
+
+        CancellableWaiter* waiter_;
+    };
+
+    std::mutex& list_mutex_;  // 保护等待链表的同步原语的锁
+    std::stop_token stop_token_{};
+    std::optional<std::stop_callback<Canceller>> stop_callback_{};
+    bool cancelled_{false};
+};
+
+}  // namespace co_async
+}  // namespace pyc
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <coroutine>
 #include <exception>
 #include <span>
+#include <stop_token>
 
 #include "co_async/awaiter/concepts.h"
 #include "co_async/awaiter/previous_awaiter.h"
@@ -12,24 +14,42 @@
 namespace pyc {
 namespace co_async {
 
+/// @brief 子任务可以在不同线程上完成, 计数和异常记录都是线程安全的
+/// 启动方也计入计数, 保证所有子任务启动完成之前父协程不会在其他线程上被恢复
+/// 有子任务抛出异常时等待所有子任务结束后再重新抛出第一个异常, 不会在其他子任务仍在运行时销毁它们
+/// 子任务继承父协程的 stop_token
 struct WhenAllAwaiter {
     struct ControlBlock {
-        std::size_t count_;
+        explicit ControlBlock(std::size_t count) : count_(count + 1) {}
+
+        /// @brief 到达一次, 最后一个到达者返回父协程
+        std::coroutine_handle<> arrive() {
+            return count_.fetch_sub(1, std::memory_order_acq_rel) == 1 ? previous_ : nullptr;
+        }
+
+        void setException(std::exception_ptr exception) {
+            if (!has_exception_.exchange(true, std::memory_order_relaxed)) {
+                exception_ = exception;
+            }
+        }
+
+        std::atomic<std::size_t> count_;
+        std::atomic<bool> has_exception_{false};
         std::coroutine_handle<> previous_{nullptr};
         std::exception_ptr exception_{nullptr};
     };
 
     constexpr bool await_ready() const noexcept { return false; }
 
-    std::coroutine_handle<> await_suspend(std::coroutine_handle<> coroutine) const {
-        if (tasks_.empty()) {
-            return coroutine;
-        }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> coroutine) const {
         control_.previous_ = coroutine;
-        for (const auto& task : tasks_.subspan(1)) {
+        const std::stop_token stop_token = stopTokenOf(coroutine);
+        for (const auto& task : tasks_) {
+            task.coroutine_.promise().stop_token_ = stop_token;
             task.coroutine_.resume();
         }
-        return tasks_.front().coroutine_;
+        return control_.arrive() ? std::coroutine_handle<>(coroutine) : std::noop_coroutine();
     }
 
     void await_resume() const {
@@ -48,14 +68,10 @@ ReturnPreviousTask whenAllHelper(const auto& task, WhenAllAwaiter::ControlBlock&
     try {
         result.putValue(co_await task);
     } catch (...) {
-        control.exception_ = std::current_exception();
-        co_return control.previous_;
-    }
-    --control.count_;
-    if (control.count_ == 0) {
-        co_return control.previous_;
+        control.setException(std::current_exception());
     }
-    co_return nullptr;
+    co_return ArriveCallback{
+        [](void* context) { return static_cast<WhenAllAwaiter::ControlBlock*>(context)->arrive(); }, &control};
 }
 
 template <std::size_t... Is, typename... Ts>
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <coroutine>
 #include <exception>
+#include <optional>
 #include <span>
+#include <stop_token>
 #include <variant>
 
 #include "co_async/awaiter/concepts.h"
@@ -11,26 +14,77 @@
 namespace pyc {
 namespace co_async {
 
+/// @brief 第一个完成 (或抛出异常) 的子任务通过原子操作胜出, 然后通过 stop_source 请求停止其余子任务
+/// - 子任务挂起在可取消的等待上 (定时器, I/O, 同步原语) 时以 OperationCancelled 提前结束,
+///   正在运行的子任务在下一个可取消的等待处结束, 它们的结果和异常都被丢弃
+/// - 父协程的 stop_token 被请求停止时转发给所有子任务
+/// - 所有子任务和启动方都到达后才恢复父协程, 此时子任务都已完全挂起在最终挂起点, 销毁它们的协程帧是安全的
 struct WhenAnyCounterBlock {
     static constexpr std::size_t kNullIndex = std::size_t(-1);
 
+    /// @brief 子任务的完成信息, 位于子任务的协程帧中, 在最终挂起点尝试胜出
+    struct Arrival {
+        static std::coroutine_handle<> finish(void* context) {
+            auto& arrival = *static_cast<Arrival*>(context);
+            WhenAnyCounterBlock& control = *arrival.control_;
+            if (!control.finished_.exchange(true, std::memory_order_acq_rel)) {
+                if (arrival.exception_) {
+                    control.exception_ = arrival.exception_;
+                } else {
+                    control.index_ = arrival.index_;
+                }
+                // 被取消的子任务可能在回调中同步恢复并结束, 胜出者此时还未到达, 父协程不会提前恢复
+                control.stop_source_.request_stop();
+            }
+            return control.arrive();
+        }
+
+        WhenAnyCounterBlock* control_;
+        std::size_t index_;
+        std::exception_ptr exception_{};
+    };
+
+    /// @brief 父协程被取消时停止所有子任务
+    struct StopChildren {
+        void operator()() const noexcept { stop_source_->request_stop(); }
+
+        std::stop_source* stop_source_;
+    };
+
+    explicit WhenAnyCounterBlock(std::size_t count) : arrivals_(count + 1) {}
+
+    /// @brief 每个子任务和启动方各到达一次, 最后一个到达者返回父协程
+    std::coroutine_handle<> arrive() {
+        return arrivals_.fetch_sub(1, std::memory_order_acq_rel) == 1 ? previous_ : nullptr;
+    }
+
     std::size_t index_{kNullIndex};
     std::coroutine_handle<> previous_;
     std::exception_ptr exception_;
+    std::atomic<bool> finished_{false};
+    std::atomic<std::size_t> arrivals_;
+    std::stop_source stop_source_;
+    // 在 stop_source_ 之前析构, 析构时等待其他线程上正在执行的回调结束
+    std::optional<std::stop_callback<StopChildren>> parent_stop_{};
 };
 
 struct WhenAnyAwaiter {
     constexpr bool await_ready() const noexcept { return false; }
 
-    std::coroutine_handle<> await_suspend(std::coroutine_handle<> coroutine) const {
-        if (tasks_.empty()) {
-            return coroutine;
-        }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> coroutine) const {
         control_.previous_ = coroutine;
-        for (const auto& task : tasks_.subspan(1)) {
+        std::stop_token parent_token = stopTokenOf(coroutine);
+        if (parent_token.stop_possible()) {
+            control_.parent_stop_.emplace(std::move(parent_token),
+                                          WhenAnyCounterBlock::StopChildren{&control_.stop_source_});
+        }
+        const std::stop_token stop_token = control_.stop_source_.get_token();
+        for (const auto& task : tasks_) {
+            task.coroutine_.promise().stop_token_ = stop_token;
             task.coroutine_.resume();
         }
-        return tasks_.front().coroutine_;
+        return control_.arrive() ? std::coroutine_handle<>(coroutine) : std::noop_coroutine();
     }
 
     void await_resume() const {
@@ -46,20 +100,19 @@ struct WhenAnyAwaiter {
 template <typename T>
 ReturnPreviousTask whenAnyHelper(const auto& task, WhenAnyCounterBlock& control, Uninitialized<T>& result,
                                  std::size_t index) {
+    WhenAnyCounterBlock::Arrival arrival{&control, index};
     try {
         result.putValue(co_await task);
     } catch (...) {
-        control.exception_ = std::current_exception();
-        co_return control.previous_;
+        arrival.exception_ = std::current_exception();
     }
-    control.index_ = index;
-    co_return control.previous_;
+    co_return ArriveCallback{&WhenAnyCounterBlock::Arrival::finish, &arrival};
 }
 
 template <std::size_t... Is, typename... Ts>
 Task<std::variant<typename AwaitableTraits<Ts>::NonVoidRetType...>> whenAnyImpl(std::index_sequence<Is...>,
                                                                                 Ts&&... ts) {
-    WhenAnyCounterBlock control{};
+    WhenAnyCounterBlock control{sizeof...(Ts)};
     std::tuple<Uninitialized<typename AwaitableTraits<Ts>::RetType>...> result;
     ReturnPreviousTask tasks[] = {whenAnyHelper(std::forward<Ts>(ts), control, std::get<Is>(result), Is)...};
     co_await WhenAnyAwaiter(control, tasks);
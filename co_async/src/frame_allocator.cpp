@@ -0,0 +1,119 @@
+#include "co_async/utils/frame_allocator.h"
+
+namespace pyc {
+namespace co_async {
+
+namespace {
+
+enum class PoolState : std::uint8_t {
+    kUninitialized,
+    kAlive,
+    kDestroyed,
+};
+
+// 平凡析构, 线程退出的任何阶段都可以安全访问
+thread_local PoolState pool_state = PoolState::kUninitialized;
+
+}  // namespace
+
+FramePool::~FramePool() {
+    trim();
+    pool_state = PoolState::kDestroyed;
+}
+
+FramePool* FramePool::local() {
+    if (pool_state == PoolState::kDestroyed) {
+        return nullptr;
+    }
+    thread_local FramePool pool;
+    pool_state = PoolState::kAlive;
+    return &pool;
+}
+
+void* FramePool::allocate(std::size_t size) {
+    stats_.allocations_++;
+    if (size > kMaxPooledSize) {
+        stats_.oversized_++;
+        return ::operator new(size);
+    }
+    const std::size_t index = classOf(size);
+    if (FreeBlock* block = free_lists_[index]) {
+        free_lists_[index] = block->next_;
+        cached_[index]--;
+        stats_.pool_hits_++;
+        return block;
+    }
+    stats_.pool_misses_++;
+    return ::operator new(blockSize(size));
+}
+
+void FramePool::deallocate(void* block, std::size_t size) noexcept {
+    stats_.deallocations_++;
+    if (size > kMaxPooledSize) {
+        ::operator delete(block);
+        return;
+    }
+    const std::size_t index = classOf(size);
+    if (cached_[index] >= kMaxCachedPerClass) {
+        ::operator delete(block);
+        return;
+    }
+    free_lists_[index] = ::new (block) FreeBlock{free_lists_[index]};
+    cached_[index]++;
+}
+
+void FramePool::trim() noexcept {
+    for (std::size_t i = 0; i < kClassCount; i++) {
+        while (FreeBlock* block = free_lists_[i]) {
+            free_lists_[i] = block->next_;
+            ::operator delete(block);
+        }
+        cached_[i] = 0;
+    }
+}
+
+FrameAllocStats frameAllocStats() {
+    FramePool* pool = FramePool::local();
+    return pool ? pool->stats() : FrameAllocStats{};
+}
+
+namespace detail {
+
+void* allocatePooledFrame(std::size_t size) {
+    const std::size_t total = kHeaderSize + size;
+    FramePool* pool = FramePool::local();
+    // 内存池已销毁时也按类别上限申请, 这个块之后可能在其他线程上释放并进入那里的空闲链表
+    void* block = pool ? pool->allocate(total) : ::operator new(FramePool::blockSize(total));
+    auto* header = ::new (block) FrameHeader{nullptr};
+    return header + 1;
+}
+
+void deallocateFrame(void* frame, std::size_t size) noexcept {
+    FrameHeader* header = static_cast<FrameHeader*>(frame) - 1;
+    if (header->deallocate_) {
+        FramePool* pool = FramePool::local();
+        if (pool) {
+            pool->stats().deallocations_++;
+        }
+        header->deallocate_(header, size);
+        return;
+    }
+    const std::size_t total = kHeaderSize + size;
+    if (FramePool* pool = FramePool::local()) {
+        pool->deallocate(header, total);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+void countCustomAllocation() noexcept {
+    if (FramePool* pool = FramePool::local()) {
+        pool->stats().allocations_++;
+        pool->stats().custom_++;
+    }
+}
+
+}  // namespace detail
+
+}  // namespace co_async
+}  // namespace pyc
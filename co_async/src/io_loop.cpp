@@ -0,0 +1,180 @@
+#include "co_async/io_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "co_async/awaiter/io_awaiter.h"
+#include "co_async/timer_loop.h"
+
+namespace pyc {
+namespace co_async {
+
+namespace {
+
+constexpr int kMaxEvents = 128;
+
+std::size_t indexOf(IoEvent event) { return static_cast<std::size_t>(event); }
+
+}  // namespace
+
+IoLoop::IoLoop()
+    : epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), wake_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    if (epoll_fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "epoll_create1");
+    }
+    if (wake_fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) < 0) {
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+    }
+    TimerLoop::GetInstance().setWaker(&IoLoop::wake);
+}
+
+IoLoop::~IoLoop() {
+    TimerLoop::GetInstance().setWaker(nullptr);
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+void IoLoop::wake() {
+    const std::uint64_t value = 1;
+    [[maybe_unused]] const ssize_t n = ::write(GetInstance().wake_fd_, &value, sizeof(value));
+}
+
+IoLoop::FdState& IoLoop::registerFd(int fd) {
+    auto iter = fds_.find(fd);
+    if (iter != fds_.end()) {
+        return *iter->second;
+    }
+    auto state = std::make_unique<FdState>(fd);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+    }
+    return *fds_.emplace(fd, std::move(state)).first->second;
+}
+
+void IoLoop::unregister(int fd) {
+    auto iter = fds_.find(fd);
+    if (iter == fds_.end()) {
+        return;
+    }
+    if (iter->second->waiters_[0] || iter->second->waiters_[1]) {
+        throw std::logic_error("unregister a fd with pending waiters");
+    }
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    fds_.erase(iter);
+}
+
+bool IoLoop::consumeReady(int fd, IoEvent event) {
+    auto iter = fds_.find(fd);
+    if (iter == fds_.end()) {
+        return false;
+    }
+    return std::exchange(iter->second->ready_[indexOf(event)], false);
+}
+
+void IoLoop::addWaiter(IoAwaiter& awaiter) {
+    FdState& state = registerFd(awaiter.fd_);
+    IoAwaiter*& waiter = state.waiters_[indexOf(awaiter.event_)];
+    if (waiter) {
+        throw std::logic_error("another coroutine is already waiting for the same fd and event");
+    }
+    waiter = &awaiter;
+    awaiter.waiting_ = true;
+    waiter_count_++;
+}
+
+void IoLoop::removeWaiter(IoAwaiter& awaiter) {
+    auto iter = fds_.find(awaiter.fd_);
+    if (iter != fds_.end()) {
+        IoAwaiter*& waiter = iter->second->waiters_[indexOf(awaiter.event_)];
+        if (waiter == &awaiter) {
+            waiter = nullptr;
+            waiter_count_--;
+        }
+    }
+    awaiter.waiting_ = false;
+}
+
+void IoLoop::dispatch(int fd, IoEvent event) {
+    auto iter = fds_.find(fd);
+    if (iter == fds_.end()) {
+        return;
+    }
+    FdState& state = *iter->second;
+    IoAwaiter* awaiter = std::exchange(state.waiters_[indexOf(event)], nullptr);
+    if (!awaiter) {
+        state.ready_[indexOf(event)] = true;
+        return;
+    }
+    waiter_count_--;
+    awaiter->waiting_ = false;
+    awaiter->coroutine_.resume();
+}
+
+void IoLoop::runOnce() {
+    auto& timer_loop = TimerLoop::GetInstance();
+    timer_loop.runExpired();
+
+    int timeout = -1;
+    const auto wake_time = timer_loop.nextWakeTime();
+    if (wake_time != TimerLoop::Clock::time_point::max()) {
+        // 向上取整到毫秒, 避免在定时器到期前反复醒来
+        const auto wait = std::chrono::ceil<std::chrono::milliseconds>(wake_time - TimerLoop::Clock::now());
+        timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(wait.count(), 0));
+    } else if (waiter_count_ == 0) {
+        return;
+    }
+
+    epoll_event events[kMaxEvents];
+    const int count = ::epoll_wait(epoll_fd_, events, kMaxEvents, timeout);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return;
+        }
+        throw std::system_error(errno, std::generic_category(), "epoll_wait");
+    }
+    for (int i = 0; i < count; i++) {
+        const std::uint32_t flags = events[i].events;
+        const int fd = events[i].data.fd;
+        if (fd == wake_fd_) {
+            // 取消请求由之后的 runExpired 处理
+            std::uint64_t value = 0;
+            [[maybe_unused]] const ssize_t n = ::read(wake_fd_, &value, sizeof(value));
+            continue;
+        }
+        // 恢复的协程可能注销同一批事件中的 fd, 每次分发前都重新查找
+        if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            dispatch(fd, IoEvent::kRead);
+        }
+        if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+            dispatch(fd, IoEvent::kWrite);
+        }
+    }
+    timer_loop.runExpired();
+}
+
+void IoLoop::runAll() {
+    while (waiter_count_ != 0 || !TimerLoop::GetInstance().empty()) {
+        runOnce();
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,137 @@
+#include "co_async/scheduler.h"
+
+#include <algorithm>
+
+namespace pyc {
+namespace co_async {
+
+namespace {
+
+thread_local const Scheduler* current_scheduler = nullptr;
+thread_local std::size_t current_index = 0;
+
+}  // namespace
+
+Scheduler::Scheduler(std::size_t thread_num) {
+    thread_num = std::max<std::size_t>(thread_num, 1);
+    workers_.reserve(thread_num);
+    for (std::size_t i = 0; i < thread_num; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // 所有队列创建完成后再启动线程, 窃取时会访问其他工作线程的队列
+    for (std::size_t i = 0; i < thread_num; i++) {
+        workers_[i]->thread_ = std::thread([this, i]() { workerThread(i); });
+    }
+}
+
+Scheduler::~Scheduler() { shutdown(); }
+
+bool Scheduler::inWorkerThread() const { return current_scheduler == this; }
+
+void Scheduler::push(Worker& worker, std::coroutine_handle<> coroutine) {
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex_);
+        worker.queue_.push_back(coroutine);
+        worker.size_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    // 与 workerThread 中 idle_ 递增后检查队列配对, 两者都是 seq_cst, 至少有一方能看到对方
+    if (idle_.load(std::memory_order_seq_cst) != 0) {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        park_cv_.notify_one();
+    }
+}
+
+void Scheduler::schedule(std::coroutine_handle<> coroutine) {
+    if (inWorkerThread()) {
+        push(*workers_[current_index], coroutine);
+        return;
+    }
+    const std::size_t index = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    push(*workers_[index], coroutine);
+}
+
+std::coroutine_handle<> Scheduler::pop(std::size_t index) {
+    Worker& worker = *workers_[index];
+    if (worker.size_.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard<std::mutex> lock(worker.mutex_);
+        if (!worker.queue_.empty()) {
+            std::coroutine_handle<> coroutine = worker.queue_.front();
+            worker.queue_.pop_front();
+            worker.size_.fetch_sub(1, std::memory_order_relaxed);
+            return coroutine;
+        }
+    }
+    return steal(index);
+}
+
+std::coroutine_handle<> Scheduler::steal(std::size_t index) {
+    const std::size_t count = workers_.size();
+    std::vector<std::coroutine_handle<>> stolen;
+    for (std::size_t i = 1; i < count; i++) {
+        Worker& victim = *workers_[(index + i) % count];
+        if (victim.size_.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex_);
+            const std::size_t n = (victim.queue_.size() + 1) / 2;
+            if (n == 0) {
+                continue;
+            }
+            stolen.assign(victim.queue_.end() - static_cast<std::ptrdiff_t>(n), victim.queue_.end());
+            victim.queue_.resize(victim.queue_.size() - n);
+            victim.size_.fetch_sub(n, std::memory_order_relaxed);
+        }
+        // 运行第一个, 其余放入自己的队列, 此时其他空闲线程可以继续从这里窃取
+        if (stolen.size() > 1) {
+            Worker& self = *workers_[index];
+            std::lock_guard<std::mutex> lock(self.mutex_);
+            self.queue_.insert(self.queue_.end(), stolen.begin() + 1, stolen.end());
+            self.size_.fetch_add(stolen.size() - 1, std::memory_order_seq_cst);
+        }
+        return stolen.front();
+    }
+    return nullptr;
+}
+
+bool Scheduler::hasWork() const {
+    return std::any_of(workers_.begin(), workers_.end(), [](const std::unique_ptr<Worker>& worker) {
+        return worker->size_.load(std::memory_order_seq_cst) != 0;
+    });
+}
+
+void Scheduler::workerThread(std::size_t index) {
+    current_scheduler = this;
+    current_index = index;
+    for (;;) {
+        if (std::coroutine_handle<> coroutine = pop(index)) {
+            coroutine.resume();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        idle_.fetch_add(1, std::memory_order_seq_cst);
+        park_cv_.wait(lock, [this]() { return hasWork() || stop_.load(std::memory_order_relaxed); });
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+        if (stop_.load(std::memory_order_relaxed) && !hasWork()) {
+            break;
+        }
+    }
+    current_scheduler = nullptr;
+}
+
+void Scheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(park_mutex_);
+        stop_.store(true, std::memory_order_seq_cst);
+    }
+    park_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread_.joinable()) {
+            worker->thread_.join();
+        }
+    }
+}
+
+}  // namespace co_async
+}  // namespace pyc
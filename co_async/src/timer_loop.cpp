@@ -1,5 +1,6 @@
 #include "co_async/timer_loop.h"
 
+#include <mutex>
 #include <thread>
 
 #ifdef CO_ASYNC_DEBUG
@@ -11,32 +12,138 @@
 namespace pyc {
 namespace co_async {
 
-void TimerLoop::addTimer(std::chrono::system_clock::time_point expire_time, std::coroutine_handle<> task) {
-    auto [iter, _] = timer_map_.emplace(expire_time, task);
-    search_table_.emplace(task, iter);
+std::uint64_t TimerLoop::toTick(Clock::time_point time_point, bool round_up) const {
+    if (time_point <= start_time_) {
+        return 0;
+    }
+    const auto elapsed = time_point - start_time_;
+    auto ticks = static_cast<std::uint64_t>(elapsed / kTick);
+    if (round_up && elapsed % kTick != Clock::duration::zero()) {
+        ticks++;
+    }
+    return ticks;
+}
+
+void TimerLoop::addTimer(Clock::time_point expire_time, TimerNode& node) {
+    node.expire_tick_ = toTick(expire_time, true);
+    wheel_.add(node);
+}
+
+void TimerLoop::cancelTimer(TimerNode& node) { wheel_.cancel(node); }
+
+void TimerLoop::runInLoop(Posted& posted) {
+    if (inLoopThread()) {
+        posted.run_(posted.context_);
+        return;
+    }
+    void (*waker)() = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(cancel_mutex_);
+        posted_.pushBack(posted);
+        posted_count_.fetch_add(1, std::memory_order_relaxed);
+        waker = waker_;
+    }
+    wake(waker);
 }
 
-void TimerLoop::deleteTask(std::coroutine_handle<> task) {
-    auto search = search_table_.find(task);
-    if (search != search_table_.end()) {
-        timer_map_.erase(search->second);
-        search_table_.erase(search);
+void TimerLoop::postCancel(CancelRequest& request) {
+    void (*waker)() = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(cancel_mutex_);
+        cancel_requests_.pushBack(request);
+        waker = waker_;
     }
+    wake(waker);
+}
+
+void TimerLoop::wake(void (*waker)()) {
+    cancel_cv_.notify_one();
+    if (waker) {
+        waker();
+    }
+}
+
+void TimerLoop::withdrawCancel(CancelRequest& request) {
+    std::lock_guard<std::mutex> lock(cancel_mutex_);
+    if (request.linked()) {
+        cancel_requests_.remove(request);
+    }
+}
+
+void TimerLoop::setWaker(void (*waker)()) {
+    std::lock_guard<std::mutex> lock(cancel_mutex_);
+    waker_ = waker;
+}
+
+std::size_t TimerLoop::runPosted() {
+    std::size_t count = 0;
+    for (;;) {
+        Posted* posted;
+        {
+            std::lock_guard<std::mutex> lock(cancel_mutex_);
+            posted = static_cast<Posted*>(posted_.popFront());
+        }
+        if (!posted) {
+            return count;
+        }
+        // 执行完再减少计数, 执行期间 empty 仍为 false
+        posted->run_(posted->context_);
+        posted_count_.fetch_sub(1, std::memory_order_release);
+        count++;
+    }
+}
+
+std::size_t TimerLoop::runCancelled() {
+    std::size_t count = 0;
+    for (;;) {
+        CancelRequest* request;
+        {
+            std::lock_guard<std::mutex> lock(cancel_mutex_);
+            request = static_cast<CancelRequest*>(cancel_requests_.popFront());
+        }
+        if (!request) {
+            return count;
+        }
+        // 请求仍在链表中说明协程还没有被定时器或 I/O 事件恢复, 二者都只在本线程上发生
+        request->cancelled_ = true;
+        request->coroutine_.resume();
+        count++;
+    }
+}
+
+std::size_t TimerLoop::runExpired() {
+    loop_thread_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    std::size_t count = runPosted();
+    count += runCancelled();
+    wheel_.advance(toTick(Clock::now(), false));
+    while (TimerNode* node = wheel_.popExpired()) {
+        node->coroutine_.resume();
+        count++;
+    }
+    return count;
+}
+
+TimerLoop::Clock::time_point TimerLoop::nextWakeTime() const {
+    if (wheel_.empty()) {
+        return Clock::time_point::max();
+    }
+    // 下一次推进可能只是降级而没有定时器到期, 醒来后会继续等待
+    return start_time_ + wheel_.nextTick() * kTick;
 }
 
 void TimerLoop::runAll() {
-    while (!timer_map_.empty()) {
-        auto now_time = std::chrono::system_clock::now();
-        auto [expire_time, task] = *timer_map_.begin();
-        if (now_time >= expire_time) {
-            deleteTask(task);
-            task.resume();
-        } else {
+    while (!empty()) {
+        if (runExpired() != 0) {
+            continue;
+        }
+        const auto wake_time = nextWakeTime();
 #ifdef CO_ASYNC_DEBUG
-            logger.debug("No task Loop waiting for {:%S}s", expire_time - now_time);
+        logger.debug("No task Loop waiting for {:%S}s", wake_time - Clock::now());
 #endif
-            std::this_thread::sleep_until(expire_time);
-        }
+        // 其他线程登记取消请求或转交操作时提前醒来
+        std::unique_lock<std::mutex> lock(cancel_mutex_);
+        cancel_cv_.wait_until(lock, wake_time,
+                              [this]() { return !cancel_requests_.empty() || !posted_.empty(); });
     }
 }
 
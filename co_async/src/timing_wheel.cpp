@@ -0,0 +1,185 @@
+#include "co_async/utils/timing_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace pyc {
+namespace co_async {
+
+namespace {
+
+constexpr std::uint64_t kMaxTick = std::numeric_limits<std::uint64_t>::max();
+
+/// @brief 第 level 层一个槽位覆盖的 tick 数的位数
+constexpr int shiftOf(int level) { return level * TimingWheel::kLevelBits; }
+
+constexpr std::uint64_t slotOf(std::uint64_t tick, int level) {
+    return (tick >> shiftOf(level)) & (TimingWheel::kSlots - 1);
+}
+
+}  // namespace
+
+TimingWheel::TimingWheel() {
+    for (auto& level : levels_) {
+        for (auto& head : level.slots_) {
+            initList(head);
+        }
+    }
+    initList(expired_);
+}
+
+TimingWheel::~TimingWheel() {
+    // 节点由外部持有, 只需断开链接, 避免节点析构时访问已释放的时间轮
+    auto clear = [](TimerNode& head) {
+        while (!listEmpty(head)) {
+            TimerNode* node = head.next_;
+            node->unlink();
+            node->wheel_ = nullptr;
+        }
+        head.prev_ = head.next_ = nullptr;
+    };
+    for (auto& level : levels_) {
+        for (auto& head : level.slots_) {
+            clear(head);
+        }
+    }
+    clear(expired_);
+}
+
+void TimingWheel::initList(TimerNode& head) { head.prev_ = head.next_ = &head; }
+
+void TimingWheel::pushBack(TimerNode& head, TimerNode& node) {
+    node.prev_ = head.prev_;
+    node.next_ = &head;
+    head.prev_->next_ = &node;
+    head.prev_ = &node;
+}
+
+void TimingWheel::spliceAll(TimerNode& from, TimerNode& to) {
+    if (listEmpty(from)) {
+        return;
+    }
+    from.next_->prev_ = to.prev_;
+    to.prev_->next_ = from.next_;
+    from.prev_->next_ = &to;
+    to.prev_ = from.prev_;
+    initList(from);
+}
+
+void TimingWheel::add(TimerNode& node) {
+    cancel(node);
+    node.wheel_ = this;
+    size_++;
+    insert(node);
+}
+
+void TimingWheel::cancel(TimerNode& node) {
+    // 槽位变空时不清除位图, 推进到该槽位时再清除, 取消只需要 O(1) 的断链
+    if (node.wheel_ == this && node.linked()) {
+        node.unlink();
+        size_--;
+    }
+    node.wheel_ = nullptr;
+}
+
+void TimingWheel::insert(TimerNode& node) {
+    if (node.expire_tick_ <= current_tick_) {
+        pushBack(expired_, node);
+        return;
+    }
+
+    const std::uint64_t delta = node.expire_tick_ - current_tick_;
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (std::uint64_t{1} << shiftOf(level + 1))) {
+        level++;
+    }
+    std::uint64_t position = node.expire_tick_;
+    if (level == kLevels - 1 && delta >= (std::uint64_t{1} << shiftOf(kLevels))) {
+        // 超出时间轮范围, 先放在最高层最远的槽位, 降级时再按真实到期时间插入
+        position = current_tick_ + (std::uint64_t{1} << shiftOf(kLevels)) - 1;
+    }
+    const std::uint64_t slot = slotOf(position, level);
+    pushBack(levels_[level].slots_[slot], node);
+    levels_[level].bitmap_[slot / 64] |= std::uint64_t{1} << (slot % 64);
+}
+
+void TimingWheel::cascade(int level, std::uint64_t slot) {
+    levels_[level].bitmap_[slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+    // 先摘下整条链表, 重新插入时可能插回同一层
+    TimerNode pending;
+    initList(pending);
+    spliceAll(levels_[level].slots_[slot], pending);
+    while (!listEmpty(pending)) {
+        TimerNode* node = pending.next_;
+        node->unlink();
+        insert(*node);
+    }
+    pending.prev_ = pending.next_ = nullptr;
+}
+
+int TimingWheel::findNextSlot(int level, std::uint64_t slot) const {
+    const auto& bitmap = levels_[level].bitmap_;
+    // 依次检查 slot + 1, slot + 2, ..., slot + kSlots (即 slot 自身), 每次处理一个字中剩余的位
+    for (std::uint64_t i = 1; i <= kSlots;) {
+        const std::uint64_t candidate = (slot + i) & (kSlots - 1);
+        const std::uint64_t bits = bitmap[candidate / 64] >> (candidate % 64);
+        if (bits != 0) {
+            return static_cast<int>(candidate + static_cast<std::uint64_t>(std::countr_zero(bits)));
+        }
+        i += 64 - candidate % 64;
+    }
+    return -1;
+}
+
+std::uint64_t TimingWheel::nextTick() const { return listEmpty(expired_) ? nextWheelTick() : current_tick_; }
+
+std::uint64_t TimingWheel::nextWheelTick() const {
+    std::uint64_t result = kMaxTick;
+    for (int level = 0; level < kLevels; level++) {
+        const int slot = findNextSlot(level, slotOf(current_tick_, level));
+        if (slot < 0) {
+            continue;
+        }
+        // 该层下一次处理 slot 的 tick: 更高位与当前相同, 本层为 slot, 更低位为 0, 不晚于当前时则进入下一轮
+        const int upper_shift = shiftOf(level + 1);
+        std::uint64_t tick =
+            ((current_tick_ >> upper_shift) << upper_shift) + (static_cast<std::uint64_t>(slot) << shiftOf(level));
+        if (tick <= current_tick_) {
+            tick += std::uint64_t{1} << upper_shift;
+        }
+        result = std::min(result, tick);
+    }
+    return result;
+}
+
+void TimingWheel::advance(std::uint64_t now_tick) {
+    while (current_tick_ < now_tick) {
+        const std::uint64_t next = nextWheelTick();
+        if (next > now_tick) {
+            current_tick_ = now_tick;
+            return;
+        }
+        current_tick_ = next;
+        // 从高层到低层降级, 高层降级的定时器可能落入本 tick 同样需要降级的低层槽位, 第 0 层的降级即到期
+        for (int level = kLevels - 1; level >= 0; level--) {
+            if ((current_tick_ & ((std::uint64_t{1} << shiftOf(level)) - 1)) == 0) {
+                cascade(level, slotOf(current_tick_, level));
+            }
+        }
+    }
+}
+
+TimerNode* TimingWheel::popExpired() {
+    if (listEmpty(expired_)) {
+        return nullptr;
+    }
+    TimerNode* node = expired_.next_;
+    node->unlink();
+    node->wheel_ = nullptr;
+    size_--;
+    return node;
+}
+
+}  // namespace co_async
+}  // namespace pyc
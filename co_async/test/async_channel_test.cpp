@@ -0,0 +1,98 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "co_async/async_channel.h"
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+#include "co_async/when_all.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+static Task<int> produce(AsyncChannel<int>& channel, int count) {
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(co_await channel.send(i));
+        // 缓冲区容量为 2, 发送方最多领先接收方 2 个值
+        EXPECT_LE(channel.size(), channel.capacity());
+    }
+    channel.close();
+    co_return count;
+}
+
+static Task<int> consume(AsyncChannel<int>& channel, std::vector<int>& received) {
+    while (auto value = co_await channel.receive()) {
+        received.push_back(*value);
+        co_await sleep_for(10ms);
+    }
+    co_return static_cast<int>(received.size());
+}
+
+static Task<int> pipeline() {
+    AsyncChannel<int> channel(2);
+    std::vector<int> received;
+    Timer timer;
+    auto [sent, count] = co_await when_all(produce(channel, 10), consume(channel, received));
+    // 接收方每个值耗时 10ms, 发送方被背压拖慢
+    EXPECT_GE(timer.elapsed(), 100ms);
+    EXPECT_LT(timer.elapsed(), 150ms);
+    EXPECT_EQ(sent, count);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(received[i], i);
+    }
+    co_return count;
+}
+
+TEST(AsyncChannelTest, Pipeline) {
+    auto task = pipeline();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 10);
+}
+
+TEST(AsyncChannelTest, TrySendReceive) {
+    AsyncChannel<std::string> channel(2);
+    EXPECT_TRUE(channel.trySend("a"));
+    EXPECT_TRUE(channel.trySend("b"));
+    EXPECT_FALSE(channel.trySend("c"));
+    EXPECT_EQ(channel.tryReceive(), "a");
+    channel.close();
+    EXPECT_FALSE(channel.trySend("d"));
+    // 关闭后仍可取出已缓冲的值
+    EXPECT_EQ(channel.tryReceive(), "b");
+    EXPECT_EQ(channel.tryReceive(), std::nullopt);
+}
+
+static Task<int> receiveAfterClose(AsyncChannel<int>& channel) {
+    auto value = co_await channel.receive();
+    co_return value ? *value : -1;
+}
+
+static Task<int> closeLater(AsyncChannel<int>& channel) {
+    co_await sleep_for(50ms);
+    channel.close();
+    co_return 0;
+}
+
+static Task<int> closeWakesReceivers() {
+    AsyncChannel<int> channel(1);
+    auto [a, b, c] =
+        co_await when_all(receiveAfterClose(channel), receiveAfterClose(channel), closeLater(channel));
+    co_return a + b + c;
+}
+
+TEST(AsyncChannelTest, CloseWakesReceivers) {
+    auto task = closeWakesReceivers();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), -2);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,118 @@
+#include <cstddef>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "co_async/task.h"
+#include "co_async/utils/frame_allocator.h"
+#include "co_async/when_all.h"
+
+namespace pyc {
+namespace co_async {
+
+static Task<int> value(int i) { co_return i; }
+
+static Task<int> sum() {
+    auto [a, b, c] = co_await when_all(value(1), value(2), value(3));
+    co_return a + b + c;
+}
+
+TEST(FrameAllocatorTest, ReuseFrames) {
+    {
+        auto task = sum();
+        task.coroutine_.resume();
+        EXPECT_EQ(task.coroutine_.promise().result(), 6);
+    }
+    const FrameAllocStats before = frameAllocStats();
+    constexpr int kRounds = 1000;
+    for (int i = 0; i < kRounds; i++) {
+        auto task = sum();
+        task.coroutine_.resume();
+        EXPECT_EQ(task.coroutine_.promise().result(), 6);
+    }
+    const FrameAllocStats after = frameAllocStats();
+
+    // 每轮 sum, whenAllImpl, 3 个 value 和 3 个 whenAllHelper 共 8 个协程帧, 预热后全部从空闲链表复用
+    EXPECT_EQ(after.allocations_ - before.allocations_, 8 * kRounds);
+    EXPECT_EQ(after.deallocations_ - before.deallocations_, 8 * kRounds);
+    EXPECT_EQ(after.pool_hits_ - before.pool_hits_, 8 * kRounds);
+    EXPECT_EQ(after.pool_misses_, before.pool_misses_);
+}
+
+TEST(FrameAllocatorTest, Pool) {
+    FramePool* pool = FramePool::local();
+    ASSERT_NE(pool, nullptr);
+    pool->trim();
+    const FrameAllocStats before = pool->stats();
+
+    void* a = pool->allocate(100);
+    pool->deallocate(a, 100);
+    // 同一尺寸类别复用同一个块
+    void* b = pool->allocate(128);
+    EXPECT_EQ(a, b);
+    pool->deallocate(b, 128);
+
+    void* large = pool->allocate(FramePool::kMaxPooledSize + 1);
+    pool->deallocate(large, FramePool::kMaxPooledSize + 1);
+
+    const FrameAllocStats after = pool->stats();
+    EXPECT_EQ(after.allocations_ - before.allocations_, 3);
+    EXPECT_EQ(after.deallocations_ - before.deallocations_, 3);
+    EXPECT_EQ(after.pool_misses_ - before.pool_misses_, 1);
+    EXPECT_EQ(after.pool_hits_ - before.pool_hits_, 1);
+    EXPECT_EQ(after.oversized_ - before.oversized_, 1);
+}
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(int* live) : live_(live) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : live_(other.live_) {}
+
+    T* allocate(std::size_t n) {
+        ++*live_;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        --*live_;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    int* live_;
+};
+
+static Task<int> withAllocator(std::allocator_arg_t, CountingAllocator<std::byte>, int i) { co_return i * 2; }
+
+struct Widget {
+    Task<int> twice(std::allocator_arg_t, CountingAllocator<std::byte>, int i) { co_return i * factor_; }
+
+    int factor_{2};
+};
+
+TEST(FrameAllocatorTest, AllocatorArg) {
+    int live = 0;
+    const FrameAllocStats before = frameAllocStats();
+    {
+        auto task = withAllocator(std::allocator_arg, CountingAllocator<std::byte>(&live), 21);
+        EXPECT_EQ(live, 1);
+        task.coroutine_.resume();
+        EXPECT_EQ(task.coroutine_.promise().result(), 42);
+    }
+    EXPECT_EQ(live, 0);
+    {
+        Widget widget;
+        auto task = widget.twice(std::allocator_arg, CountingAllocator<std::byte>(&live), 4);
+        EXPECT_EQ(live, 1);
+        task.coroutine_.resume();
+        EXPECT_EQ(task.coroutine_.promise().result(), 8);
+    }
+    EXPECT_EQ(live, 0);
+    EXPECT_EQ(frameAllocStats().custom_ - before.custom_, 2);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,85 @@
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "co_async/generator.h"
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+static Generator<int> fibonacci(int count) {
+    int a = 0;
+    int b = 1;
+    for (int i = 0; i < count; i++) {
+        co_yield a;
+        b = std::exchange(a, b) + b;
+    }
+}
+
+TEST(GeneratorTest, Basic) {
+    std::vector<int> values;
+    for (int value : fibonacci(8)) {
+        values.push_back(value);
+    }
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 1, 2, 3, 5, 8, 13}));
+}
+
+static Generator<int> failAfter(int count) {
+    for (int i = 0; i < count; i++) {
+        co_yield i;
+    }
+    throw std::runtime_error("generator failed");
+}
+
+TEST(GeneratorTest, Exception) {
+    int sum = 0;
+    EXPECT_THROW(
+        {
+            for (int value : failAfter(3)) {
+                sum += value;
+            }
+        },
+        std::runtime_error);
+    EXPECT_EQ(sum, 3);
+}
+
+static AsyncGenerator<std::string> ticks(int count) {
+    std::string last = "tick";
+    for (int i = 0; i < count; i++) {
+        co_await sleep_for(20ms);
+        co_yield last;
+        co_yield std::to_string(i);
+    }
+}
+
+static Task<int> consumeTicks() {
+    Timer timer;
+    auto generator = ticks(3);
+    std::vector<std::string> values;
+    while (auto value = co_await generator.next()) {
+        values.push_back(std::move(*value));
+    }
+    EXPECT_GE(timer.elapsed(), 60ms);
+    EXPECT_LT(timer.elapsed(), 90ms);
+    // 左值 co_yield 的值被复制, 不会被消费方移走
+    EXPECT_EQ(values, (std::vector<std::string>{"tick", "0", "tick", "1", "tick", "2"}));
+    co_return static_cast<int>(values.size());
+}
+
+TEST(AsyncGeneratorTest, Basic) {
+    auto task = consumeTicks();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 6);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,168 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include "co_async/io.h"
+#include "co_async/io_loop.h"
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+#include "co_async/when_all.h"
+#include "co_async/when_any.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+static void makeSocketPair(int fds[2]) {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds), 0);
+}
+
+static Task<int> readAfterWrite(int reader, int writer) {
+    Timer timer;
+    auto [data, _] = co_await when_all(
+        [](int fd) -> Task<std::string> {
+            char buffer[64];
+            std::size_t n = co_await async_read(fd, buffer);
+            co_return std::string(buffer, n);
+        }(reader),
+        [](int fd) -> Task<int> {
+            co_await sleep_for(100ms);
+            co_await async_write(fd, std::string_view("hello"));
+            co_return 0;
+        }(writer));
+    EXPECT_ELAPSED_TIME(timer.elapsed(), 100ms);
+    EXPECT_EQ(data, "hello");
+    co_return static_cast<int>(data.size());
+}
+
+TEST(IoLoopTest, ReadAfterWrite) {
+    int fds[2];
+    makeSocketPair(fds);
+    auto task = readAfterWrite(fds[0], fds[1]);
+    task.coroutine_.resume();
+    IoLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 5);
+    EXPECT_EQ(IoLoop::GetInstance().waiterCount(), 0);
+    close_fd(fds[0]);
+    close_fd(fds[1]);
+}
+
+static Task<int> readTimeout(int fd) {
+    Timer timer;
+    char buffer[16];
+    try {
+        co_await async_read(fd, buffer, 100ms);
+    } catch (const std::system_error& e) {
+        EXPECT_ELAPSED_TIME(timer.elapsed(), 100ms);
+        co_return e.code().value();
+    }
+    co_return 0;
+}
+
+TEST(IoLoopTest, ReadTimeout) {
+    int fds[2];
+    makeSocketPair(fds);
+    auto task = readTimeout(fds[0]);
+    task.coroutine_.resume();
+    IoLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), ETIMEDOUT);
+    EXPECT_EQ(IoLoop::GetInstance().waiterCount(), 0);
+    EXPECT_EQ(TimerLoop::GetInstance().timerCount(), 0);
+    close_fd(fds[0]);
+    close_fd(fds[1]);
+}
+
+static Task<int> cancelRead(int fd) {
+    auto var = co_await when_any(
+        [](int fd) -> Task<int> {
+            char buffer[16];
+            co_return static_cast<int>(co_await async_read(fd, buffer));
+        }(fd),
+        [](int) -> Task<int> {
+            co_await sleep_for(50ms);
+            co_return -1;
+        }(fd));
+    EXPECT_EQ(var.index(), 1);
+    co_return static_cast<int>(var.index());
+}
+
+TEST(IoLoopTest, CancelByWhenAny) {
+    int fds[2];
+    makeSocketPair(fds);
+    auto task = cancelRead(fds[0]);
+    task.coroutine_.resume();
+    IoLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 1);
+    EXPECT_EQ(IoLoop::GetInstance().waiterCount(), 0);
+    close_fd(fds[0]);
+    close_fd(fds[1]);
+}
+
+static Task<std::string> echoServer(int listen_fd) {
+    int fd = co_await async_accept(listen_fd, 1s);
+    char buffer[64];
+    std::size_t n = co_await async_read(fd, buffer, 1s);
+    co_await async_write(fd, std::span<const char>(buffer, n), 1s);
+    close_fd(fd);
+    co_return std::string(buffer, n);
+}
+
+static Task<std::string> echoClient(sockaddr_in address) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    co_await async_connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address), 1s);
+    co_await async_write(fd, std::string_view("ping"), 1s);
+    char buffer[64];
+    std::string result;
+    for (;;) {
+        std::size_t n = co_await async_read(fd, buffer, 1s);
+        if (n == 0) {
+            break;
+        }
+        result.append(buffer, n);
+    }
+    close_fd(fd);
+    co_return result;
+}
+
+static Task<int> echo(int listen_fd, sockaddr_in address) {
+    auto [request, response] = co_await when_all(echoServer(listen_fd), echoClient(address));
+    EXPECT_EQ(request, "ping");
+    EXPECT_EQ(response, "ping");
+    co_return static_cast<int>(response.size());
+}
+
+TEST(IoLoopTest, TcpEcho) {
+    int listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ASSERT_GE(listen_fd, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), length), 0);
+    ASSERT_EQ(::listen(listen_fd, 16), 0);
+    ASSERT_EQ(::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &length), 0);
+
+    auto task = echo(listen_fd, address);
+    task.coroutine_.resume();
+    IoLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 4);
+    EXPECT_EQ(IoLoop::GetInstance().waiterCount(), 0);
+    close_fd(listen_fd);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,233 @@
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "co_async/async_event.h"
+#include "co_async/schedule.h"
+#include "co_async/scheduler.h"
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+#include "co_async/when_all.h"
+#include "co_async/when_any.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+static Task<int> square(Scheduler& scheduler, int value) {
+    co_await schedule_on(scheduler);
+    EXPECT_TRUE(scheduler.inWorkerThread());
+    co_return value * value;
+}
+
+TEST(SchedulerTest, SyncWait) {
+    Scheduler scheduler(2);
+    EXPECT_FALSE(scheduler.inWorkerThread());
+    EXPECT_EQ(sync_wait(scheduler, square(scheduler, 7)), 49);
+}
+
+/// @brief 子任务在工作线程上阻塞, 只有分散到多个线程才能在一个子任务的时间内全部完成
+static Task<std::thread::id> blockingWork(Scheduler& scheduler) {
+    co_await schedule_on(scheduler);
+    std::this_thread::sleep_for(50ms);
+    co_return std::this_thread::get_id();
+}
+
+static Task<std::set<std::thread::id>> fanOut(Scheduler& scheduler) {
+    auto [a, b, c, d] = co_await when_all(blockingWork(scheduler), blockingWork(scheduler),
+                                          blockingWork(scheduler), blockingWork(scheduler));
+    co_return std::set<std::thread::id>{a, b, c, d};
+}
+
+TEST(SchedulerTest, WhenAllFanOut) {
+    Scheduler scheduler(4);
+    Timer timer;
+    auto thread_ids = sync_wait(scheduler, fanOut(scheduler));
+    EXPECT_EQ(thread_ids.size(), 4);
+    EXPECT_LT(timer.elapsed(), 150ms);
+}
+
+static Task<int> nested(Scheduler& scheduler, int depth) {
+    co_await schedule_on(scheduler);
+    if (depth == 0) {
+        co_return 1;
+    }
+    auto [left, right] = co_await when_all(nested(scheduler, depth - 1), nested(scheduler, depth - 1));
+    co_return left + right;
+}
+
+TEST(SchedulerTest, NestedWhenAll) {
+    Scheduler scheduler(4);
+    EXPECT_EQ(sync_wait(scheduler, nested(scheduler, 10)), 1024);
+}
+
+static Task<int> fail(Scheduler& scheduler) {
+    co_await schedule_on(scheduler);
+    throw std::runtime_error("fail");
+    co_return 0;
+}
+
+TEST(SchedulerTest, WhenAllException) {
+    Scheduler scheduler(4);
+    auto task = [](Scheduler& scheduler) -> Task<int> {
+        auto [a, b, c] = co_await when_all(square(scheduler, 1), fail(scheduler), square(scheduler, 3));
+        co_return a + b + c;
+    };
+    EXPECT_THROW(sync_wait(scheduler, task(scheduler)), std::runtime_error);
+}
+
+/// @brief 等待永远不会设置的事件, 只能被 when_any 取消
+static Task<int> never(AsyncEvent& event, bool& cancelled) {
+    try {
+        co_await event.wait();
+    } catch (const OperationCancelled&) {
+        cancelled = true;
+        throw;
+    }
+    co_return -1;
+}
+
+TEST(SchedulerTest, WhenAny) {
+    Scheduler scheduler(4);
+    auto task = [](Scheduler& scheduler) -> Task<int> {
+        AsyncEvent event;
+        bool cancelled = false;
+        auto var = co_await when_any(never(event, cancelled), square(scheduler, 5));
+        EXPECT_EQ(var.index(), 1);
+        // 未胜出的分支结束后才恢复父协程
+        EXPECT_TRUE(cancelled);
+        co_return std::get<1>(var);
+    };
+    EXPECT_EQ(sync_wait(scheduler, task(scheduler)), 25);
+}
+
+static Task<int> sleepUntilCancelled(std::thread::id& cancelled_on) {
+    try {
+        co_await sleep_for(10s);
+    } catch (const OperationCancelled&) {
+        cancelled_on = std::this_thread::get_id();
+        throw;
+    }
+    co_return -1;
+}
+
+static DetachedTask raceSleep(Scheduler& scheduler, int& result, std::thread::id& cancelled_on,
+                              std::latch& done) {
+    auto var = co_await when_any(sleepUntilCancelled(cancelled_on), square(scheduler, 5));
+    result = std::get<1>(var);
+    done.count_down();
+}
+
+TEST(SchedulerTest, WhenAnyCancelsSleep) {
+    Scheduler scheduler(2);
+    int result = 0;
+    std::thread::id cancelled_on;
+    std::latch done(1);
+    Timer timer;
+    raceSleep(scheduler, result, cancelled_on, done);
+    // 胜出者在工作线程上完成, 定时器只在运行 TimerLoop 的本线程上被取消
+    TimerLoop::GetInstance().runAll();
+    done.wait();
+    EXPECT_LT(timer.elapsed(), 1s);
+    EXPECT_EQ(cancelled_on, std::this_thread::get_id());
+    EXPECT_EQ(result, 25);
+}
+
+TEST(SchedulerTest, SleepOnWorker) {
+    // 工作线程上的 sleep 由运行 TimerLoop 的本线程登记和恢复, 之后再回到调度器
+    constexpr int kTaskCount = 100;
+    Scheduler scheduler(4);
+    std::atomic<int> resumed_on_loop{0};
+    std::atomic<int> back_on_worker{0};
+    std::latch done(kTaskCount);
+    const auto loop_thread = std::this_thread::get_id();
+    for (int i = 0; i < kTaskCount; i++) {
+        spawn(scheduler, [&, i]() -> Task<void> {
+            co_await sleep_for(std::chrono::milliseconds(i % 10 + 1));
+            if (std::this_thread::get_id() == loop_thread) {
+                resumed_on_loop.fetch_add(1, std::memory_order_relaxed);
+            }
+            co_await schedule_on(scheduler);
+            if (scheduler.inWorkerThread()) {
+                back_on_worker.fetch_add(1, std::memory_order_relaxed);
+            }
+            done.count_down();
+        });
+    }
+    Timer timer;
+    while (!done.try_wait() && timer.elapsed() < 5s) {
+        TimerLoop::GetInstance().runAll();
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_TRUE(done.try_wait());
+    EXPECT_EQ(resumed_on_loop.load(), kTaskCount);
+    EXPECT_EQ(back_on_worker.load(), kTaskCount);
+}
+
+static Task<int> waitEvent(AsyncEvent& event) {
+    co_await event.wait();
+    co_return 1;
+}
+
+static Task<int> setEvent(Scheduler& scheduler, AsyncEvent& event) {
+    co_await schedule_on(scheduler);
+    event.set();
+    co_return 0;
+}
+
+TEST(SchedulerTest, WhenAnyRacesWithWakeup) {
+    // 胜出者请求取消的同时其他线程唤醒同一个等待者, 等待者只被恢复一次
+    Scheduler scheduler(4);
+    auto task = [](Scheduler& scheduler) -> Task<int> {
+        int total = 0;
+        for (int i = 0; i < 1000; i++) {
+            AsyncEvent event;
+            auto [var, _] =
+                co_await when_all(when_any(waitEvent(event), square(scheduler, 1)), setEvent(scheduler, event));
+            total += var.index() == 0 ? std::get<0>(var) : std::get<1>(var);
+        }
+        co_return total;
+    };
+    EXPECT_EQ(sync_wait(scheduler, task(scheduler)), 1000);
+}
+
+TEST(SchedulerTest, Spawn) {
+    constexpr int kTaskCount = 1000;
+    Scheduler scheduler(4);
+    std::atomic<int> sum{0};
+    std::latch done(kTaskCount);
+    for (int i = 0; i < kTaskCount; i++) {
+        spawn(scheduler, [&sum, &done, i]() -> Task<void> {
+            sum.fetch_add(i, std::memory_order_relaxed);
+            done.count_down();
+            co_return;
+        });
+    }
+    done.wait();
+    EXPECT_EQ(sum.load(), kTaskCount * (kTaskCount - 1) / 2);
+}
+
+TEST(SchedulerTest, ShutdownDrains) {
+    std::atomic<int> count{0};
+    {
+        Scheduler scheduler(2);
+        for (int i = 0; i < 100; i++) {
+            spawn(scheduler, [&count]() -> Task<void> {
+                count.fetch_add(1, std::memory_order_relaxed);
+                co_return;
+            });
+        }
+    }
+    EXPECT_EQ(count.load(), 100);
+}
+
+}  // namespace co_async
+}  // namespace pyc
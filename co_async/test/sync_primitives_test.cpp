@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <latch>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "co_async/async_event.h"
+#include "co_async/async_mutex.h"
+#include "co_async/async_semaphore.h"
+#include "co_async/schedule.h"
+#include "co_async/scheduler.h"
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+#include "co_async/when_all.h"
+#include "co_async/when_any.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+static Task<int> holdLock(AsyncMutex& mutex, std::vector<int>& order, int id) {
+    auto guard = co_await mutex.scopedLock();
+    order.push_back(id);
+    co_await sleep_for(50ms);
+    order.push_back(id);
+    co_return id;
+}
+
+static Task<int> lockInOrder() {
+    AsyncMutex mutex;
+    std::vector<int> order;
+    Timer timer;
+    co_await when_all(holdLock(mutex, order, 1), holdLock(mutex, order, 2), holdLock(mutex, order, 3));
+    EXPECT_GE(timer.elapsed(), 150ms);
+    EXPECT_LT(timer.elapsed(), 200ms);
+    // 持有锁期间其他协程不会进入临界区, 并按等待顺序获取锁
+    EXPECT_EQ(order, (std::vector<int>{1, 1, 2, 2, 3, 3}));
+    EXPECT_TRUE(mutex.tryLock());
+    mutex.unlock();
+    co_return static_cast<int>(order.size());
+}
+
+TEST(AsyncMutexTest, Basic) {
+    auto task = lockInOrder();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 6);
+}
+
+TEST(AsyncMutexTest, MultiThread) {
+    constexpr int kTaskCount = 200;
+    constexpr int kIncrements = 100;
+    Scheduler scheduler(4);
+    AsyncMutex mutex;
+    int counter = 0;  // 只在持有 mutex 时访问
+    std::latch done(kTaskCount);
+    for (int i = 0; i < kTaskCount; i++) {
+        spawn(scheduler, [&]() -> Task<void> {
+            for (int j = 0; j < kIncrements; j++) {
+                co_await mutex.lock();
+                counter++;
+                mutex.unlock();
+                co_await schedule_on(scheduler);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    EXPECT_EQ(counter, kTaskCount * kIncrements);
+}
+
+static Task<int> useSemaphore(AsyncSemaphore& semaphore, std::atomic<int>& active, int& peak) {
+    co_await semaphore.acquire();
+    peak = std::max(peak, ++active);
+    co_await sleep_for(50ms);
+    --active;
+    semaphore.release();
+    co_return 0;
+}
+
+static Task<int> limitConcurrency() {
+    AsyncSemaphore semaphore(2);
+    std::atomic<int> active{0};
+    int peak = 0;
+    Timer timer;
+    co_await when_all(useSemaphore(semaphore, active, peak), useSemaphore(semaphore, active, peak),
+                      useSemaphore(semaphore, active, peak), useSemaphore(semaphore, active, peak));
+    EXPECT_GE(timer.elapsed(), 100ms);
+    EXPECT_LT(timer.elapsed(), 150ms);
+    EXPECT_EQ(semaphore.available(), 2);
+    co_return peak;
+}
+
+TEST(AsyncSemaphoreTest, Basic) {
+    auto task = limitConcurrency();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 2);
+}
+
+static Task<int> waitEvent(AsyncEvent& event) {
+    co_await event.wait();
+    co_return 1;
+}
+
+static Task<int> setLater(AsyncEvent& event) {
+    co_await sleep_for(100ms);
+    event.set();
+    co_return 0;
+}
+
+static Task<int> eventBroadcast() {
+    AsyncEvent event;
+    Timer timer;
+    auto [a, b, c] = co_await when_all(waitEvent(event), waitEvent(event), setLater(event));
+    EXPECT_ELAPSED_TIME(timer.elapsed(), 100ms);
+    // 已设置的事件不再挂起
+    co_await event.wait();
+    co_return a + b + c;
+}
+
+TEST(AsyncEventTest, Basic) {
+    auto task = eventBroadcast();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 2);
+}
+
+static Task<int> cancelWait() {
+    AsyncEvent event;
+    auto var = co_await when_any(waitEvent(event), [](AsyncEvent&) -> Task<int> {
+        co_await sleep_for(50ms);
+        co_return 2;
+    }(event));
+    // 未胜出的等待者已被取消并退出等待, set 不会恢复它
+    event.set();
+    co_return std::get<1>(var);
+}
+
+TEST(AsyncEventTest, CancelByWhenAny) {
+    auto task = cancelWait();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 2);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -0,0 +1,160 @@
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "co_async/sleep.h"
+#include "co_async/test/utils.h"
+#include "co_async/utils/timing_wheel.h"
+#include "co_async/when_any.h"
+
+using namespace std::chrono_literals;
+
+namespace pyc {
+namespace co_async {
+
+/// @brief 推进到 now_tick 并取出所有到期的定时器, 检查到期时间不晚于 now_tick
+static std::vector<TimerNode*> advanceAndPop(TimingWheel& wheel, std::uint64_t now_tick) {
+    wheel.advance(now_tick);
+    std::vector<TimerNode*> result;
+    while (TimerNode* node = wheel.popExpired()) {
+        EXPECT_LE(node->expire_tick_, now_tick);
+        result.push_back(node);
+    }
+    return result;
+}
+
+TEST(TimingWheelTest, DuplicateDeadline) {
+    TimingWheel wheel;
+    TimerNode nodes[3];
+    for (auto& node : nodes) {
+        node.expire_tick_ = 10;
+        wheel.add(node);
+    }
+    EXPECT_EQ(wheel.size(), 3);
+    EXPECT_EQ(wheel.nextTick(), 10);
+    EXPECT_TRUE(advanceAndPop(wheel, 9).empty());
+    EXPECT_EQ(advanceAndPop(wheel, 10).size(), 3);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, Cancel) {
+    TimingWheel wheel;
+    TimerNode a;
+    TimerNode b;
+    a.expire_tick_ = 5;
+    b.expire_tick_ = 5;
+    wheel.add(a);
+    wheel.add(b);
+    wheel.cancel(a);
+    EXPECT_EQ(wheel.size(), 1);
+    {
+        // 节点析构时自动取消
+        TimerNode c;
+        c.expire_tick_ = 1000;
+        wheel.add(c);
+        EXPECT_EQ(wheel.size(), 2);
+    }
+    EXPECT_EQ(wheel.size(), 1);
+
+    auto expired = advanceAndPop(wheel, 100000);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired[0], &b);
+    EXPECT_EQ(wheel.nextTick(), UINT64_MAX);
+}
+
+TEST(TimingWheelTest, AlreadyExpired) {
+    TimingWheel wheel;
+    wheel.advance(100);
+    TimerNode node;
+    node.expire_tick_ = 50;
+    wheel.add(node);
+    EXPECT_EQ(wheel.nextTick(), 100);
+    EXPECT_EQ(wheel.popExpired(), &node);
+}
+
+TEST(TimingWheelTest, BeyondRange) {
+    TimingWheel wheel;
+    constexpr std::uint64_t kFar = (std::uint64_t{1} << 40) + 12345;
+    TimerNode node;
+    node.expire_tick_ = kFar;
+    wheel.add(node);
+    EXPECT_TRUE(advanceAndPop(wheel, kFar - 1).empty());
+    auto expired = advanceAndPop(wheel, kFar);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired[0]->expire_tick_, kFar);
+}
+
+TEST(TimingWheelTest, RandomDeadlines) {
+    constexpr std::size_t kTimerNum = 100000;
+    TimingWheel wheel;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::uint64_t> distribution(1, 1 << 26);
+    auto nodes = std::make_unique<TimerNode[]>(kTimerNum);
+    for (std::size_t i = 0; i < kTimerNum; i++) {
+        nodes[i].expire_tick_ = distribution(rng);
+        wheel.add(nodes[i]);
+    }
+
+    // 随机步长推进, 每个定时器恰好在到期的那一步取出
+    std::size_t expired_count = 0;
+    std::uint64_t now = 0;
+    std::uniform_int_distribution<std::uint64_t> step(1, 5000);
+    while (!wheel.empty()) {
+        const std::uint64_t previous = now;
+        now += step(rng);
+        for (TimerNode* node : advanceAndPop(wheel, now)) {
+            EXPECT_GT(node->expire_tick_, previous);
+            expired_count++;
+        }
+    }
+    EXPECT_EQ(expired_count, kTimerNum);
+}
+
+static Task<int> sleepAndReturn(int value, std::chrono::milliseconds duration) {
+    co_await sleep_for(duration);
+    co_return value;
+}
+
+TEST(TimerLoopTest, SameDeadline) {
+    // 两个协程的到期时间相同时都能被恢复
+    const auto expire_time = std::chrono::steady_clock::now() + 50ms;
+    auto sleeper = [](std::chrono::steady_clock::time_point time_point) -> Task<int> {
+        co_await sleep_until(time_point);
+        co_return 1;
+    };
+    auto task1 = sleeper(expire_time);
+    auto task2 = sleeper(expire_time);
+    task1.coroutine_.resume();
+    task2.coroutine_.resume();
+    EXPECT_EQ(TimerLoop::GetInstance().timerCount(), 2);
+
+    TimerLoop::GetInstance().runAll();
+    EXPECT_TRUE(task1.coroutine_.done());
+    EXPECT_TRUE(task2.coroutine_.done());
+}
+
+TEST(TimerLoopTest, CancelOnDestroy) {
+    {
+        auto task = sleepAndReturn(1, 1000ms);
+        task.coroutine_.resume();
+        EXPECT_EQ(TimerLoop::GetInstance().timerCount(), 1);
+    }
+    EXPECT_EQ(TimerLoop::GetInstance().timerCount(), 0);
+
+    // when_any 返回后其余分支的定时器被取消, 循环不会等待它们
+    auto task = []() -> Task<int> {
+        auto result = co_await when_any(sleepAndReturn(1, 20ms), sleepAndReturn(2, 1000ms));
+        co_return std::get<0>(result);
+    }();
+    task.coroutine_.resume();
+    Timer timer;
+    TimerLoop::GetInstance().runAll();
+    EXPECT_LT(timer.elapsed(), 500ms);
+    EXPECT_EQ(task.coroutine_.promise().result(), 1);
+}
+
+}  // namespace co_async
+}  // namespace pyc
@@ -61,5 +61,34 @@ TEST(WhenAnyTest, Hello2) {
     EXPECT_EQ(task.coroutine_.promise().result(), 1);
 }
 
+static Task<int> sleepCancelled(std::chrono::milliseconds duration, int& cancelled) {
+    try {
+        co_await sleep_for(duration);
+    } catch (const OperationCancelled&) {
+        cancelled++;
+        throw;
+    }
+    co_return 0;
+}
+
+static Task<int> nestedCancel() {
+    int cancelled = 0;
+    Timer timer;
+    auto var =
+        co_await when_any(when_any(sleepCancelled(10s, cancelled), sleepCancelled(10s, cancelled)), sleep1());
+    EXPECT_LT(timer.elapsed(), 1s);
+    // 父协程恢复时未胜出的分支都已结束, 停止请求转发给了内层 when_any 的子任务
+    EXPECT_EQ(cancelled, 2);
+    co_return static_cast<int>(var.index());
+}
+
+TEST(WhenAnyTest, NestedCancel) {
+    auto task = nestedCancel();
+    task.coroutine_.resume();
+    TimerLoop::GetInstance().runAll();
+
+    EXPECT_EQ(task.coroutine_.promise().result(), 1);
+}
+
 }  // namespace co_async
 }  // namespace pyc
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/channel.h"
+#include "concurrency/channel/bounded_channel.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief range(0) 个生产者各发送 kMessageNum 条消息, range(1) 个消费者接收直到关闭
+template <typename ChannelType>
+void BM_ChannelThroughput(benchmark::State& state) {
+    constexpr std::int64_t kMessageNum = 1 << 16;
+    constexpr std::size_t kCapacity = 1024;
+    const auto kProducerNum = state.range(0);
+    const auto kConsumerNum = state.range(1);
+    for (auto _ : state) {
+        ChannelType ch(kCapacity);
+        std::vector<std::jthread> consumers;
+        for (std::int64_t i = 0; i < kConsumerNum; i++) {
+            consumers.emplace_back([&]() {
+                std::int64_t sum = 0;
+                while (auto value = ch.Receive()) {
+                    sum += *value;
+                }
+                benchmark::DoNotOptimize(sum);
+            });
+        }
+        {
+            std::vector<std::jthread> producers;
+            for (std::int64_t i = 0; i < kProducerNum; i++) {
+                producers.emplace_back([&]() {
+                    for (std::int64_t j = 0; j < kMessageNum; j++) {
+                        ch.Send(j);
+                    }
+                });
+            }
+        }
+        ch.Close();
+    }
+    state.SetItemsProcessed(state.iterations() * kProducerNum * kMessageNum);
+}
+
+/// @brief 单消费者批量接收
+template <typename ChannelType>
+void BM_ChannelBatchReceive(benchmark::State& state) {
+    constexpr std::int64_t kMessageNum = 1 << 16;
+    constexpr std::size_t kCapacity = 1024;
+    constexpr std::size_t kBatchSize = 64;
+    const auto kProducerNum = state.range(0);
+    for (auto _ : state) {
+        ChannelType ch(kCapacity);
+        std::jthread consumer([&]() {
+            std::int64_t buffer[kBatchSize];
+            std::int64_t sum = 0;
+            while (!ch.IsClosed() || ch.Size() > 0) {
+                const std::size_t count = ch.TryReceiveBatch(buffer, kBatchSize);
+                for (std::size_t i = 0; i < count; i++) {
+                    sum += buffer[i];
+                }
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        });
+        {
+            std::vector<std::jthread> producers;
+            for (std::int64_t i = 0; i < kProducerNum; i++) {
+                producers.emplace_back([&]() {
+                    for (std::int64_t j = 0; j < kMessageNum; j++) {
+                        ch.Send(j);
+                    }
+                });
+            }
+        }
+        ch.Close();
+    }
+    state.SetItemsProcessed(state.iterations() * kProducerNum * kMessageNum);
+}
+
+BENCHMARK_TEMPLATE(BM_ChannelThroughput, Channel<std::int64_t>)
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChannelThroughput, SpscChannel<std::int64_t>)->Args({1, 1})->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChannelThroughput, MpscChannel<std::int64_t>)->Args({1, 1})->Args({4, 1})->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChannelThroughput, MpmcChannel<std::int64_t>)
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChannelBatchReceive, MpscChannel<std::int64_t>)->Arg(1)->Arg(4)->UseRealTime();
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,66 @@
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/thread_pool/executor.h"
+#include "concurrency/thread_pool/thread_pool.h"
+
+namespace pyc {
+namespace concurrency {
+
+constexpr std::int64_t kTaskNum = 10000;
+
+/// @brief 提交 kTaskNum 个空任务并等待全部完成, 每个任务分配 packaged_task 和 future
+void BM_ThreadPoolCommit(benchmark::State& state) {
+    std::vector<std::future<void>> futures;
+    futures.reserve(kTaskNum);
+    for (auto _ : state) {
+        futures.clear();
+        for (std::int64_t i = 0; i < kTaskNum; i++) {
+            futures.push_back(ThreadPool::GetInstance().Commit([]() {}));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTaskNum);
+}
+
+/// @brief 同样的任务通过 Executor::Post 提交, 不需要 future
+void BM_ExecutorPost(benchmark::State& state) {
+    Executor executor(5);
+    std::atomic<std::int64_t> done{0};
+    for (auto _ : state) {
+        done = 0;
+        for (std::int64_t i = 0; i < kTaskNum; i++) {
+            executor.Post([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        while (done.load(std::memory_order_relaxed) != kTaskNum) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kTaskNum);
+}
+
+void BM_ExecutorTaskGroup(benchmark::State& state) {
+    Executor executor(5);
+    for (auto _ : state) {
+        TaskGroup group(executor);
+        for (std::int64_t i = 0; i < kTaskNum; i++) {
+            group.Run([]() {});
+        }
+        group.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kTaskNum);
+}
+
+BENCHMARK(BM_ThreadPoolCommit)->UseRealTime();
+BENCHMARK(BM_ExecutorPost)->UseRealTime();
+BENCHMARK(BM_ExecutorTaskGroup)->UseRealTime();
+
+}  // namespace concurrency
+}  // namespace pyc
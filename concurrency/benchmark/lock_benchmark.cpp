@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/adaptive_mutex.h"
+#include "concurrency/mcs_lock.h"
+#include "concurrency/spin_lock.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 模拟临界区内的工作量
+inline void Work(std::int64_t length, std::uint64_t& value) {
+    for (std::int64_t i = 0; i < length; i++) {
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+/// @brief 所有线程竞争同一把锁, range(0) 为临界区长度, 临界区外做同等长度的私有工作
+template <typename Lock>
+void BM_LockContention(benchmark::State& state) {
+    static Lock lock;
+    static std::uint64_t shared_value = 0;
+    const std::int64_t kLength = state.range(0);
+    std::uint64_t local_value = static_cast<std::uint64_t>(state.thread_index());
+    for (auto _ : state) {
+        {
+            std::lock_guard<Lock> guard(lock);
+            Work(kLength, shared_value);
+        }
+        Work(kLength, local_value);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define LOCK_BENCHMARK(Lock)                    \
+    BENCHMARK_TEMPLATE(BM_LockContention, Lock) \
+        ->ArgName("cs")                         \
+        ->Arg(0)                                \
+        ->Arg(16)                               \
+        ->Arg(256)                              \
+        ->Arg(4096)                             \
+        ->ThreadRange(1, 16)                    \
+        ->UseRealTime()
+
+LOCK_BENCHMARK(std::mutex);
+LOCK_BENCHMARK(SpinLock);
+LOCK_BENCHMARK(McsLock);
+LOCK_BENCHMARK(AdaptiveMutex);
+
+}  // namespace concurrency
+}  // namespace pyc
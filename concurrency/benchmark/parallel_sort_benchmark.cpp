@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "concurrency/parallel_sort.h"
+
+namespace pyc {
+namespace concurrency {
+
+std::vector<std::uint64_t> RandomKeys(std::size_t length) {
+    std::mt19937_64 engine(42);
+    std::vector<std::uint64_t> keys(length);
+    for (auto& key : keys) {
+        key = engine();
+    }
+    return keys;
+}
+
+template <typename SortFunction>
+void RunSortBenchmark(benchmark::State& state, SortFunction sort) {
+    const auto kLength = static_cast<std::size_t>(state.range(0));
+    const auto keys = RandomKeys(kLength);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto data = keys;
+        state.ResumeTiming();
+        sort(data);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kLength));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(kLength * sizeof(std::uint64_t)));
+}
+
+void BM_StdSort(benchmark::State& state) {
+    RunSortBenchmark(state, [](auto& data) { std::sort(data.begin(), data.end()); });
+}
+
+void BM_ParallelSort(benchmark::State& state) {
+    RunSortBenchmark(state, [](auto& data) { ParallelSort(data.begin(), data.end()); });
+}
+
+// 1M / 4M / 16M / 32M 个 64 位整数
+BENCHMARK(BM_StdSort)->RangeMultiplier(4)->Range(1 << 20, 1 << 24)->Arg(1 << 25)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelSort)
+    ->RangeMultiplier(4)
+    ->Range(1 << 20, 1 << 24)
+    ->Arg(1 << 25)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/noncopyable.h"
+#include "concurrency/backoff.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 先自旋后休眠的互斥锁
+/// 短临界区下短暂自旋即可拿到锁, 避免进入内核; 自旋失败后通过 std::atomic::wait 休眠
+/// (Linux 上即 futex), 解锁时仅在确有等待者时才唤醒, 无竞争时加解锁各只有一次原子操作
+class AdaptiveMutex : public Noncopyable {
+public:
+    static constexpr int kSpinCount = 100;
+
+    void Lock() {
+        std::uint32_t state = kUnlocked;
+        if (state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+
+        // 1. 自旋等待, 只读不写, 锁被释放时再尝试获取
+        for (int i = 0; i < kSpinCount; i++) {
+            CpuRelax();
+            state = state_.load(std::memory_order_relaxed);
+            if (state == kUnlocked && state_.compare_exchange_weak(state, kLocked, std::memory_order_acquire,
+                                                                   std::memory_order_relaxed)) {
+                return;
+            }
+            if (state == kContended) {
+                break;
+            }
+        }
+
+        // 2. 标记存在等待者后休眠, 被唤醒时以 kContended 状态获取锁, 保证解锁时会唤醒其余等待者
+        while (state_.exchange(kContended, std::memory_order_acquire) != kUnlocked) {
+            state_.wait(kContended, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryLock() {
+        std::uint32_t state = kUnlocked;
+        return state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void Unlock() {
+        if (state_.exchange(kUnlocked, std::memory_order_release) == kContended) {
+            state_.notify_one();
+        }
+    }
+
+    // 满足 Lockable 要求, 可用于 std::lock_guard / std::unique_lock
+    void lock() { Lock(); }
+    bool try_lock() { return TryLock(); }
+    void unlock() { Unlock(); }
+
+private:
+    static constexpr std::uint32_t kUnlocked = 0;
+    static constexpr std::uint32_t kLocked = 1;     // 已加锁, 没有等待者
+    static constexpr std::uint32_t kContended = 2;  // 已加锁, 可能有等待者
+
+    std::atomic<std::uint32_t> state_{kUnlocked};
+};
+
+}  // namespace concurrency
+}  // namespace pyc
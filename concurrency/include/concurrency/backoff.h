@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 自旋等待提示, 降低自旋时的功耗并让出超线程的执行资源
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// @brief 指数退避, 每次等待的 pause 次数翻倍, 超过上限后改为让出时间片
+class Backoff {
+public:
+    static constexpr std::uint32_t kMaxSpin = 1 << 10;
+
+    explicit Backoff(std::uint32_t max_spin = kMaxSpin) : max_spin_(max_spin) {}
+
+    void Pause() {
+        if (spin_ <= max_spin_) {
+            for (std::uint32_t i = 0; i < spin_; i++) {
+                CpuRelax();
+            }
+            spin_ <<= 1;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void Reset() { spin_ = 1; }
+
+private:
+    const std::uint32_t max_spin_;
+    std::uint32_t spin_{1};
+};
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "common/noncopyable.h"
+#include "concurrency/backoff.h"
+#include "concurrency/channel/ring_buffer.h"
+#include "concurrency/event_count.h"
+
+namespace pyc {
+namespace concurrency {
+
+enum class ChannelMode {
+    kSpsc,  // 单生产者单消费者
+    kMpsc,  // 多生产者单消费者
+    kMpmc,  // 多生产者多消费者
+};
+
+/// @brief 基于无锁环形缓冲区的有界 channel
+/// - 收发都不加锁, 只有缓冲区空 (接收) 或满 (发送) 且自旋 kSpinCount 次仍未就绪时才休眠
+/// - 休眠基于 EventCount (futex), 没有等待者时通知只有一次 fence 和一次读取, 不会进入内核
+/// - 与 Go 相同, Close 应由生产者在停止发送后调用, 之后 Send 返回 false, 接收端取完剩余消息后返回空
+/// 与 Channel 相比, 接收时移动而非复制元素, 且不存在无缓冲模式 (容量至少为 2)
+template <typename T, ChannelMode Mode = ChannelMode::kMpmc>
+class BoundedChannel : public Noncopyable {
+public:
+    static constexpr int kSpinCount = 64;  // 休眠前的自旋重试次数
+
+    explicit BoundedChannel(std::size_t capacity) : buffer_(capacity) {}
+
+    /// @brief 缓冲区满或已关闭时立即返回 false
+    template <typename... Args>
+    bool TrySend(Args&&... args) {
+        if (closed_.load(std::memory_order_relaxed) || !buffer_.TryEmplace(std::forward<Args>(args)...)) {
+            return false;
+        }
+        NotifyReceivers();
+        return true;
+    }
+
+    /// @brief 缓冲区满时阻塞, 已关闭时返回 false
+    template <typename... Args>
+    bool Send(Args&&... args) {
+        bool sent = false;
+        // 发送失败时 TryEmplace 不会消耗参数, 可以重复转发
+        SpinThenWait(not_full_, [&]() {
+            sent = !closed_.load(std::memory_order_relaxed) && buffer_.TryEmplace(std::forward<Args>(args)...);
+            return sent || closed_.load(std::memory_order_relaxed);
+        });
+        if (sent) {
+            NotifyReceivers();
+        }
+        return sent;
+    }
+
+    /// @brief 缓冲区空时立即返回空
+    std::optional<T> TryReceive() {
+        std::optional<T> result;
+        if (PopTo(result)) {
+            not_full_.Notify();
+        }
+        return result;
+    }
+
+    /// @brief 缓冲区空时阻塞, 已关闭且没有剩余消息时返回空
+    std::optional<T> Receive() {
+        std::optional<T> result;
+        SpinThenWait(not_empty_, [&]() {
+            if (PopTo(result)) {
+                return true;
+            }
+            if (!closed_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            // 关闭前发送的消息一定可见, 再取一次避免遗漏
+            PopTo(result);
+            return true;
+        });
+        if (result) {
+            not_full_.Notify();
+        }
+        return result;
+    }
+
+    /// @brief 不阻塞地取出最多 max_count 个消息写入 out, 返回取出的数量
+    /// 批量取出时只通知一次生产者
+    template <typename OutputIt>
+    std::size_t TryReceiveBatch(OutputIt out, std::size_t max_count) {
+        std::size_t count = 0;
+        while (count < max_count && buffer_.TryPop([&](T&& value) { *out++ = std::move(value); })) {
+            count++;
+        }
+        if (count > 0) {
+            not_full_.Notify();
+        }
+        return count;
+    }
+
+    void Close() {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.Notify();
+        not_full_.Notify();
+        NotifySelectors();
+    }
+
+    bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+    /// @brief 近似消息数量
+    std::size_t Size() const { return buffer_.Size(); }
+
+    std::size_t Capacity() const { return buffer_.Capacity(); }
+
+    /// @brief 供 Select 注册等待, 有新消息或关闭时通知 selector
+    void AddSelector(EventCount* selector) {
+        std::lock_guard<std::mutex> lock(selectors_mutex_);
+        selectors_.push_back(selector);
+        selector_count_.store(selectors_.size(), std::memory_order_seq_cst);
+    }
+
+    void RemoveSelector(EventCount* selector) {
+        std::lock_guard<std::mutex> lock(selectors_mutex_);
+        selectors_.erase(std::find(selectors_.begin(), selectors_.end(), selector));
+        selector_count_.store(selectors_.size(), std::memory_order_relaxed);
+    }
+
+private:
+    using Buffer = BoundedRingBuffer<T, Mode != ChannelMode::kSpsc, Mode == ChannelMode::kMpmc>;
+
+    bool PopTo(std::optional<T>& result) {
+        return buffer_.TryPop([&](T&& value) { result.emplace(std::move(value)); });
+    }
+
+    /// @brief 先自旋重试, 仍未就绪再登记到 event_count 后休眠, 登记后必须再检查一次避免丢失唤醒
+    template <typename Predicate>
+    static void SpinThenWait(EventCount& event_count, Predicate&& ready) {
+        for (int i = 0; i < kSpinCount; i++) {
+            if (ready()) {
+                return;
+            }
+            CpuRelax();
+        }
+        for (;;) {
+            const std::uint32_t key = event_count.PrepareWait();
+            if (ready()) {
+                return;
+            }
+            event_count.Wait(key);
+        }
+    }
+
+    void NotifyReceivers() {
+        // Notify 中的 fence 同时保证随后读取 selector_count_ 不会错过刚注册的 selector
+        not_empty_.Notify();
+        if (selector_count_.load(std::memory_order_relaxed) != 0) {
+            NotifySelectors();
+        }
+    }
+
+    void NotifySelectors() {
+        std::lock_guard<std::mutex> lock(selectors_mutex_);
+        for (EventCount* selector : selectors_) {
+            selector->Notify();
+        }
+    }
+
+private:
+    Buffer buffer_;
+    std::atomic<bool> closed_{false};
+    EventCount not_empty_;  // 接收者在此等待
+    EventCount not_full_;   // 发送者在此等待
+    std::atomic<std::size_t> selector_count_{0};
+    std::mutex selectors_mutex_;
+    std::vector<EventCount*> selectors_;
+};
+
+template <typename T>
+using SpscChannel = BoundedChannel<T, ChannelMode::kSpsc>;
+
+template <typename T>
+using MpscChannel = BoundedChannel<T, ChannelMode::kMpsc>;
+
+template <typename T>
+using MpmcChannel = BoundedChannel<T, ChannelMode::kMpmc>;
+
+}  // namespace concurrency
+}  // namespace pyc
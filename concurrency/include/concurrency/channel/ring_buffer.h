@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 有界无锁环形缓冲区 (Vyukov), 每个槽位带一个序号, 生产者与消费者只通过槽位序号同步
+/// - 槽位序号 == pos 时可写入, == pos + 1 时可读取, 读取后置为 pos + 容量供下一轮写入
+/// - MultiProducer / MultiConsumer 为 false 时对应一端只有一个线程, 位置直接 store 而不需要 CAS
+/// 容量向上取整为 2 的幂, 写入端和读取端的位置分别独占缓存行
+template <typename T, bool MultiProducer, bool MultiConsumer>
+class BoundedRingBuffer : public Noncopyable {
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* Data() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+public:
+    explicit BoundedRingBuffer(std::size_t capacity)
+        : mask_(RoundUpCapacity(capacity) - 1), cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedRingBuffer() {
+        while (TryPop([](T&&) {})) {
+        }
+    }
+
+    std::size_t Capacity() const { return mask_ + 1; }
+
+    /// @brief 取得空闲槽位后才构造元素, 缓冲区满时不会消耗 args
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if constexpr (MultiProducer) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else {
+                    tail_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief 取出一个元素并以右值传给 consumer, 缓冲区空时返回 false
+    template <typename Consumer>
+    bool TryPop(Consumer&& consumer) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if constexpr (MultiConsumer) {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else {
+                    head_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        T* data = cell->Data();
+        std::forward<Consumer>(consumer)(std::move(*data));
+        data->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief 近似元素数量
+    std::size_t Size() const {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    static std::size_t RoundUpCapacity(std::size_t capacity) {
+        std::size_t result = 2;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+private:
+    const std::size_t mask_;
+    const std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> tail_{0};  // 下一个写入位置
+    alignas(64) std::atomic<std::size_t> head_{0};  // 下一个读取位置
+};
+
+}  // namespace concurrency
+}  // namespace pyc
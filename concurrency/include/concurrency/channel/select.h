@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency/backoff.h"
+#include "concurrency/event_count.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief Select 的一个分支: 从 channel 收到消息时调用 handler
+template <typename Channel, typename Handler>
+struct SelectCase {
+    Channel& channel;
+    Handler handler;
+};
+
+template <typename Channel, typename Handler>
+SelectCase<Channel, std::decay_t<Handler>> OnReceive(Channel& channel, Handler&& handler) {
+    return {channel, std::forward<Handler>(handler)};
+}
+
+namespace detail {
+
+template <typename Case>
+bool TrySelectCase(Case& select_case) {
+    auto value = select_case.channel.TryReceive();
+    if (!value) {
+        return false;
+    }
+    std::invoke(select_case.handler, std::move(*value));
+    return true;
+}
+
+/// @brief 从第 start 个分支开始轮流尝试, 每次调用起点不同, 避免总是优先第一个 channel
+template <typename Tuple, std::size_t... I>
+bool TrySelectFrom(Tuple& cases, std::index_sequence<I...>) {
+    constexpr std::size_t kCaseNum = sizeof...(I);
+    thread_local std::size_t next_start = 0;
+    const std::size_t start = next_start++;
+    for (std::size_t k = 0; k < kCaseNum; k++) {
+        const std::size_t index = (start + k) % kCaseNum;
+        bool selected = false;
+        ((I == index && (selected = TrySelectCase(std::get<I>(cases)))), ...);
+        if (selected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Tuple, std::size_t... I>
+bool AllClosed(Tuple& cases, std::index_sequence<I...>) {
+    return (std::get<I>(cases).channel.IsClosed() && ...);
+}
+
+}  // namespace detail
+
+/// @brief 不阻塞地从任意一个有消息的 channel 接收一条消息并调用对应的 handler
+/// @return 调用了 handler 返回 true
+template <typename... Cases>
+bool TrySelect(Cases&&... cases) {
+    auto tuple = std::forward_as_tuple(cases...);
+    return detail::TrySelectFrom(tuple, std::index_sequence_for<Cases...>{});
+}
+
+/// @brief 阻塞直到任意一个 channel 有消息, 接收一条并调用对应的 handler
+/// 先自旋重试, 仍没有消息时向所有 channel 注册同一个 EventCount 后休眠, 任一 channel 收到消息或关闭都会唤醒
+/// @return 所有 channel 都已关闭且没有剩余消息时返回 false
+template <typename... Cases>
+bool Select(Cases&&... cases) {
+    static_assert(sizeof...(Cases) > 0, "Select 至少需要一个分支");
+    constexpr int kSpinCount = 64;
+    constexpr auto kIndices = std::index_sequence_for<Cases...>{};
+
+    auto tuple = std::forward_as_tuple(cases...);
+    // 关闭前发送的消息一定可见, 因此先确认全部关闭再尝试一次, 失败即说明已经取完
+    auto try_select = [&]() -> std::optional<bool> {
+        if (detail::TrySelectFrom(tuple, kIndices)) {
+            return true;
+        }
+        if (detail::AllClosed(tuple, kIndices) && !detail::TrySelectFrom(tuple, kIndices)) {
+            return false;
+        }
+        return std::nullopt;
+    };
+
+    for (int i = 0; i < kSpinCount; i++) {
+        if (auto result = try_select()) {
+            return *result;
+        }
+        CpuRelax();
+    }
+
+    EventCount selector;
+    struct Registration {
+        EventCount& selector;
+        decltype(tuple)& cases;
+
+        Registration(EventCount& _selector, decltype(tuple)& _cases) : selector(_selector), cases(_cases) {
+            std::apply([this](auto&... c) { (c.channel.AddSelector(&selector), ...); }, cases);
+        }
+        // handler 抛出异常时也要注销, 注销后 channel 不会再访问 selector
+        ~Registration() {
+            std::apply([this](auto&... c) { (c.channel.RemoveSelector(&selector), ...); }, cases);
+        }
+    } registration(selector, tuple);
+
+    for (;;) {
+        const std::uint32_t key = selector.PrepareWait();
+        if (auto result = try_select()) {
+            return *result;
+        }
+        selector.Wait(key);
+    }
+}
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 事件计数器, 为无锁数据结构提供 "条件不满足时休眠" 的能力, 休眠基于 std::atomic::wait (Linux 上为 futex)
+/// 等待方:
+///     auto key = ec.PrepareWait();
+///     if (!条件已满足) { ec.Wait(key); }
+/// 通知方: 修改共享状态后调用 Notify, 没有等待者时只有一次 fence 和一次读取.
+/// 通知方取走全部等待者计数后才唤醒, 被唤醒的线程尚未运行时后续通知不会重复进入内核.
+class EventCount : public Noncopyable {
+public:
+    /// @brief 登记为等待者并返回当前纪元, 之后必须再检查一次条件
+    /// 纪元必须在登记之前读取: 若登记被某次通知取走, 该通知的纪元递增一定晚于这里的读取
+    std::uint32_t PrepareWait() {
+        const std::uint32_t key = epoch_.load(std::memory_order_acquire);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return key;
+    }
+
+    /// @brief 如果 PrepareWait 之后没有通知则休眠; 条件已满足时直接放弃等待即可, 至多导致一次多余的唤醒
+    void Wait(std::uint32_t key) { epoch_.wait(key, std::memory_order_acquire); }
+
+    /// @brief 唤醒所有已登记的等待者
+    void Notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0 &&
+            waiters_.exchange(0, std::memory_order_relaxed) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+        }
+    }
+
+private:
+    std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> waiters_{0};
+};
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -5,156 +5,109 @@
 
 #include "common/noncopyable.h"
 #include "concurrency/memory_order.h"
+#include "concurrency/reclamation/hazard_pointer.h"
 
 namespace pyc {
 namespace concurrency {
 
+/// @brief Michael-Scott 无锁队列, 使用风险指针回收出队的哑节点
 template <typename T, bool UseMemoryOrder>
 class LockFreeQueue : public Noncopyable {
     using MemoryOrder = std::conditional_t<UseMemoryOrder, StdMemoryOrder, DefaultMemoryOrder>;
 
-    struct NodeCounter {
-        unsigned internal_count : 30;
-        unsigned external_count : 2;
-    };
-
-    struct Node;
-
-    struct CountedNodePtr {
-        int external_count = 0;
-        Node* ptr = nullptr;
-    };
-
     struct Node {
-        std::atomic<T*> data;
-        std::atomic<NodeCounter> count;
-        std::atomic<CountedNodePtr> next;
-
-        Node(int external_count = 2) {
-            count.store(NodeCounter{0, external_count});
-            next.store(CountedNodePtr{0, nullptr});
-        }
-
-        void ReleaseRef() {
-            NodeCounter old_counter = count.load(MemoryOrder::memory_order_relaxed);
-            NodeCounter new_counter;
-            do {
-                new_counter = old_counter;
-                --new_counter.internal_count;
-            } while (!count.compare_exchange_strong(old_counter, new_counter, MemoryOrder::memory_order_acquire,
-                                                    MemoryOrder::memory_order_relaxed));
-            if (new_counter.internal_count == 0 && new_counter.external_count == 0) {
-                delete this;
-            }
-        }
+        T* data{nullptr};  // 入队时写入, 仅成功将其前驱出队的线程读取
+        std::atomic<Node*> next{nullptr};
     };
 
 public:
-    LockFreeQueue() {
-        CountedNodePtr new_next{1, new Node()};
-        tail_.store(new_next, MemoryOrder::memory_order_relaxed);
-        head_.store(new_next, MemoryOrder::memory_order_relaxed);
+    explicit LockFreeQueue(HazardPointerDomain& domain = HazardPointerDomain::Global()) : domain_(domain) {
+        Node* dummy = new Node();
+        head_.store(dummy, MemoryOrder::memory_order_relaxed);
+        tail_.store(dummy, MemoryOrder::memory_order_relaxed);
     }
 
     ~LockFreeQueue() {
-        while (Pop()) {
+        // 析构时已没有其他线程访问, 直接释放剩余节点
+        Node* node = head_.load(MemoryOrder::memory_order_relaxed);
+        while (node) {
+            Node* next = node->next.load(MemoryOrder::memory_order_relaxed);
+            delete node->data;
+            delete node;
+            node = next;
         }
-        CountedNodePtr old_head = head_.load();
-        delete old_head.ptr;
     }
 
     template <typename... Args>
     void Emplace(Args&&... args) {
         std::unique_ptr<T> new_data(new T(std::forward<Args>(args)...));
-        CountedNodePtr new_next{1, new Node()};
-        CountedNodePtr old_tail = tail_.load();
+        Node* new_node = new Node();
+        new_node->data = new_data.release();
+
+        HazardPointerDomain::Guard guard(domain_);
         for (;;) {
-            IncreaseExternalCount(tail_, old_tail);
-            T* old_data = nullptr;
-            if (old_tail.ptr->data.compare_exchange_strong(old_data, new_data.get())) {
-                CountedNodePtr old_next{};
-                if (!old_tail.ptr->next.compare_exchange_strong(old_next, new_next)) {
-                    delete new_next.ptr;
-                    new_next = old_next;
-                }
-                SetNewTail(old_tail, new_next);
-                new_data.release();
-                break;
-            } else {
-                CountedNodePtr old_next{};
-                if (old_tail.ptr->next.compare_exchange_strong(old_next, new_next)) {
-                    old_next = new_next;
-                    new_next.ptr = new Node();
-                }
-                SetNewTail(old_tail, old_next);
+            // 1. 保护 tail, 之后访问 tail->next 是安全的
+            Node* tail = guard.Protect(tail_);
+            Node* next = tail->next.load(MemoryOrder::memory_order_acquire);
+            if (next) {
+                // 2. tail 落后了, 帮助其他线程推进 tail 后重试
+                tail_.compare_exchange_weak(tail, next, MemoryOrder::memory_order_release,
+                                            MemoryOrder::memory_order_relaxed);
+                continue;
+            }
+
+            // 3. 链接新节点, 成功后尝试推进 tail, 失败也没关系, 其他线程会帮忙推进
+            if (tail->next.compare_exchange_strong(next, new_node, MemoryOrder::memory_order_release,
+                                                   MemoryOrder::memory_order_relaxed)) {
+                tail_.compare_exchange_strong(tail, new_node, MemoryOrder::memory_order_release,
+                                              MemoryOrder::memory_order_relaxed);
+                return;
             }
         }
     }
 
     void Push(const T& data) { Emplace(data); }
 
-    void Push(T&& data) { Emplace(data); }
+    void Push(T&& data) { Emplace(std::move(data)); }
 
     std::unique_ptr<T> Pop() {
-        CountedNodePtr old_head = head_.load(MemoryOrder::memory_order_relaxed);
+        HazardPointerDomain::Guard head_guard(domain_);
+        HazardPointerDomain::Guard next_guard(domain_);
         for (;;) {
-            IncreaseExternalCount(head_, old_head);
-            Node* const ptr = old_head.ptr;
-            if (ptr == tail_.load().ptr) {
-                ptr->ReleaseRef();
-                return {};
+            // 1. 保护 head 和 head->next, head 未变说明 next 仍在队列中, 不会被回收
+            Node* head = head_guard.Protect(head_);
+            Node* next = next_guard.Protect(head->next);
+            if (head != head_.load(MemoryOrder::memory_order_acquire)) {
+                continue;
             }
-            CountedNodePtr next = ptr->next.load();
-            if (head_.compare_exchange_strong(old_head, next)) {
-                T* const res = ptr->data.exchange(nullptr);
-                FreeExternalCount(old_head);
-                return std::unique_ptr<T>(res);
+            if (!next) {
+                return {};
             }
-            ptr->ReleaseRef();
-        }
-    }
-
-private:
-    static void IncreaseExternalCount(std::atomic<CountedNodePtr>& counter, CountedNodePtr& old_counter) {
-        CountedNodePtr new_counter;
-        do {
-            new_counter = old_counter;
-            ++new_counter.external_count;
-        } while (!counter.compare_exchange_strong(old_counter, new_counter, MemoryOrder::memory_order_acquire,
-                                                  MemoryOrder::memory_order_relaxed));
-        old_counter.external_count = new_counter.external_count;
-    }
 
-    static void FreeExternalCount(CountedNodePtr& old_Node_ptr) {
-        Node* const ptr = old_Node_ptr.ptr;
-        const int count_increase = old_Node_ptr.external_count - 2;
-        NodeCounter old_counter = ptr->count.load(MemoryOrder::memory_order_relaxed);
-        NodeCounter new_counter;
-        do {
-            new_counter = old_counter;
-            --new_counter.external_count;
-            new_counter.internal_count += count_increase;
-        } while (!ptr->count.compare_exchange_strong(old_counter, new_counter, MemoryOrder::memory_order_acquire,
-                                                     MemoryOrder::memory_order_relaxed));
-        if (new_counter.internal_count == 0 && new_counter.external_count == 0) {
-            delete ptr;
-        }
-    }
+            // 2. tail 落后于 head 时先帮助推进 tail, 避免 tail 指向被回收的节点
+            Node* tail = tail_.load(MemoryOrder::memory_order_acquire);
+            if (head == tail) {
+                tail_.compare_exchange_weak(tail, next, MemoryOrder::memory_order_release,
+                                            MemoryOrder::memory_order_relaxed);
+                continue;
+            }
 
-    void SetNewTail(CountedNodePtr& old_tail, const CountedNodePtr& new_tail) {
-        Node* const current_tail_ptr = old_tail.ptr;
-        while (!tail_.compare_exchange_weak(old_tail, new_tail) && old_tail.ptr == current_tail_ptr) {
-        }
-        if (old_tail.ptr == current_tail_ptr) {
-            FreeExternalCount(old_tail);
-        } else {
-            current_tail_ptr->ReleaseRef();
+            // 3. next 成为新的哑节点, 旧的哑节点交给风险指针域回收
+            if (head_.compare_exchange_strong(head, next, MemoryOrder::memory_order_acquire,
+                                              MemoryOrder::memory_order_relaxed)) {
+                std::unique_ptr<T> result(next->data);
+                next->data = nullptr;
+                head_guard.Reset();
+                domain_.Retire(head);
+                return result;
+            }
         }
     }
 
 private:
-    std::atomic<CountedNodePtr> head_;
-    std::atomic<CountedNodePtr> tail_;
+    std::atomic<Node*> head_;
+    std::atomic<Node*> tail_;
+    HazardPointerDomain& domain_;
 };
 
 }  // namespace concurrency
@@ -2,51 +2,20 @@
 
 #include <atomic>
 #include <optional>
-#include <thread>
 
 #include "common/allocator_wrapper.h"
 #include "common/noncopyable.h"
+#include "concurrency/reclamation/hazard_pointer.h"
 
 namespace pyc {
 namespace concurrency {
 
-struct HazardPointer {
-    std::atomic<std::thread::id> id;
-    std::atomic<void*> pointer;
-};
-
-constexpr std::size_t kMaxHazardPointer = 100;
-HazardPointer hazard_pointers[kMaxHazardPointer];
-
-class HpOwner : public Noncopyable {
-public:
-    HpOwner() : hp(nullptr) {
-        for (std::size_t i = 0; i < kMaxHazardPointer; i++) {
-            std::thread::id old_id;
-            if (hazard_pointers[i].id.compare_exchange_strong(old_id, std::this_thread::get_id())) {
-                hp = &hazard_pointers[i];
-                break;
-            }
-        }
-
-        if (!hp) {
-            throw std::runtime_error("No hazard pointer available");
-        }
-    }
-
-    ~HpOwner() {
-        hp->pointer.store(nullptr);
-        hp->id.store(std::thread::id());
-    }
-
-    std::atomic<void*>& GetPointer() { return hp->pointer; }
-
-private:
-    HazardPointer* hp;
-};
-
+/// @brief 基于风险指针回收的无锁栈
 template <typename T, typename Allocator = std::allocator<T>>
 class HazardPointerStack : public Noncopyable {
+    // 节点可能在栈析构之后才被回收, 只能使用无状态的分配器
+    static_assert(std::allocator_traits<Allocator>::is_always_equal::value, "Allocator 必须是无状态的");
+
 private:
     struct Node {
         T data;
@@ -56,12 +25,23 @@ private:
         Node(const T& _data) : data(_data) {}
     };
 
+    struct NodeDeleter {
+        void operator()(Node* node) const {
+            std::destroy_at(&node->data);
+            AllocatorWrapper<Node, Allocator>().Deallocate(node);
+        }
+    };
+
 public:
-    HazardPointerStack() = default;
+    explicit HazardPointerStack(HazardPointerDomain& domain = HazardPointerDomain::Global()) : domain_(domain) {}
 
     ~HazardPointerStack() {
-        DeleteNodesWithNoHazards();
-        while (Pop()) {
+        // 析构时已没有其他线程访问, 直接释放剩余节点
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node) {
+            Node* next = node->next;
+            NodeDeleter()(node);
+            node = next;
         }
     }
 
@@ -69,8 +49,9 @@ public:
     void Emplace(Args&&... args) {
         Node* new_node = alloc_.Allocate();
         std::construct_at(&new_node->data, std::forward<Args>(args)...);
-        new_node->next = head_.load();
-        while (!head_.compare_exchange_weak(new_node->next, new_node)) {
+        new_node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(new_node->next, new_node, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
         }
     }
 
@@ -79,92 +60,31 @@ public:
     void Push(T&& value) { Emplace(std::move(value)); }
 
     std::optional<T> Pop() {
-        // 1. 从风险列表中获取一个节点给当前线程
-        std::atomic<void*>& hp = GetHazardPointerForCurrentThread();
-        Node* old_head = head_.load();
-        while (old_head) {
-            Node* temp;
-            do {
-                temp = old_head;
-                hp.store(old_head);
-                old_head = head_.load();
-            }  // 2. 如果 old_head 和 temp 不等说明 head 被其他线程更新了，需重试
-            while (old_head != temp);
-
-            // 3. 将当前 head 更新为 old_head->next, 如不满足则重试
-            if (head_.compare_exchange_weak(old_head, old_head->next)) {
-                // 4一旦更新了 head_ 指针，便将风险指针清零
-                hp.store(nullptr);
-                auto result = std::move(old_head->data);
-                // 5 删除旧有的头节点之前，先核查它是否正被风险指针所指涉
-                if (OutstandingHazardPointersFor(old_head)) {
-                    // 6 延迟删除
-                    ReclaimLater(old_head);
-                } else {
-                    // 7 删除头部节点
-                    alloc_.Deallocate(old_head);
-                }
-                // 8 删除没有风险的节点
-                DeleteNodesWithNoHazards();
-                return result;
+        HazardPointerDomain::Guard guard(domain_);
+        for (;;) {
+            // 1. 将 head 发布为风险指针, 之后访问 old_head->next 是安全的
+            Node* old_head = guard.Protect(head_);
+            if (!old_head) {
+                return {};
             }
-        }
-        return {};
-    }
-
-private:
-    struct DataToReclaim {
-        Node* data;
-        DataToReclaim* next;
-        DataToReclaim(Node* p) : data(p), next(nullptr) {}
-        ~DataToReclaim() = default;  // 资源由 HazardPointerStack 释放
-    };
 
-    std::atomic<void*>& GetHazardPointerForCurrentThread() {
-        thread_local static HpOwner hazard;
-        return hazard.GetPointer();
-    }
-
-    bool OutstandingHazardPointersFor(void* p) {
-        for (std::size_t i = 0; i < kMaxHazardPointer; i++) {
-            if (hazard_pointers[i].pointer.load() == p) {
-                return true;
-            }
-        }
-        return false;
-    }
-
-    void ReclaimLater(Node* old_head) {
-        DataToReclaim* reclaim_node = reclaim_alloc_.Allocate();
-        std::construct_at(&reclaim_node->data, old_head);
-        AddToReclaimList(reclaim_node);
-    }
-
-    void AddToReclaimList(DataToReclaim* reclaim_node) {
-        reclaim_node->next = nodes_to_reclaim.load();
-        while (!nodes_to_reclaim.compare_exchange_weak(reclaim_node->next, reclaim_node)) {
-        }
-    }
-
-    void DeleteNodesWithNoHazards() {
-        DataToReclaim* current = nodes_to_reclaim.exchange(nullptr);
-        while (current) {
-            DataToReclaim* const next = current->next;
-            if (!OutstandingHazardPointersFor(current->data)) {
-                alloc_.Deallocate(current->data);
-                reclaim_alloc_.Deallocate(current);
-            } else {
-                AddToReclaimList(current);
+            // 2. 将当前 head 更新为 old_head->next, 如不满足则重新保护新的 head
+            if (head_.compare_exchange_strong(old_head, old_head->next, std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                // 3. 一旦更新了 head_ 指针, 便将风险指针清零
+                guard.Reset();
+                std::optional<T> result(std::move(old_head->data));
+                // 4. 交给风险指针域, 在没有线程引用后再删除
+                domain_.Retire<Node, NodeDeleter>(old_head);
+                return result;
             }
-            current = next;
         }
     }
 
 private:
     std::atomic<Node*> head_{nullptr};
-    std::atomic<DataToReclaim*> nodes_to_reclaim;
+    HazardPointerDomain& domain_;
     [[no_unique_address]] AllocatorWrapper<Node, Allocator> alloc_;
-    [[no_unique_address]] AllocatorWrapper<DataToReclaim, Allocator> reclaim_alloc_;
 };
 
 }  // namespace concurrency
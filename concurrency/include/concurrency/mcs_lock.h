@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/noncopyable.h"
+#include "concurrency/backoff.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief MCS 队列锁
+/// 等待者按到达顺序排成链表, 每个线程只在自己的节点上自旋, 释放时直接把锁交给后继,
+/// 保证先来先服务, 且一次释放只会让一个等待者的缓存行失效.
+/// 严格的 FIFO 交接要求队首线程正在运行, 线程数超过核数时性能会明显下降
+class McsLock : public Noncopyable {
+public:
+    static constexpr std::uint32_t kMaxSpinBeforeYield = 64;
+
+private:
+    struct alignas(64) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{false};
+    };
+
+    /// @brief 线程本地的空闲节点, 同一线程可以同时持有多把 McsLock
+    class NodeCache {
+    public:
+        Node* Acquire() {
+            if (free_.empty()) {
+                nodes_.push_back(std::make_unique<Node>());
+                return nodes_.back().get();
+            }
+            Node* node = free_.back();
+            free_.pop_back();
+            return node;
+        }
+
+        void Release(Node* node) { free_.push_back(node); }
+
+    private:
+        std::vector<std::unique_ptr<Node>> nodes_;
+        std::vector<Node*> free_;
+    };
+
+public:
+    void Lock() {
+        Node* node = LocalNodes().Acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->locked.store(true, std::memory_order_relaxed);
+
+        // 1. 将自己挂到队尾, 如果之前有等待者, 则在自己的节点上等待前驱交接
+        Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+        if (prev) {
+            prev->next.store(node, std::memory_order_release);
+            // 锁只会交给队首, 队首线程未被调度时所有人都要等待, 因此尽早让出时间片
+            Backoff backoff(kMaxSpinBeforeYield);
+            while (node->locked.load(std::memory_order_acquire)) {
+                backoff.Pause();
+            }
+        }
+        owner_ = node;
+    }
+
+    bool TryLock() {
+        Node* node = LocalNodes().Acquire();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* expected = nullptr;
+        if (tail_.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            owner_ = node;
+            return true;
+        }
+        LocalNodes().Release(node);
+        return false;
+    }
+
+    void Unlock() {
+        Node* node = owner_;
+        Node* next = node->next.load(std::memory_order_acquire);
+        if (!next) {
+            // 2. 没有后继则尝试清空队尾, 失败说明有线程正在入队, 等待它链接上来
+            Node* expected = node;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                LocalNodes().Release(node);
+                return;
+            }
+            while (!(next = node->next.load(std::memory_order_acquire))) {
+                CpuRelax();
+            }
+        }
+        // 3. 直接把锁交给后继
+        next->locked.store(false, std::memory_order_release);
+        LocalNodes().Release(node);
+    }
+
+    // 满足 Lockable 要求, 可用于 std::lock_guard / std::unique_lock
+    void lock() { Lock(); }
+    bool try_lock() { return TryLock(); }
+    void unlock() { Unlock(); }
+
+private:
+    static NodeCache& LocalNodes() {
+        thread_local NodeCache cache;
+        return cache;
+    }
+
+private:
+    std::atomic<Node*> tail_{nullptr};
+    Node* owner_{nullptr};  // 持有锁的线程的节点, 只由持有者读写
+};
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include "concurrency/thread_pool/executor.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 并行算法共用的执行器, 线程数为硬件并发数
+inline Executor& ParallelExecutor() {
+    static Executor executor;
+    return executor;
+}
+
+/// @brief 在 executor 上执行 f(0) ... f(count - 1), 调用线程执行最后一个任务并等待全部完成
+/// 等待期间帮忙执行排队的任务, 因此可以在执行器的工作线程中嵌套调用; 有任务抛出异常时重新抛出第一个异常
+template <typename Function>
+void ParallelInvoke(std::size_t count, Function&& f, Executor& executor = ParallelExecutor()) {
+    if (count == 0) {
+        return;
+    }
+    // 析构时等待全部完成, 调用线程的任务抛出异常时也不会留下仍在引用调用者栈的任务
+    TaskGroup group(executor);
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        group.Run([&f, i]() { f(i); });
+    }
+    f(count - 1);
+    group.Wait();
+}
+
+/// @brief 并行样本排序 (sample sort), 适用于连续存储的随机访问区间
+/// 1. 采样并选出 kBucketPerThread * 线程数 - 1 个分割元素
+/// 2. 每个线程负责一段输入, 统计并记录每个元素所属的桶
+/// 3. 根据各段各桶的计数计算偏移, 并行地将元素移动到缓冲区
+/// 4. 每个桶在缓冲区内独立地用 std::sort (内省排序) 排序后移回原区间
+/// 整个过程只顺序扫描数据两遍, 受内存带宽而非分配器或指针跳转限制.
+/// 元素类型需要可默认构造和可移动.
+template <std::random_access_iterator Iterator, typename Compare = std::less<>>
+void ParallelSort(Iterator first, Iterator last, Compare comp = Compare{}) {
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    constexpr std::size_t kSequentialThreshold = 1 << 15;  // 小于该长度直接使用 std::sort
+    constexpr std::size_t kBucketPerThread = 4;             // 每个线程的桶数, 用于平衡各桶大小差异
+    constexpr std::size_t kOversample = 32;                 // 每个分割元素对应的采样数
+
+    const std::size_t kLength = std::distance(first, last);
+    const std::size_t kThreadNum =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 2u), kLength / kSequentialThreshold);
+    if (kThreadNum < 2) {
+        std::sort(first, last, comp);
+        return;
+    }
+    const std::size_t kBucketNum = kThreadNum * kBucketPerThread;
+
+    // 1. 等间隔采样并排序, 取出分割元素
+    std::vector<ValueType> splitters;
+    {
+        const std::size_t kSampleNum = kBucketNum * kOversample;
+        const std::size_t kStride = kLength / kSampleNum;
+        std::vector<ValueType> samples;
+        samples.reserve(kSampleNum);
+        for (std::size_t i = 0; i < kSampleNum; i++) {
+            samples.push_back(first[i * kStride + (i * 7919) % kStride]);
+        }
+        std::sort(samples.begin(), samples.end(), comp);
+        splitters.reserve(kBucketNum - 1);
+        for (std::size_t i = 1; i < kBucketNum; i++) {
+            splitters.push_back(samples[i * kOversample]);
+        }
+    }
+
+    // 2. 分段统计每个元素所属的桶, 结果保存下来避免第二遍重复比较
+    const std::size_t kBlockSize = (kLength + kThreadNum - 1) / kThreadNum;
+    std::vector<std::uint32_t> bucket_ids(kLength);
+    std::vector<std::size_t> counts(kThreadNum * kBucketNum, 0);  // counts[block * kBucketNum + bucket]
+    ParallelInvoke(kThreadNum, [&](std::size_t block) {
+        const std::size_t kBegin = std::min(block * kBlockSize, kLength);
+        const std::size_t kEnd = std::min(kBegin + kBlockSize, kLength);
+        std::size_t* block_counts = &counts[block * kBucketNum];
+        for (std::size_t i = kBegin; i < kEnd; i++) {
+            const auto bucket = static_cast<std::uint32_t>(
+                std::upper_bound(splitters.begin(), splitters.end(), first[i], comp) - splitters.begin());
+            bucket_ids[i] = bucket;
+            block_counts[bucket]++;
+        }
+    });
+
+    // 3. 计算每段每个桶在缓冲区中的起始位置, 桶之间按顺序排列, 同一个桶内按段的顺序排列
+    std::vector<std::size_t> offsets(kThreadNum * kBucketNum);
+    std::vector<std::size_t> bucket_begin(kBucketNum + 1);
+    {
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < kBucketNum; bucket++) {
+            bucket_begin[bucket] = offset;
+            for (std::size_t block = 0; block < kThreadNum; block++) {
+                offsets[block * kBucketNum + bucket] = offset;
+                offset += counts[block * kBucketNum + bucket];
+            }
+        }
+        bucket_begin[kBucketNum] = offset;
+    }
+
+    std::vector<ValueType> buffer(kLength);
+    ParallelInvoke(kThreadNum, [&](std::size_t block) {
+        const std::size_t kBegin = std::min(block * kBlockSize, kLength);
+        const std::size_t kEnd = std::min(kBegin + kBlockSize, kLength);
+        std::size_t* block_offsets = &offsets[block * kBucketNum];
+        for (std::size_t i = kBegin; i < kEnd; i++) {
+            buffer[block_offsets[bucket_ids[i]]++] = std::move(first[i]);
+        }
+    });
+
+    // 4. 各桶独立排序并移回原区间, 由线程轮流领取桶以平衡负载
+    std::atomic<std::size_t> next_bucket{0};
+    ParallelInvoke(kThreadNum, [&](std::size_t) {
+        for (std::size_t bucket = next_bucket++; bucket < kBucketNum; bucket = next_bucket++) {
+            auto bucket_first = buffer.begin() + bucket_begin[bucket];
+            auto bucket_last = buffer.begin() + bucket_begin[bucket + 1];
+            std::sort(bucket_first, bucket_last, comp);
+            std::move(bucket_first, bucket_last, first + bucket_begin[bucket]);
+        }
+    });
+}
+
+template <std::ranges::random_access_range Range, typename Compare = std::less<>>
+void ParallelSort(Range& range, Compare comp = Compare{}) {
+    ParallelSort(std::ranges::begin(range), std::ranges::end(range), std::move(comp));
+}
+
+}  // namespace concurrency
+}  // namespace pyc
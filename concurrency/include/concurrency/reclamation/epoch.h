@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "common/noncopyable.h"
+#include "concurrency/reclamation/thread_record_list.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 基于纪元 (epoch) 的内存回收域
+/// 线程访问共享数据前进入临界区 (Guard), 记录当时的全局纪元.
+/// 只有当所有处于临界区的线程都观察到当前纪元时, 全局纪元才能推进;
+/// 在纪元 e 退休的节点, 待全局纪元推进到 e + 2 后即不可能再被任何线程引用, 可以安全释放.
+/// 相比风险指针, 读路径只有一次 store 和一次 fence, 但一个长时间停留在临界区的线程会阻塞所有回收.
+class EpochDomain : public Noncopyable {
+public:
+    static constexpr std::size_t kAdvanceInterval = 64;  // 每退休多少个节点尝试推进一次纪元
+
+    using Deleter = void (*)(void*);
+
+private:
+    struct Retired {
+        void* ptr;
+        Deleter deleter;
+        std::uint64_t epoch;
+    };
+
+    struct alignas(64) Record {
+        std::atomic<std::uint64_t> state{0};  // (纪元 << 1) | 是否处于临界区
+        std::atomic<bool> in_use{false};
+        Record* next{nullptr};
+        std::size_t pin_depth{0};       // 临界区嵌套深度, 仅所属线程访问
+        std::size_t retire_count{0};    // 仅所属线程访问
+        std::deque<Retired> retired{};  // 按纪元递增排列的待回收列表, 仅所属线程访问
+
+        void Release() {
+            pin_depth = 0;
+            state.store(0, std::memory_order_release);
+        }
+    };
+
+public:
+    class Guard;
+
+    EpochDomain() = default;
+
+    /// @brief 域析构时不应再有线程访问其保护的数据, 直接回收所有待回收节点
+    ~EpochDomain() {
+        records_.ForEach([](Record& record) {
+            for (auto& item : record.retired) {
+                item.deleter(item.ptr);
+            }
+            record.retired.clear();
+        });
+    }
+
+    /// @brief 进程内共享的默认域
+    static EpochDomain& Global() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /// @brief 延迟回收 ptr, 调用前 ptr 必须已从数据结构中摘除
+    /// D 需为无状态可默认构造的删除器, 以便节点可以在容器析构后才被回收
+    template <typename T, typename D = std::default_delete<T>>
+    void Retire(T* ptr) {
+        Record& record = records_.Local();
+        record.retired.push_back(
+            {ptr, [](void* p) { D{}(static_cast<T*>(p)); }, global_epoch_.load(std::memory_order_seq_cst)});
+        if (++record.retire_count % kAdvanceInterval == 0) {
+            TryAdvance();
+            Collect(record);
+        }
+    }
+
+    /// @brief 尝试推进纪元并回收当前线程中已安全的节点
+    void Reclaim() {
+        TryAdvance();
+        TryAdvance();
+        Collect(records_.Local());
+    }
+
+    /// @brief 当前线程待回收列表长度
+    std::size_t RetiredCount() { return records_.Local().retired.size(); }
+
+    std::uint64_t Epoch() const { return global_epoch_.load(std::memory_order_acquire); }
+
+private:
+    void Pin(Record& record) {
+        if (record.pin_depth++ == 0) {
+            record.state.store((global_epoch_.load(std::memory_order_relaxed) << 1) | 1,
+                               std::memory_order_relaxed);
+            // 保证其他线程先看到本线程进入临界区, 之后才读取共享数据
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void Unpin(Record& record) {
+        if (--record.pin_depth == 0) {
+            record.state.store(0, std::memory_order_release);
+        }
+    }
+
+    /// @brief 所有处于临界区的线程都已观察到当前纪元时, 纪元加一
+    bool TryAdvance() {
+        std::uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+        bool all_observed = true;
+        records_.ForEach([&](const Record& record) {
+            const std::uint64_t state = record.state.load(std::memory_order_seq_cst);
+            if ((state & 1) && (state >> 1) != epoch) {
+                all_observed = false;
+            }
+        });
+        return all_observed && global_epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void Collect(Record& record) {
+        const std::uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+        while (!record.retired.empty() && record.retired.front().epoch + 2 <= epoch) {
+            // 先出队再释放, 删除器中再次 Retire 不会破坏遍历
+            Retired item = record.retired.front();
+            record.retired.pop_front();
+            item.deleter(item.ptr);
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> global_epoch_{0};
+    ThreadRecordList<Record> records_;
+};
+
+/// @brief 纪元临界区, 存活期间读取到的节点不会被回收
+class EpochDomain::Guard : public Noncopyable {
+public:
+    explicit Guard(EpochDomain& domain = EpochDomain::Global())
+        : domain_(domain), record_(domain.records_.Local()) {
+        domain_.Pin(record_);
+    }
+
+    ~Guard() { domain_.Unpin(record_); }
+
+private:
+    EpochDomain& domain_;
+    Record& record_;
+};
+
+}  // namespace concurrency
+}  // namespace pyc
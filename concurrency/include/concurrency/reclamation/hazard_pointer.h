@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "common/noncopyable.h"
+#include "concurrency/reclamation/thread_record_list.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 风险指针域
+/// 每个线程持有若干风险指针槽位和一个私有的待回收列表, 线程数不设上限.
+/// 待回收列表长度超过阈值 (与风险指针总数成正比) 时才扫描一次全部风险指针,
+/// 扫描代价被均摊到每次 Retire 上, 而不是每次 Pop 都遍历所有线程.
+class HazardPointerDomain : public Noncopyable {
+public:
+    static constexpr std::size_t kSlotsPerThread = 4;     // 每个线程可同时持有的风险指针数量
+    static constexpr std::size_t kMinScanThreshold = 64;  // 触发扫描的最小待回收数量
+
+    using Deleter = void (*)(void*);
+
+private:
+    struct Retired {
+        void* ptr;
+        Deleter deleter;
+    };
+
+    struct alignas(64) Record {
+        std::atomic<void*> slots[kSlotsPerThread]{};
+        std::atomic<bool> in_use{false};
+        Record* next{nullptr};
+        unsigned used_mask{0};          // 已被 Guard 占用的槽位, 仅所属线程访问
+        std::vector<Retired> retired{};  // 待回收列表, 仅所属线程访问
+
+        void Release() {
+            for (auto& slot : slots) {
+                slot.store(nullptr, std::memory_order_release);
+            }
+            used_mask = 0;
+        }
+    };
+
+public:
+    class Guard;
+
+    HazardPointerDomain() = default;
+
+    /// @brief 域析构时不应再有线程访问其保护的数据, 直接回收所有待回收节点
+    ~HazardPointerDomain() {
+        records_.ForEach([](Record& record) {
+            for (auto& item : record.retired) {
+                item.deleter(item.ptr);
+            }
+            record.retired.clear();
+        });
+    }
+
+    /// @brief 进程内共享的默认域
+    static HazardPointerDomain& Global() {
+        static HazardPointerDomain domain;
+        return domain;
+    }
+
+    /// @brief 延迟回收 ptr, 当没有风险指针指向它时使用 D 释放
+    /// D 需为无状态可默认构造的删除器, 以便节点可以在容器析构后才被回收
+    template <typename T, typename D = std::default_delete<T>>
+    void Retire(T* ptr) {
+        Record& record = records_.Local();
+        record.retired.push_back({ptr, [](void* p) { D{}(static_cast<T*>(p)); }});
+        if (record.retired.size() >= ScanThreshold()) {
+            Scan(record);
+        }
+    }
+
+    /// @brief 立即扫描一次, 回收当前线程待回收列表中未被保护的节点
+    void Reclaim() { Scan(records_.Local()); }
+
+    /// @brief 当前线程待回收列表长度
+    std::size_t RetiredCount() { return records_.Local().retired.size(); }
+
+private:
+    std::size_t ScanThreshold() const {
+        return std::max(kMinScanThreshold, 2 * kSlotsPerThread * records_.Size());
+    }
+
+    void Scan(Record& record) {
+        // 1. 收集所有线程当前发布的风险指针
+        std::vector<void*> hazards;
+        hazards.reserve(kSlotsPerThread * records_.Size());
+        records_.ForEach([&](const Record& other) {
+            for (const auto& slot : other.slots) {
+                if (void* p = slot.load(std::memory_order_seq_cst)) {
+                    hazards.push_back(p);
+                }
+            }
+        });
+        std::sort(hazards.begin(), hazards.end());
+
+        // 2. 先取出待回收列表, 删除器中再次 Retire 也不会破坏遍历
+        std::vector<Retired> retired;
+        retired.swap(record.retired);
+        for (auto& item : retired) {
+            if (std::binary_search(hazards.begin(), hazards.end(), item.ptr)) {
+                record.retired.push_back(item);
+            } else {
+                item.deleter(item.ptr);
+            }
+        }
+    }
+
+private:
+    ThreadRecordList<Record> records_;
+};
+
+/// @brief 占用当前线程的一个风险指针槽位, 析构时释放
+class HazardPointerDomain::Guard : public Noncopyable {
+public:
+    explicit Guard(HazardPointerDomain& domain = HazardPointerDomain::Global())
+        : record_(domain.records_.Local()) {
+        for (index_ = 0; index_ < kSlotsPerThread; index_++) {
+            if (!(record_.used_mask & (1u << index_))) {
+                record_.used_mask |= (1u << index_);
+                return;
+            }
+        }
+        throw std::runtime_error("No hazard pointer available");
+    }
+
+    ~Guard() {
+        Reset();
+        record_.used_mask &= ~(1u << index_);
+    }
+
+    /// @brief 读取 source 并发布为风险指针, 直到发布后 source 未被修改, 保证返回的指针在 Reset 前不会被回收
+    template <typename T>
+    T* Protect(const std::atomic<T*>& source) {
+        T* ptr = source.load(std::memory_order_relaxed);
+        for (;;) {
+            Set(ptr);
+            T* current = source.load(std::memory_order_seq_cst);
+            if (current == ptr) {
+                return ptr;
+            }
+            ptr = current;
+        }
+    }
+
+    /// @brief 直接发布风险指针, 调用者需要自行确认 ptr 在发布后仍然有效
+    void Set(const void* ptr) { Slot().store(const_cast<void*>(ptr), std::memory_order_seq_cst); }
+
+    void Reset() { Slot().store(nullptr, std::memory_order_release); }
+
+private:
+    std::atomic<void*>& Slot() { return record_.slots[index_]; }
+
+private:
+    Record& record_;
+    std::size_t index_;
+};
+
+}  // namespace concurrency
+}  // namespace pyc
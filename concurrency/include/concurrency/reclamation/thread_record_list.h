@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/noncopyable.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 线程记录链表, 为每个访问它的线程分配一个 Record, 线程退出后 Record 交还给链表供其他线程复用
+/// Record 需要满足:
+///   - 可默认构造
+///   - 包含 std::atomic<bool> in_use 与 Record* next 成员
+///   - 提供 void Release(), 在所属线程退出时调用, 清理线程相关状态
+template <typename Record>
+class ThreadRecordList : public Noncopyable {
+private:
+    /// @brief Record 链表本体, 由 ThreadRecordList 与各线程的缓存共同持有,
+    /// 保证 ThreadRecordList 先于使用它的线程析构时, 线程退出也不会访问已释放的 Record
+    struct Registry {
+        std::atomic<Record*> head{nullptr};
+        std::atomic<std::size_t> size{0};
+
+        ~Registry() {
+            Record* record = head.load(std::memory_order_acquire);
+            while (record) {
+                Record* next = record->next;
+                delete record;
+                record = next;
+            }
+        }
+    };
+
+    struct LocalEntry {
+        std::shared_ptr<Registry> registry;
+        Record* record;
+    };
+
+    /// @brief 线程本地缓存, 线程退出时交还所有 Record
+    struct LocalCache {
+        std::vector<LocalEntry> entries;
+
+        ~LocalCache() {
+            for (auto& entry : entries) {
+                entry.record->Release();
+                entry.record->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+public:
+    ThreadRecordList() : registry_(std::make_shared<Registry>()) {}
+
+    /// @brief 获取当前线程的 Record, 首次访问时从链表中复用或新建
+    Record& Local() {
+        thread_local LocalCache cache;
+        for (auto& entry : cache.entries) {
+            if (entry.registry.get() == registry_.get()) {
+                return *entry.record;
+            }
+        }
+        Record* record = Acquire();
+        cache.entries.push_back({registry_, record});
+        return *record;
+    }
+
+    /// @brief 遍历所有 Record (包括空闲的), 遍历期间可能有新 Record 加入
+    template <typename Function>
+    void ForEach(Function&& f) const {
+        for (Record* record = registry_->head.load(std::memory_order_acquire); record; record = record->next) {
+            f(*record);
+        }
+    }
+
+    /// @brief 曾经分配过的 Record 数量, 即同时访问过的最大线程数
+    std::size_t Size() const { return registry_->size.load(std::memory_order_relaxed); }
+
+private:
+    Record* Acquire() {
+        // 1. 优先复用已退出线程留下的 Record
+        for (Record* record = registry_->head.load(std::memory_order_acquire); record; record = record->next) {
+            bool expected = false;
+            if (!record->in_use.load(std::memory_order_relaxed) &&
+                record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+
+        // 2. 没有空闲的 Record 则新建并插入链表头部, 链表只增不减, 遍历无需保护
+        Record* record = new Record();
+        record->in_use.store(true, std::memory_order_relaxed);
+        record->next = registry_->head.load(std::memory_order_relaxed);
+        while (!registry_->head.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+        }
+        registry_->size.fetch_add(1, std::memory_order_relaxed);
+        return record;
+    }
+
+private:
+    std::shared_ptr<Registry> registry_;
+};
+
+}  // namespace concurrency
+}  // namespace pyc
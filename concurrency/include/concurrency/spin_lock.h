@@ -2,20 +2,41 @@
 
 #include <atomic>
 
+#include "concurrency/backoff.h"
+
 namespace pyc {
 namespace concurrency {
 
+/// @brief test-and-test-and-set 自旋锁
+/// 等待时只读取锁状态, 缓存行在等待者之间保持共享, 释放后才尝试写入;
+/// 竞争失败时指数退避, 避免大量线程同时抢占同一缓存行
 class SpinLock {
 public:
     void Lock() {
-        while (flag_.test_and_set(std::memory_order_acquire)) {
+        for (;;) {
+            if (!flag_.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+            Backoff backoff;
+            while (flag_.load(std::memory_order_relaxed)) {
+                backoff.Pause();
+            }
         }
     }
 
-    void Unlock() { flag_.clear(std::memory_order_release); }
+    bool TryLock() {
+        return !flag_.load(std::memory_order_relaxed) && !flag_.exchange(true, std::memory_order_acquire);
+    }
+
+    void Unlock() { flag_.store(false, std::memory_order_release); }
+
+    // 满足 Lockable 要求, 可用于 std::lock_guard / std::unique_lock
+    void lock() { Lock(); }
+    bool try_lock() { return TryLock(); }
+    void unlock() { Unlock(); }
 
 private:
-    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+    std::atomic<bool> flag_{false};
 };
 
 }  // namespace concurrency
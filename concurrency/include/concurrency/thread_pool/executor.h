@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/noncopyable.h"
+#include "concurrency/thread_pool/task.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 任务优先级, 工作线程总是先执行高优先级队列中的任务
+enum class TaskPriority : std::uint8_t {
+    kHigh,
+    kNormal,
+    kLow,
+};
+
+inline constexpr std::size_t kTaskPriorityCount = 3;
+
+/// @brief 执行器运行指标快照, 时间单位为纳秒
+struct ExecutorMetrics {
+    std::size_t queue_depth[kTaskPriorityCount]{};  // 按 TaskPriority 索引的排队任务数
+    std::uint64_t submitted{0};
+    std::uint64_t completed{0};
+    std::uint64_t cancelled{0};  // 所属 TaskGroup 已取消而跳过的任务
+    std::uint64_t total_wait_ns{0};
+    std::uint64_t max_wait_ns{0};
+    std::uint64_t total_run_ns{0};
+};
+
+class TaskGroup;
+
+/// @brief 可配置线程数的多优先级执行器
+/// - 每个优先级一条队列, 各自加锁, 不同优先级的提交互不竞争; 严格按优先级调度, 低优先级任务可能被饿死
+/// - Post 提交不需要结果的任务, 任务对象使用小对象优化的 Task, 不分配 std::future 共享状态
+/// - Submit 提交需要结果的任务, 返回 std::future
+/// - 通过 TaskGroup 可以等待或取消一组任务
+/// 与 ThreadPool 不同, Executor 不是单例, 可以按用途分别创建
+class Executor : public Noncopyable {
+    friend class TaskGroup;
+
+public:
+    explicit Executor(std::size_t thread_num = std::thread::hardware_concurrency()) {
+        thread_num = std::max<std::size_t>(thread_num, 1);
+        workers_.reserve(thread_num);
+        for (std::size_t i = 0; i < thread_num; i++) {
+            workers_.emplace_back([this]() { WorkerThread(); });
+        }
+    }
+
+    ~Executor() { Shutdown(); }
+
+    /// @brief 提交不需要结果的任务, 任务不应抛出异常. 已关闭时返回 false
+    template <typename F>
+    bool Post(F&& f, TaskPriority priority = TaskPriority::kNormal) {
+        return Enqueue(Task(std::forward<F>(f)), priority);
+    }
+
+    /// @brief 提交需要结果的任务, 异常通过 future 传递. 已关闭时返回无效的 future
+    template <typename F>
+    auto Submit(F&& f, TaskPriority priority = TaskPriority::kNormal) {
+        using RetType = std::invoke_result_t<std::decay_t<F>&>;
+        std::packaged_task<RetType()> task(std::forward<F>(f));
+        std::future<RetType> result = task.get_future();
+        if (!Enqueue(Task(std::move(task)), priority)) {
+            return std::future<RetType>{};
+        }
+        return result;
+    }
+
+    /// @brief 停止接受新任务, 执行完已排队的任务后回收所有工作线程, 可重复调用, 不能在工作线程中调用
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            stop_.store(true, std::memory_order_seq_cst);
+        }
+        park_cv_.notify_all();
+        // Enqueue 在队列锁内检查 stop_, 依次获取每个队列锁后, 之后的提交都会失败, 已通过检查的提交都已入队
+        for (auto& lane : lanes_) {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+        }
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        // 与 Shutdown 并发提交的任务可能在工作线程退出后才入队, 由调用线程执行
+        while (TryRunOne()) {
+        }
+    }
+
+    std::size_t ThreadCount() const { return workers_.size(); }
+
+    ExecutorMetrics Metrics() const {
+        ExecutorMetrics metrics;
+        for (std::size_t i = 0; i < kTaskPriorityCount; i++) {
+            metrics.queue_depth[i] = lanes_[i].size.load(std::memory_order_relaxed);
+        }
+        metrics.submitted = submitted_.load(std::memory_order_relaxed);
+        metrics.completed = completed_.load(std::memory_order_relaxed);
+        metrics.cancelled = cancelled_.load(std::memory_order_relaxed);
+        metrics.total_wait_ns = total_wait_ns_.load(std::memory_order_relaxed);
+        metrics.max_wait_ns = max_wait_ns_.load(std::memory_order_relaxed);
+        metrics.total_run_ns = total_run_ns_.load(std::memory_order_relaxed);
+        return metrics;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Task task;
+        Clock::time_point enqueue_time;
+    };
+
+    struct alignas(64) Lane {
+        std::mutex mutex;
+        std::deque<Entry> tasks;
+        std::atomic<std::size_t> size{0};  // 供无锁判断是否为空和统计队列长度
+    };
+
+    bool Enqueue(Task task, TaskPriority priority) {
+        if (stop_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        Lane& lane = lanes_[static_cast<std::size_t>(priority)];
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            // 在锁内再次检查, 与 Shutdown 获取队列锁配对, 返回 true 的任务一定会被执行
+            if (stop_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            lane.tasks.push_back({std::move(task), Clock::now()});
+            lane.size.fetch_add(1, std::memory_order_seq_cst);
+        }
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+
+        // 与 WorkerThread 中 idle_ 递增后检查队列配对, 两者都是 seq_cst, 至少有一方能看到对方
+        if (idle_.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(park_mutex_);
+            park_cv_.notify_one();
+        }
+        return true;
+    }
+
+    bool HasTask() const {
+        for (const auto& lane : lanes_) {
+            if (lane.size.load(std::memory_order_seq_cst) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief 按优先级取出并执行一个任务, 没有任务时返回 false
+    bool TryRunOne() {
+        for (auto& lane : lanes_) {
+            if (lane.size.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            Entry entry;
+            {
+                std::lock_guard<std::mutex> lock(lane.mutex);
+                if (lane.tasks.empty()) {
+                    continue;
+                }
+                entry = std::move(lane.tasks.front());
+                lane.tasks.pop_front();
+                lane.size.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            const auto start = Clock::now();
+            entry.task();
+            const auto end = Clock::now();
+
+            const auto wait_ns = static_cast<std::uint64_t>((start - entry.enqueue_time).count());
+            total_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+            total_run_ns_.fetch_add(static_cast<std::uint64_t>((end - start).count()), std::memory_order_relaxed);
+            std::uint64_t max_wait = max_wait_ns_.load(std::memory_order_relaxed);
+            while (wait_ns > max_wait &&
+                   !max_wait_ns_.compare_exchange_weak(max_wait, wait_ns, std::memory_order_relaxed)) {
+            }
+            completed_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerThread() {
+        for (;;) {
+            if (TryRunOne()) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            idle_.fetch_add(1, std::memory_order_seq_cst);
+            park_cv_.wait(lock, [this]() { return HasTask() || stop_.load(std::memory_order_relaxed); });
+            idle_.fetch_sub(1, std::memory_order_relaxed);
+            if (stop_.load(std::memory_order_relaxed) && !HasTask()) {
+                return;
+            }
+        }
+    }
+
+private:
+    Lane lanes_[kTaskPriorityCount];
+    std::atomic<bool> stop_{false};
+    std::atomic<std::size_t> idle_{0};  // 正在休眠或准备休眠的工作线程数
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> completed_{0};
+    std::atomic<std::uint64_t> cancelled_{0};
+    std::atomic<std::uint64_t> total_wait_ns_{0};
+    std::atomic<std::uint64_t> max_wait_ns_{0};
+    std::atomic<std::uint64_t> total_run_ns_{0};
+
+    std::vector<std::thread> workers_;
+};
+
+/// @brief 一组可以整体等待和取消的任务
+/// - Cancel 后尚未开始的任务被跳过, 正在执行的任务可通过 IsCancelled 主动退出
+/// - 任务抛出的第一个异常会取消整组, 并在 Wait 中重新抛出
+/// - Wait 期间会帮忙执行执行器中排队的任务, 因此可以在执行器的工作线程中嵌套使用
+/// 析构时等待所有任务结束
+class TaskGroup : public Noncopyable {
+public:
+    explicit TaskGroup(Executor& executor, TaskPriority priority = TaskPriority::kNormal)
+        : executor_(executor), priority_(priority) {}
+
+    ~TaskGroup() { WaitIdle(); }
+
+    /// @brief 提交任务, 执行器已关闭或组已取消时不会执行
+    template <typename F>
+    void Run(F&& f) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_++;
+        }
+        Task task([this, f = std::forward<F>(f)]() mutable {
+            if (IsCancelled()) {
+                executor_.cancelled_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                try {
+                    f();
+                } catch (...) {
+                    SetException(std::current_exception());
+                }
+            }
+            Done();
+        });
+        if (!executor_.Enqueue(std::move(task), priority_)) {
+            Done();
+        }
+    }
+
+    void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    /// @brief 等待所有已提交的任务结束或被跳过, 有任务抛出异常时重新抛出第一个异常
+    void Wait() {
+        WaitIdle();
+        std::exception_ptr exception;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            exception = std::exchange(exception_, nullptr);
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    void SetException(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!exception_) {
+            exception_ = exception;
+        }
+        Cancel();
+    }
+
+    /// @brief 在锁内通知, 保证等待方返回 (随后可能析构本对象) 时任务已不再访问成员
+    void Done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            cv_.notify_all();
+        }
+    }
+
+    void WaitIdle() {
+        constexpr auto kHelpInterval = std::chrono::milliseconds(1);
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (pending_ != 0) {
+            lock.unlock();
+            const bool helped = executor_.TryRunOne();
+            lock.lock();
+            // 队列为空时休眠, 定期醒来帮忙执行在此期间提交的任务
+            if (!helped) {
+                cv_.wait_for(lock, kHelpInterval, [this]() { return pending_ == 0; });
+            }
+        }
+    }
+
+private:
+    Executor& executor_;
+    const TaskPriority priority_;
+    std::atomic<bool> cancelled_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t pending_{0};
+    std::exception_ptr exception_;
+};
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 只可移动的 void() 任务, 小对象直接存放在内部缓冲区, 避免 std::function 的堆分配和可复制要求
+/// 大小不超过 kInlineSize 且可无异常移动的可调用对象存放在内部, 否则在堆上分配
+class Task {
+public:
+    static constexpr std::size_t kInlineSize = 48;
+
+    Task() = default;
+
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Task> && std::is_invocable_v<std::decay_t<F>&>)
+    Task(F&& f) {
+        using Function = std::decay_t<F>;
+        if constexpr (kFitsInline<Function>) {
+            ::new (storage_) Function(std::forward<F>(f));
+            vtable_ = &kInlineVTable<Function>;
+        } else {
+            ::new (storage_) Function*(new Function(std::forward<F>(f)));
+            vtable_ = &kHeapVTable<Function>;
+        }
+    }
+
+    Task(Task&& other) noexcept { MoveFrom(other); }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    ~Task() { Reset(); }
+
+    void operator()() { vtable_->invoke(storage_); }
+
+    explicit operator bool() const { return vtable_ != nullptr; }
+
+    /// @brief 可调用对象是否存放在内部缓冲区
+    bool IsInline() const { return vtable_ != nullptr && vtable_->is_inline; }
+
+private:
+    struct VTable {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src) noexcept;  // 移动到 dst 并销毁 src 中的对象
+        void (*destroy)(void* storage) noexcept;
+        bool is_inline;
+    };
+
+    template <typename F>
+    static constexpr bool kFitsInline = sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    static F* InlineObject(void* storage) {
+        return std::launder(static_cast<F*>(storage));
+    }
+
+    template <typename F>
+    static F*& HeapObject(void* storage) {
+        return *std::launder(static_cast<F**>(storage));
+    }
+
+    template <typename F>
+    static constexpr VTable kInlineVTable{
+        [](void* storage) { (*InlineObject<F>(storage))(); },
+        [](void* dst, void* src) noexcept {
+            F* object = InlineObject<F>(src);
+            ::new (dst) F(std::move(*object));
+            object->~F();
+        },
+        [](void* storage) noexcept { InlineObject<F>(storage)->~F(); },
+        true,
+    };
+
+    template <typename F>
+    static constexpr VTable kHeapVTable{
+        [](void* storage) { (*HeapObject<F>(storage))(); },
+        [](void* dst, void* src) noexcept { ::new (dst) F*(HeapObject<F>(src)); },
+        [](void* storage) noexcept { delete HeapObject<F>(storage); },
+        false,
+    };
+
+    void MoveFrom(Task& other) noexcept {
+        if (other.vtable_) {
+            other.vtable_->move(storage_, other.storage_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
+        }
+    }
+
+    void Reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy(storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    const VTable* vtable_{nullptr};
+};
+
+}  // namespace concurrency
+}  // namespace pyc
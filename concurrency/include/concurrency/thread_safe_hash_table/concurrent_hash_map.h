@@ -0,0 +1,287 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "common/noncopyable.h"
+#include "concurrency/reclamation/epoch.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 读无锁, 写分段加锁, 可扩容的并发哈希表
+/// - 读操作 (Find/ForEach) 不加锁, 只进入纪元临界区, 节点与桶数组通过纪元回收延迟释放
+/// - 写操作按哈希值低位选取分段锁, 节点创建后不再修改, 更新时以新节点替换旧节点
+/// - 负载因子超过 kMaxLoadFactor 时获取全部分段锁并将桶数组扩大一倍, 读操作不受扩容阻塞
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class ConcurrentHashMap : public Noncopyable {
+public:
+    static constexpr std::size_t kStripeCount = 64;  // 分段锁数量, 需为 2 的幂
+    static constexpr double kMaxLoadFactor = 0.75;
+
+private:
+    struct Node {
+        const std::size_t hash;
+        const Key key;
+        const Value value;
+        std::atomic<Node*> next;
+
+        template <typename K, typename V>
+        Node(std::size_t _hash, K&& _key, V&& _value, Node* _next)
+            : hash(_hash), key(std::forward<K>(_key)), value(std::forward<V>(_value)), next(_next) {}
+    };
+
+    struct Table {
+        const std::size_t mask;  // 桶数量 - 1
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+        explicit Table(std::size_t bucket_count)
+            : mask(bucket_count - 1), buckets(std::make_unique<std::atomic<Node*>[]>(bucket_count)) {}
+
+        std::size_t BucketCount() const { return mask + 1; }
+
+        std::atomic<Node*>& BucketFor(std::size_t hash) { return buckets[hash & mask]; }
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+public:
+    explicit ConcurrentHashMap(std::size_t bucket_count = kStripeCount, const Hash& hasher = Hash{},
+                               const KeyEqual& key_equal = KeyEqual{},
+                               EpochDomain& domain = EpochDomain::Global())
+        : table_(new Table(RoundUpBucketCount(bucket_count))),
+          hasher_(hasher),
+          key_equal_(key_equal),
+          domain_(domain) {}
+
+    ~ConcurrentHashMap() {
+        // 析构时已没有其他线程访问, 直接释放当前桶数组中的节点
+        Table* table = table_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < table->BucketCount(); i++) {
+            Node* node = table->buckets[i].load(std::memory_order_relaxed);
+            while (node) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+        delete table;
+    }
+
+    /// @brief 无锁查找 key 对应的 value
+    std::optional<Value> Find(const Key& key) const {
+        const std::size_t hash = HashOf(key);
+        EpochDomain::Guard guard(domain_);
+        const Node* node = FindNode(table_.load(std::memory_order_acquire), hash, key);
+        if (node) {
+            return node->value;
+        }
+        return {};
+    }
+
+    bool Contains(const Key& key) const {
+        const std::size_t hash = HashOf(key);
+        EpochDomain::Guard guard(domain_);
+        return FindNode(table_.load(std::memory_order_acquire), hash, key) != nullptr;
+    }
+
+    /// @brief 插入或更新 key 对应的 value
+    /// @return 新插入返回 true, 更新已有元素返回 false
+    template <typename V>
+    bool InsertOrAssign(const Key& key, V&& value) {
+        const std::size_t hash = HashOf(key);
+        {
+            std::lock_guard<std::mutex> lock(StripeFor(hash).mutex);
+            Table* table = table_.load(std::memory_order_relaxed);
+            std::atomic<Node*>& bucket = table->BucketFor(hash);
+            auto [link, node] = FindLink(bucket, hash, key);
+            if (node) {
+                // 节点不可变, 用新节点替换旧节点, 正在读取旧节点的线程不受影响
+                Node* replacement =
+                    new Node(hash, key, std::forward<V>(value), node->next.load(std::memory_order_relaxed));
+                link->store(replacement, std::memory_order_release);
+                domain_.Retire(node);
+                return false;
+            }
+            bucket.store(new Node(hash, key, std::forward<V>(value), bucket.load(std::memory_order_relaxed)),
+                         std::memory_order_release);
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        MaybeGrow();
+        return true;
+    }
+
+    /// @brief 删除 key 对应的元素
+    /// @return 元素存在返回 true
+    bool Erase(const Key& key) {
+        const std::size_t hash = HashOf(key);
+        {
+            std::lock_guard<std::mutex> lock(StripeFor(hash).mutex);
+            auto [link, node] = FindLink(table_.load(std::memory_order_relaxed)->BucketFor(hash), hash, key);
+            if (!node) {
+                return false;
+            }
+            link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+            domain_.Retire(node);
+        }
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief key 不存在时使用 f() 的结果插入, 返回 key 对应的 value
+    /// f 在分段锁内调用, 对同一个 key 最多调用一次
+    template <typename Function>
+    Value ComputeIfAbsent(const Key& key, Function&& f) {
+        if (auto value = Find(key)) {
+            return std::move(value.value());
+        }
+
+        const std::size_t hash = HashOf(key);
+        std::optional<Value> result;
+        {
+            std::lock_guard<std::mutex> lock(StripeFor(hash).mutex);
+            std::atomic<Node*>& bucket = table_.load(std::memory_order_relaxed)->BucketFor(hash);
+            auto [link, node] = FindLink(bucket, hash, key);
+            if (node) {
+                return node->value;
+            }
+            Node* new_node =
+                new Node(hash, key, std::forward<Function>(f)(), bucket.load(std::memory_order_relaxed));
+            result.emplace(new_node->value);
+            bucket.store(new_node, std::memory_order_release);
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        MaybeGrow();
+        return std::move(result.value());
+    }
+
+    /// @brief 遍历所有元素, 不加锁, 遍历期间的并发修改可能可见也可能不可见
+    template <typename Function>
+    void ForEach(Function&& f) const {
+        EpochDomain::Guard guard(domain_);
+        const Table* table = table_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < table->BucketCount(); i++) {
+            for (const Node* node = table->buckets[i].load(std::memory_order_acquire); node;
+                 node = node->next.load(std::memory_order_acquire)) {
+                f(node->key, node->value);
+            }
+        }
+    }
+
+    std::unordered_map<Key, Value> GetMap() const {
+        std::unordered_map<Key, Value> result;
+        ForEach([&](const Key& key, const Value& value) { result.emplace(key, value); });
+        return result;
+    }
+
+    std::size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+    std::size_t BucketCount() const {
+        EpochDomain::Guard guard(domain_);
+        return table_.load(std::memory_order_acquire)->BucketCount();
+    }
+
+private:
+    static std::size_t RoundUpBucketCount(std::size_t bucket_count) {
+        std::size_t result = kStripeCount;
+        while (result < bucket_count) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    /// @brief 混合哈希值, 桶与分段锁都使用低位, 避免指针等低位相同的 key 聚集
+    std::size_t HashOf(const Key& key) const {
+        std::size_t hash = hasher_(key);
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    /// @brief 分段锁由哈希值低位决定, 桶数量总是分段数的倍数, 因此同一个桶始终由同一把锁保护
+    Stripe& StripeFor(std::size_t hash) { return stripes_[hash & (kStripeCount - 1)]; }
+
+    const Node* FindNode(const Table* table, std::size_t hash, const Key& key) const {
+        for (const Node* node = table->buckets[hash & table->mask].load(std::memory_order_acquire); node;
+             node = node->next.load(std::memory_order_acquire)) {
+            if (node->hash == hash && key_equal_(node->key, key)) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief 持有分段锁时查找节点, 返回指向该节点的链接和节点本身
+    std::pair<std::atomic<Node*>*, Node*> FindLink(std::atomic<Node*>& bucket, std::size_t hash, const Key& key) {
+        std::atomic<Node*>* link = &bucket;
+        Node* node = link->load(std::memory_order_relaxed);
+        while (node && !(node->hash == hash && key_equal_(node->key, key))) {
+            link = &node->next;
+            node = link->load(std::memory_order_relaxed);
+        }
+        return {link, node};
+    }
+
+    void MaybeGrow() {
+        const std::size_t bucket_count = BucketCount();
+        if (static_cast<double>(Size()) > static_cast<double>(bucket_count) * kMaxLoadFactor) {
+            Rehash(bucket_count * 2);
+        }
+    }
+
+    /// @brief 获取全部分段锁后复制节点到新的桶数组, 旧桶数组和旧节点仍可被正在读取的线程访问, 交给纪元回收
+    void Rehash(std::size_t new_bucket_count) {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(kStripeCount);
+        for (auto& stripe : stripes_) {
+            locks.emplace_back(stripe.mutex);
+        }
+
+        Table* old_table = table_.load(std::memory_order_relaxed);
+        if (old_table->BucketCount() >= new_bucket_count) {
+            // 其他线程已经完成扩容
+            return;
+        }
+
+        Table* new_table = new Table(new_bucket_count);
+        for (std::size_t i = 0; i < old_table->BucketCount(); i++) {
+            for (Node* node = old_table->buckets[i].load(std::memory_order_relaxed); node;
+                 node = node->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*>& bucket = new_table->BucketFor(node->hash);
+                bucket.store(new Node(node->hash, node->key, node->value, bucket.load(std::memory_order_relaxed)),
+                             std::memory_order_relaxed);
+            }
+        }
+        table_.store(new_table, std::memory_order_release);
+
+        // 必须在新桶数组发布之后再退休旧节点, 否则退休时记录的纪元可能早于读线程进入旧桶数组的时间
+        for (std::size_t i = 0; i < old_table->BucketCount(); i++) {
+            Node* node = old_table->buckets[i].load(std::memory_order_relaxed);
+            while (node) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                domain_.Retire(node);
+                node = next;
+            }
+        }
+        domain_.Retire(old_table);
+    }
+
+private:
+    std::atomic<Table*> table_;
+    std::atomic<std::size_t> size_{0};
+    Stripe stripes_[kStripeCount];
+    [[no_unique_address]] Hash hasher_;
+    [[no_unique_address]] KeyEqual key_equal_;
+    EpochDomain& domain_;
+};
+
+}  // namespace concurrency
+}  // namespace pyc
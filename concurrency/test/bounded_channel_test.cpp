@@ -0,0 +1,173 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/channel/bounded_channel.h"
+#include "concurrency/channel/select.h"
+
+namespace pyc {
+namespace concurrency {
+
+using namespace std::literals::chrono_literals;
+
+TEST(BoundedChannelTest, BasicOperation) {
+    MpmcChannel<std::unique_ptr<int>> ch(4);
+    EXPECT_EQ(ch.Capacity(), 4);
+    EXPECT_FALSE(ch.TryReceive());
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ch.TrySend(std::make_unique<int>(i)));
+    }
+    EXPECT_FALSE(ch.TrySend(std::make_unique<int>(4)));
+    EXPECT_EQ(ch.Size(), 4);
+
+    for (int i = 0; i < 4; i++) {
+        auto value = ch.TryReceive();
+        ASSERT_TRUE(value);
+        EXPECT_EQ(**value, i);
+    }
+    EXPECT_FALSE(ch.TryReceive());
+
+    EXPECT_TRUE(ch.Send(std::make_unique<int>(5)));
+    ch.Close();
+    EXPECT_FALSE(ch.Send(std::make_unique<int>(6)));
+    EXPECT_FALSE(ch.TrySend(std::make_unique<int>(6)));
+    // 关闭后仍能取出剩余消息
+    EXPECT_EQ(**ch.Receive(), 5);
+    EXPECT_FALSE(ch.Receive());
+}
+
+TEST(BoundedChannelTest, TryReceiveBatch) {
+    SpscChannel<int> ch(16);
+    for (int i = 0; i < 10; i++) {
+        ch.Send(i);
+    }
+    std::vector<int> result;
+    EXPECT_EQ(ch.TryReceiveBatch(std::back_inserter(result), 4), 4);
+    EXPECT_EQ(ch.TryReceiveBatch(std::back_inserter(result), 100), 6);
+    EXPECT_EQ(ch.TryReceiveBatch(std::back_inserter(result), 100), 0);
+    ASSERT_EQ(result.size(), 10);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(result[i], i);
+    }
+}
+
+TEST(BoundedChannelTest, CloseWakesReceiver) {
+    MpmcChannel<int> ch(4);
+    std::jthread receiver([&]() { EXPECT_FALSE(ch.Receive()); });
+    std::this_thread::sleep_for(10ms);
+    ch.Close();
+}
+
+TEST(BoundedChannelTest, CloseWakesSender) {
+    MpmcChannel<int> ch(2);
+    EXPECT_TRUE(ch.Send(1));
+    EXPECT_TRUE(ch.Send(2));
+    std::jthread sender([&]() { EXPECT_FALSE(ch.Send(3)); });
+    std::this_thread::sleep_for(10ms);
+    ch.Close();
+}
+
+/// @brief kProducerNum 个线程各发送 kDataNum 个数, kConsumerNum 个线程接收直到关闭, 检查每个数恰好收到一次
+template <ChannelMode Mode, std::size_t kProducerNum, std::size_t kConsumerNum>
+void ProducerConsumer() {
+    constexpr std::size_t kDataNum = 20000;
+    BoundedChannel<std::size_t, Mode> ch(64);
+    std::vector<std::atomic<int>> received(kProducerNum * kDataNum);
+
+    std::vector<std::jthread> consumers;
+    for (std::size_t i = 0; i < kConsumerNum; i++) {
+        consumers.emplace_back([&]() {
+            std::size_t last[kProducerNum];
+            std::fill(std::begin(last), std::end(last), 0);
+            while (auto value = ch.Receive()) {
+                received[*value]++;
+                // 同一个生产者的消息按发送顺序到达
+                const std::size_t producer = *value / kDataNum;
+                EXPECT_GE(*value, last[producer]);
+                last[producer] = *value + 1;
+            }
+        });
+    }
+    {
+        std::vector<std::jthread> producers;
+        for (std::size_t i = 0; i < kProducerNum; i++) {
+            producers.emplace_back([&, i]() {
+                for (std::size_t j = 0; j < kDataNum; j++) {
+                    EXPECT_TRUE(ch.Send(i * kDataNum + j));
+                }
+            });
+        }
+    }
+    ch.Close();
+    consumers.clear();
+
+    for (std::size_t i = 0; i < received.size(); i++) {
+        EXPECT_EQ(received[i], 1) << i;
+    }
+}
+
+TEST(BoundedChannelTest, SpscProducerConsumer) { ProducerConsumer<ChannelMode::kSpsc, 1, 1>(); }
+
+TEST(BoundedChannelTest, MpscProducerConsumer) { ProducerConsumer<ChannelMode::kMpsc, 4, 1>(); }
+
+TEST(BoundedChannelTest, MpmcProducerConsumer) { ProducerConsumer<ChannelMode::kMpmc, 4, 4>(); }
+
+TEST(SelectTest, TrySelect) {
+    MpmcChannel<int> ints(4);
+    MpmcChannel<std::string> strings(4);
+    auto on_int = [](int) { FAIL(); };
+    auto on_string = [](std::string value) { EXPECT_EQ(value, "hello"); };
+    EXPECT_FALSE(TrySelect(OnReceive(ints, on_int), OnReceive(strings, on_string)));
+
+    strings.Send("hello");
+    EXPECT_TRUE(TrySelect(OnReceive(ints, on_int), OnReceive(strings, on_string)));
+    EXPECT_FALSE(TrySelect(OnReceive(ints, on_int), OnReceive(strings, on_string)));
+}
+
+TEST(SelectTest, MultipleChannels) {
+    constexpr int kDataNum = 10000;
+    MpscChannel<int> ints(16);
+    SpscChannel<std::string> strings(16);
+
+    std::jthread int_producer([&]() {
+        for (int i = 0; i < kDataNum; i++) {
+            ints.Send(i);
+        }
+        ints.Close();
+    });
+    std::jthread string_producer([&]() {
+        for (int i = 0; i < kDataNum; i++) {
+            strings.Send(std::to_string(i));
+        }
+        strings.Close();
+    });
+
+    int next_int = 0;
+    int next_string = 0;
+    auto on_int = [&](int value) { EXPECT_EQ(value, next_int++); };
+    auto on_string = [&](std::string value) { EXPECT_EQ(value, std::to_string(next_string++)); };
+    while (Select(OnReceive(ints, on_int), OnReceive(strings, on_string))) {
+    }
+    EXPECT_EQ(next_int, kDataNum);
+    EXPECT_EQ(next_string, kDataNum);
+}
+
+TEST(SelectTest, WakeUpOnSend) {
+    MpmcChannel<int> a(4);
+    MpmcChannel<int> b(4);
+    std::jthread sender([&]() {
+        std::this_thread::sleep_for(10ms);
+        b.Send(42);
+    });
+    int received = 0;
+    EXPECT_TRUE(Select(OnReceive(a, [](int) { FAIL(); }), OnReceive(b, [&](int value) { received = value; })));
+    EXPECT_EQ(received, 42);
+}
+
+}  // namespace concurrency
+}  // namespace pyc
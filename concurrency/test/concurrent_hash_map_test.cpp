@@ -0,0 +1,103 @@
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/test/utils.h"
+#include "concurrency/thread_safe_hash_table/concurrent_hash_map.h"
+
+namespace pyc {
+namespace concurrency {
+
+TEST(ConcurrentHashMapTest, BasicOperation) {
+    ConcurrentHashMap<std::string, int> map;
+    EXPECT_FALSE(map.Find("a"));
+
+    EXPECT_TRUE(map.InsertOrAssign("a", 1));
+    EXPECT_FALSE(map.InsertOrAssign("a", 2));
+    EXPECT_EQ(map.Find("a"), 2);
+    EXPECT_TRUE(map.Contains("a"));
+    EXPECT_EQ(map.Size(), 1);
+
+    EXPECT_EQ(map.ComputeIfAbsent("a", []() { return 3; }), 2);
+    EXPECT_EQ(map.ComputeIfAbsent("b", []() { return 3; }), 3);
+    EXPECT_EQ(map.Size(), 2);
+
+    EXPECT_TRUE(map.Erase("a"));
+    EXPECT_FALSE(map.Erase("a"));
+    EXPECT_FALSE(map.Find("a"));
+    EXPECT_EQ(map.Size(), 1);
+}
+
+TEST(ConcurrentHashMapTest, Rehash) {
+    constexpr int kDataNum = 10000;
+    ConcurrentHashMap<int, int> map;
+    const std::size_t initial_bucket_count = map.BucketCount();
+    for (int i = 0; i < kDataNum; i++) {
+        map.InsertOrAssign(i, i * 2);
+    }
+    EXPECT_GT(map.BucketCount(), initial_bucket_count);
+    EXPECT_EQ(map.Size(), kDataNum);
+    for (int i = 0; i < kDataNum; i++) {
+        EXPECT_EQ(map.Find(i), i * 2) << i;
+    }
+}
+
+TEST(ConcurrentHashMapTest, ComputeIfAbsentOnce) {
+    constexpr std::size_t kThreadNum = 8;
+    ConcurrentHashMap<int, int> map;
+    std::atomic<int> call_count{0};
+    MultiThreadExecute(kThreadNum, {[&](std::size_t thread_idx) {
+                           int value = map.ComputeIfAbsent(42, [&]() {
+                               call_count++;
+                               return static_cast<int>(thread_idx);
+                           });
+                           EXPECT_EQ(map.Find(42), value);
+                       }});
+    EXPECT_EQ(call_count, 1);
+}
+
+template <std::size_t kDataNum, std::size_t kThreadNum>
+void AddWhileRemove() {
+    static_assert(kDataNum >= kThreadNum && (kDataNum % kThreadNum == 0), "kDataNum 要能被 kThreadNum 均分");
+
+    // 初始桶数量很小, 插入过程中会多次扩容
+    ConcurrentHashMap<int, std::shared_ptr<MyClass>> table(1);
+    bool check[kDataNum] = {false};
+
+    // 插入 [0, 2kDataNum) 的数据
+    auto add = [&](std::size_t data) {
+        table.InsertOrAssign(static_cast<int>(data), std::make_shared<MyClass>(static_cast<int>(data)));
+    };
+    // 查找并删除 [0, kDataNum) 的数据
+    auto remove = [&](std::size_t data) {
+        auto find_result = table.Find(static_cast<int>(data));
+        if (find_result) {
+            EXPECT_TRUE(table.Erase((*find_result)->data));
+            check[(*find_result)->data] = true;
+        }
+        return find_result.has_value();
+    };
+    PushWhilePop(kDataNum * 2, kDataNum, kThreadNum, add, remove);
+
+    for (std::size_t i = 0; i < kDataNum; i++) {
+        EXPECT_TRUE(check[i]) << i;
+    }
+
+    auto data = table.GetMap();
+    EXPECT_EQ(data.size(), kDataNum);
+    EXPECT_EQ(table.Size(), kDataNum);
+    for (std::size_t i = kDataNum; i < kDataNum * 2; i++) {
+        auto iter = data.find(i);
+        EXPECT_TRUE(iter != data.end());
+        if (iter != data.end()) {
+            EXPECT_EQ(iter->second->data, static_cast<int>(i));
+        }
+    }
+}
+
+TEST(ConcurrentHashMapTest, AddWhileRemoveTest) { AddWhileRemove<5000, 8>(); }
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/thread_pool/executor.h"
+#include "concurrency/thread_pool/task.h"
+
+namespace pyc {
+namespace concurrency {
+
+using namespace std::literals::chrono_literals;
+
+TEST(TaskTest, SmallBufferOptimization) {
+    int value = 0;
+    Task small([&value]() { value++; });
+    EXPECT_TRUE(small.IsInline());
+    small();
+    EXPECT_EQ(value, 1);
+
+    char padding[Task::kInlineSize] = {};
+    Task large([&value, padding]() { value += padding[0] + 1; });
+    EXPECT_FALSE(large.IsInline());
+    large();
+    EXPECT_EQ(value, 2);
+
+    // 只可移动的可调用对象
+    Task move_only([ptr = std::make_unique<int>(40), &value]() { value += *ptr; });
+    Task moved = std::move(move_only);
+    EXPECT_FALSE(move_only);
+    moved();
+    EXPECT_EQ(value, 42);
+
+    large = std::move(moved);
+    EXPECT_TRUE(large.IsInline());
+    large();
+    EXPECT_EQ(value, 82);
+}
+
+TEST(ExecutorTest, PostAndSubmit) {
+    Executor executor(4);
+    EXPECT_EQ(executor.ThreadCount(), 4);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(executor.Post([&count]() { count++; }));
+    }
+    auto future = executor.Submit([]() { return 42; });
+    EXPECT_EQ(future.get(), 42);
+
+    auto failed = executor.Submit([]() -> int { throw std::runtime_error("error"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    executor.Shutdown();
+    EXPECT_EQ(count, 100);
+    EXPECT_FALSE(executor.Post([]() {}));
+    EXPECT_FALSE(executor.Submit([]() {}).valid());
+
+    auto metrics = executor.Metrics();
+    EXPECT_EQ(metrics.submitted, 102);
+    EXPECT_EQ(metrics.completed, 102);
+    for (auto depth : metrics.queue_depth) {
+        EXPECT_EQ(depth, 0);
+    }
+    EXPECT_GE(metrics.total_wait_ns, metrics.max_wait_ns);
+}
+
+TEST(ExecutorTest, PostDuringShutdown) {
+    // 与 Shutdown 并发提交, 返回 true 的任务都会被执行
+    for (int round = 0; round < 20; round++) {
+        std::atomic<int> accepted{0};
+        std::atomic<int> executed{0};
+        std::atomic<bool> started{false};
+        std::vector<std::thread> producers;
+        {
+            Executor executor(2);
+            for (int i = 0; i < 4; i++) {
+                producers.emplace_back([&]() {
+                    started = true;
+                    while (executor.Post([&executed]() { executed++; })) {
+                        accepted++;
+                    }
+                });
+            }
+            while (!started) {
+                std::this_thread::yield();
+            }
+            executor.Shutdown();
+            for (auto& producer : producers) {
+                producer.join();
+            }
+        }
+        EXPECT_EQ(executed.load(), accepted.load());
+    }
+}
+
+TEST(ExecutorTest, Priority) {
+    Executor executor(1);
+    std::atomic<bool> release{false};
+    executor.Post([&release]() { release.wait(false); });
+    // 等待唯一的工作线程被占用
+    while (executor.Metrics().queue_depth[static_cast<std::size_t>(TaskPriority::kNormal)] != 0) {
+        std::this_thread::yield();
+    }
+
+    std::mutex mutex;
+    std::vector<TaskPriority> order;
+    for (auto priority : {TaskPriority::kLow, TaskPriority::kNormal, TaskPriority::kHigh}) {
+        executor.Post(
+            [&, priority]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(priority);
+            },
+            priority);
+    }
+    EXPECT_EQ(executor.Metrics().queue_depth[static_cast<std::size_t>(TaskPriority::kHigh)], 1);
+
+    release = true;
+    release.notify_one();
+    executor.Shutdown();
+    EXPECT_EQ(order, (std::vector{TaskPriority::kHigh, TaskPriority::kNormal, TaskPriority::kLow}));
+}
+
+TEST(TaskGroupTest, Wait) {
+    Executor executor(4);
+    std::atomic<int> count{0};
+    TaskGroup group(executor);
+    for (int i = 0; i < 1000; i++) {
+        group.Run([&count]() { count++; });
+    }
+    group.Wait();
+    EXPECT_EQ(count, 1000);
+}
+
+TEST(TaskGroupTest, Cancel) {
+    Executor executor(1);
+    std::atomic<bool> started{false};
+    std::atomic<int> count{0};
+    TaskGroup group(executor);
+    group.Run([&]() {
+        started = true;
+        // 正在执行的任务主动检查取消状态
+        while (!group.IsCancelled()) {
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < 10; i++) {
+        group.Run([&count]() { count++; });
+    }
+    while (!started) {
+        std::this_thread::yield();
+    }
+    group.Cancel();
+    group.Wait();
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(executor.Metrics().cancelled, 10);
+}
+
+TEST(TaskGroupTest, ExceptionCancelsGroup) {
+    Executor executor(1);
+    std::atomic<int> count{0};
+    TaskGroup group(executor);
+    group.Run([]() { throw std::runtime_error("error"); });
+    for (int i = 0; i < 10; i++) {
+        group.Run([&count]() { count++; });
+    }
+    EXPECT_THROW(group.Wait(), std::runtime_error);
+    EXPECT_LT(count, 10);
+    EXPECT_NO_THROW(group.Wait());
+}
+
+TEST(TaskGroupTest, NestedInWorker) {
+    // 只有一个工作线程, 外层任务等待内层任务时需要自己执行内层任务
+    Executor executor(1);
+    std::atomic<int> count{0};
+    auto future = executor.Submit([&]() {
+        TaskGroup inner(executor, TaskPriority::kHigh);
+        for (int i = 0; i < 10; i++) {
+            inner.Run([&count]() { count++; });
+        }
+        inner.Wait();
+        return count.load();
+    });
+    EXPECT_EQ(future.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(future.get(), 10);
+}
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -12,7 +12,7 @@ void PushWhilePop() {
     static_assert(kDataNum >= kThreadNum && (kDataNum % kThreadNum == 0), "kDataNum 要能被 kThreadNum 均分");
 
     LockFreeQueue<HeapData, true> lock_free_queue;
-    EXPECT_EQ(sizeof(lock_free_queue), 32);
+    EXPECT_EQ(sizeof(lock_free_queue), 24);
     bool check[kDataNum] = {false};
 
     auto push = [&](std::size_t data) { lock_free_queue.Emplace(data); };
@@ -32,7 +32,7 @@ void PushWhilePop() {
     EXPECT_FALSE(lock_free_queue.Pop());
 }
 
-TEST(DISABLED_LockFreeQueueTest, LockFreeQueueTest) { PushWhilePop<10000, 16>(); }
+TEST(LockFreeQueueTest, LockFreeQueueTest) { PushWhilePop<10000, 16>(); }
 
 }  // namespace concurrency
 }  // namespace pyc
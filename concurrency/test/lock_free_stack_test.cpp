@@ -34,7 +34,7 @@ void PushWhilePop(T& lock_free_stack) {
 
 TEST(LockFreeStackTest, LockFreeStackTest) {
     LockFreeStack<HeapData> lock_free_stack;
-    EXPECT_EQ(sizeof(lock_free_stack), 24);
+    EXPECT_EQ(sizeof(lock_free_stack), 16);
     PushWhilePop<10000, 16>(lock_free_stack);
 }
 
@@ -44,6 +44,12 @@ TEST(LockFreeStackTest, HazardPointerStackTest) {
     PushWhilePop<10000, 16>(lock_free_stack);
 }
 
+TEST(LockFreeStackTest, HazardPointerStackManyThreadsTest) {
+    // 风险指针数量不再受限于固定数组, 线程数可以超过 100
+    HazardPointerStack<HeapData> lock_free_stack;
+    PushWhilePop<25600, 128>(lock_free_stack);
+}
+
 TEST(DISABLED_LockFreeStackTest, RefCountStackTest) {
     RefCountStack<HeapData, false> lock_free_stack;
     EXPECT_EQ(sizeof(lock_free_stack), 16);
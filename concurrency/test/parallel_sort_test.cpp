@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/parallel_sort.h"
+
+namespace pyc {
+namespace concurrency {
+
+std::vector<int> RandomData(std::size_t length, int max_value) {
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<int> distribution(0, max_value);
+    std::vector<int> data(length);
+    for (auto& value : data) {
+        value = distribution(engine);
+    }
+    return data;
+}
+
+TEST(ParallelSortTest, SmallInput) {
+    std::vector<int> empty;
+    ParallelSort(empty);
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<int> data = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    ParallelSort(data);
+    EXPECT_EQ(data, std::vector<int>({1, 1, 2, 3, 3, 4, 5, 5, 5, 6, 9}));
+}
+
+TEST(ParallelSortTest, RandomInput) {
+    auto data = RandomData(1 << 20, 1 << 30);
+    auto expected = data;
+    std::sort(expected.begin(), expected.end());
+    ParallelSort(data.begin(), data.end());
+    EXPECT_EQ(data, expected);
+}
+
+TEST(ParallelSortTest, ManyDuplicates) {
+    auto data = RandomData(1 << 18, 3);
+    auto expected = data;
+    std::sort(expected.begin(), expected.end());
+    ParallelSort(data);
+    EXPECT_EQ(data, expected);
+
+    std::vector<int> same(1 << 18, 7);
+    ParallelSort(same);
+    EXPECT_EQ(same, std::vector<int>(1 << 18, 7));
+}
+
+TEST(ParallelSortTest, SortedAndReversedInput) {
+    std::vector<int> data(1 << 18);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<int>(i);
+    }
+    auto expected = data;
+    ParallelSort(data);
+    EXPECT_EQ(data, expected);
+
+    std::reverse(data.begin(), data.end());
+    ParallelSort(data);
+    EXPECT_EQ(data, expected);
+}
+
+TEST(ParallelSortTest, CustomCompare) {
+    auto numbers = RandomData(1 << 17, 1 << 20);
+    std::vector<std::string> data;
+    data.reserve(numbers.size());
+    for (int number : numbers) {
+        data.push_back(std::to_string(number));
+    }
+    auto expected = data;
+    std::sort(expected.begin(), expected.end(), std::greater<>{});
+    ParallelSort(data, std::greater<>{});
+    EXPECT_EQ(data, expected);
+}
+
+TEST(ParallelSortTest, NestedInvoke) {
+    // 每个工作线程都在等待内层排序时, 等待方帮忙执行排队的任务, 不会死锁
+    const std::size_t kTasks = 2 * ParallelExecutor().ThreadCount();
+    std::vector<std::vector<int>> datasets(kTasks);
+    ParallelInvoke(kTasks, [&datasets](std::size_t i) {
+        datasets[i] = RandomData(1 << 17, 1 << 20);
+        ParallelSort(datasets[i]);
+    });
+    for (const auto& data : datasets) {
+        EXPECT_TRUE(std::is_sorted(data.begin(), data.end()));
+    }
+}
+
+}  // namespace concurrency
+}  // namespace pyc
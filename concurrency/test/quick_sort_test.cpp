@@ -160,9 +160,8 @@ TEST(QuickSortTest, ThreadPoolQuickSortTest) {
     EXPECT_EQ(result, std::list<int>({1, 1, 2, 3, 3, 4, 5, 5, 5, 6, 9}));
 }
 
-/// @brief Sorter 版本
-// TODO: bug fix
-TEST(DISABLED_QuickSortTest, ParallelQuickSortTest) {
+/// @brief ParallelSort 版本
+TEST(QuickSortTest, ParallelQuickSortTest) {
     std::list<int> arr = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
     auto result = ParallelQuickSort(arr);
     EXPECT_EQ(result, std::list<int>({1, 1, 2, 3, 3, 4, 5, 5, 5, 6, 9}));
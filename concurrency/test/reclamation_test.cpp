@@ -0,0 +1,173 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrency/reclamation/epoch.h"
+#include "concurrency/reclamation/hazard_pointer.h"
+
+namespace pyc {
+namespace concurrency {
+
+/// @brief 析构时计数, 用于观察节点何时被回收
+struct CountedNode {
+    inline static std::atomic<int> destroyed{0};
+
+    int value;
+
+    CountedNode(int _value = 0) : value(_value) {}
+    ~CountedNode() { destroyed++; }
+};
+
+TEST(HazardPointerTest, ProtectedNodeNotReclaimed) {
+    CountedNode::destroyed = 0;
+    HazardPointerDomain domain;
+    std::atomic<CountedNode*> shared{new CountedNode(1)};
+
+    {
+        HazardPointerDomain::Guard guard(domain);
+        CountedNode* node = guard.Protect(shared);
+        EXPECT_EQ(node->value, 1);
+
+        shared.store(nullptr);
+        domain.Retire(node);
+        domain.Reclaim();
+        EXPECT_EQ(CountedNode::destroyed, 0);
+        EXPECT_EQ(domain.RetiredCount(), 1);
+    }
+
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 1);
+    EXPECT_EQ(domain.RetiredCount(), 0);
+}
+
+TEST(HazardPointerTest, ProtectedByOtherThread) {
+    CountedNode::destroyed = 0;
+    HazardPointerDomain domain;
+    std::atomic<CountedNode*> shared{new CountedNode(1)};
+    std::atomic<bool> protected_flag{false};
+    std::atomic<bool> release_flag{false};
+
+    std::jthread reader([&]() {
+        HazardPointerDomain::Guard guard(domain);
+        guard.Protect(shared);
+        protected_flag = true;
+        while (!release_flag) {
+            std::this_thread::yield();
+        }
+    });
+    while (!protected_flag) {
+        std::this_thread::yield();
+    }
+
+    CountedNode* node = shared.exchange(nullptr);
+    domain.Retire(node);
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 0);
+
+    release_flag = true;
+    reader.join();
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 1);
+}
+
+TEST(HazardPointerTest, GuardSlotsExhausted) {
+    HazardPointerDomain domain;
+    std::vector<std::unique_ptr<HazardPointerDomain::Guard>> guards;
+    for (std::size_t i = 0; i < HazardPointerDomain::kSlotsPerThread; i++) {
+        guards.push_back(std::make_unique<HazardPointerDomain::Guard>(domain));
+    }
+    EXPECT_THROW(HazardPointerDomain::Guard{domain}, std::runtime_error);
+    guards.pop_back();
+    EXPECT_NO_THROW(HazardPointerDomain::Guard{domain});
+}
+
+TEST(HazardPointerTest, RetireTriggersAmortizedScan) {
+    CountedNode::destroyed = 0;
+    HazardPointerDomain domain;
+    for (std::size_t i = 0; i < HazardPointerDomain::kMinScanThreshold; i++) {
+        domain.Retire(new CountedNode(static_cast<int>(i)));
+    }
+    // 达到阈值时扫描一次, 不需要每次 Retire 都扫描
+    EXPECT_EQ(CountedNode::destroyed, static_cast<int>(HazardPointerDomain::kMinScanThreshold));
+    EXPECT_EQ(domain.RetiredCount(), 0);
+}
+
+TEST(HazardPointerTest, DomainDestructorReclaimsAll) {
+    CountedNode::destroyed = 0;
+    {
+        HazardPointerDomain domain;
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < 8; i++) {
+            threads.emplace_back([&domain, i]() { domain.Retire(new CountedNode(i)); });
+        }
+    }
+    EXPECT_EQ(CountedNode::destroyed, 8);
+}
+
+TEST(EpochTest, PinnedThreadBlocksReclaim) {
+    CountedNode::destroyed = 0;
+    EpochDomain domain;
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release_flag{false};
+
+    std::jthread reader([&]() {
+        EpochDomain::Guard guard(domain);
+        pinned = true;
+        while (!release_flag) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+
+    domain.Retire(new CountedNode(1));
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 0);
+
+    release_flag = true;
+    reader.join();
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 1);
+}
+
+TEST(EpochTest, NestedGuard) {
+    CountedNode::destroyed = 0;
+    EpochDomain domain;
+    {
+        EpochDomain::Guard outer(domain);
+        {
+            EpochDomain::Guard inner(domain);
+        }
+        domain.Retire(new CountedNode(1));
+        // 自身仍处于临界区, 纪元最多推进一次
+        domain.Reclaim();
+        EXPECT_EQ(CountedNode::destroyed, 0);
+    }
+    domain.Reclaim();
+    EXPECT_EQ(CountedNode::destroyed, 1);
+}
+
+TEST(EpochTest, ConcurrentRetire) {
+    constexpr int kThreadNum = 16;
+    constexpr int kRetireNum = 1000;
+    CountedNode::destroyed = 0;
+    {
+        EpochDomain domain;
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < kThreadNum; i++) {
+            threads.emplace_back([&domain]() {
+                for (int j = 0; j < kRetireNum; j++) {
+                    EpochDomain::Guard guard(domain);
+                    domain.Retire(new CountedNode(j));
+                }
+            });
+        }
+    }
+    EXPECT_EQ(CountedNode::destroyed, kThreadNum * kRetireNum);
+}
+
+}  // namespace concurrency
+}  // namespace pyc
@@ -1,7 +1,11 @@
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "concurrency/adaptive_mutex.h"
+#include "concurrency/mcs_lock.h"
 #include "concurrency/spin_lock.h"
 
 namespace pyc {
@@ -31,5 +35,71 @@ TEST(SpinLockTest, SpinLockTest) {
     }
 }
 
+template <typename Lock>
+class LockableTest : public testing::Test {};
+
+using LockTypes = testing::Types<SpinLock, McsLock, AdaptiveMutex>;
+TYPED_TEST_SUITE(LockableTest, LockTypes);
+
+TYPED_TEST(LockableTest, TryLock) {
+    TypeParam lock;
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+}
+
+TYPED_TEST(LockableTest, MutualExclusion) {
+    constexpr int kThreadNum = 8;
+    constexpr int kIncrementNum = 10000;
+    TypeParam lock;
+    int counter = 0;
+    {
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < kThreadNum; i++) {
+            threads.emplace_back([&]() {
+                for (int j = 0; j < kIncrementNum; j++) {
+                    std::lock_guard<TypeParam> guard(lock);
+                    counter++;
+                }
+            });
+        }
+    }
+    EXPECT_EQ(counter, kThreadNum * kIncrementNum);
+}
+
+TYPED_TEST(LockableTest, MultipleLocks) {
+    // 同一线程同时持有多把锁, 且不按加锁的逆序解锁
+    TypeParam lock1;
+    TypeParam lock2;
+    std::unique_lock<TypeParam> guard1(lock1);
+    std::unique_lock<TypeParam> guard2(lock2);
+    guard1.unlock();
+    EXPECT_TRUE(lock1.try_lock());
+    lock1.unlock();
+    guard2.unlock();
+    std::scoped_lock guard(lock1, lock2);
+}
+
+TEST(McsLockTest, FifoHandoff) {
+    McsLock lock;
+    std::vector<int> order;
+    lock.lock();
+    {
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&, i]() {
+                std::lock_guard<McsLock> guard(lock);
+                order.push_back(i);
+            });
+            // 等待线程进入队列后再启动下一个
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        lock.unlock();
+    }
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3}));
+}
+
 }  // namespace concurrency
 }  // namespace pyc
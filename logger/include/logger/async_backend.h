@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/noncopyable.h"
+#include "logger/binary_log.h"
+#include "logger/log_format.h"
+#include "logger/log_sink.h"
+
+namespace pyc {
+
+/// @brief 环形缓冲区已满时的处理方式
+enum class OverflowPolicy {
+    kBlock,  // 等待后台线程腾出槽位, 不丢日志
+    kDrop,   // 直接丢弃, 只计入 AsyncMetrics::dropped
+    kCount,  // 丢弃并计数, 后台线程在输出中补一行丢弃的条数
+};
+
+/// @brief sink 的 flush 时机, 满足任一条件时 flush 所有 sink
+struct FlushPolicy {
+    std::chrono::milliseconds interval{100};     // 有未 flush 的输出时最长的等待时间
+    LogLevel immediate_level{LogLevel::kError};  // 写出该级别及以上的日志后立即 flush
+};
+
+struct AsyncOptions {
+    std::size_t capacity{8192};  // 环形缓冲区的槽位数, 向上取整为 2 的幂
+    OverflowPolicy overflow{OverflowPolicy::kBlock};
+    FlushPolicy flush{};
+    bool deferred_format{false};  // 参数可以按原始字节保存时推迟格式化, 见 AsyncBackend::pushDeferred
+};
+
+/// @brief 异步日志运行指标快照
+struct AsyncMetrics {
+    std::uint64_t written{0};  // 已写入 sink 的条数
+    std::uint64_t dropped{0};  // 缓冲区满时丢弃的条数
+    std::uint64_t blocked{0};  // 缓冲区满时调用者等待的次数
+};
+
+/// @brief 异步日志后端, 调用者把紧凑的记录 (级别, source_location, 时间戳计数, 线程号, 消息) 放入有界 MPSC
+/// 环形缓冲区, 由后台线程格式化时间和位置并批量写入各个 sink
+/// - 消息直接格式化到槽位内复用的缓冲区中, 稳定后入队不需要分配内存
+/// - 环形缓冲区按 Vyukov 的做法为每个槽位维护序号, 生产者之间只竞争一次 CAS
+/// - 时间戳只记录 system_clock 计数, 由后台线程格式化, 同一秒内复用日期部分
+/// - 开启 deferred_format 时只复制参数的原始字节, 文本 sink 由后台线程格式化, 二进制 sink (BinaryFileSink)
+///   只写出日志点 id 和参数字节, 由 DecodeBinaryLog 离线还原
+/// 通过 start 安装后 Logger 的所有输出都经过后端, stop 之后恢复同步输出
+class AsyncBackend : public Noncopyable {
+public:
+    /// @brief 持有期间取得的全局后端不会被 stop 或 start 销毁, 没有安装后端时为空
+    /// 按 epoch_ 的奇偶计数, stop 翻转 epoch_ 后只等待翻转前取得后端的调用者, 持续写日志的线程不会让它一直等待
+    /// 持有 Guard 的线程不能调用 start 或 stop
+    class Guard : public Noncopyable {
+    public:
+        Guard() noexcept {
+            // 计数之后 epoch_ 未变才能确定之后的翻转都会等待本次计数, 否则计入的槽位可能已被跳过, 撤回后重试
+            for (;;) {
+                const std::size_t epoch = epoch_.load();
+                slot_ = epoch & 1;
+                users_[slot_].fetch_add(1);
+                if (epoch_.load() == epoch) {
+                    break;
+                }
+                users_[slot_].fetch_sub(1);
+            }
+            backend_ = current_.load();
+        }
+
+        ~Guard() { users_[slot_].fetch_sub(1); }
+
+        AsyncBackend* get() const noexcept { return backend_; }
+
+        AsyncBackend* operator->() const noexcept { return backend_; }
+
+        explicit operator bool() const noexcept { return backend_ != nullptr; }
+
+    private:
+        std::size_t slot_;
+        AsyncBackend* backend_;
+    };
+
+    AsyncBackend(std::vector<std::unique_ptr<LogSink>> sinks, const AsyncOptions& options = {});
+
+    /// @brief 写出剩余日志后停止后台线程
+    ~AsyncBackend();
+
+    /// @brief 创建并安装全局后端, 已有后端时替换并销毁旧的
+    static void start(std::vector<std::unique_ptr<LogSink>> sinks, const AsyncOptions& options = {});
+
+    /// @brief 卸载并销毁全局后端, 等待正在使用它的调用者 (Guard) 结束并写出剩余日志后返回
+    /// 其他线程可以同时写日志, 卸载后的日志同步输出
+    static void stop();
+
+    /// @brief 格式化消息并放入环形缓冲区, 可以在任意线程调用
+    void push(LogLevel level, std::string_view name, const std::source_location& location, fmt::string_view format,
+              fmt::format_args args);
+
+    /// @brief 只保存格式字符串的地址和参数的原始字节, 格式化推迟到后台线程或离线解码, 可以在任意线程调用
+    /// format 和 name 必须是静态存储的字符串, 日志点由它们和 location 的地址区分
+    template <typename... Args>
+    void pushDeferred(LogLevel level, std::string_view name, const std::source_location& location,
+                      fmt::string_view format, const Args&... args) {
+        std::size_t pos = 0;
+        Cell* cell = claim(pos);
+        if (!cell) {
+            return;
+        }
+        Record& record = cell->record;
+        fill(record, level, name, location, format);
+        record.deferred = true;
+        record.types = kArgTypes<Args...>;
+        (EncodeArg(record.text, args), ...);
+        commit(cell, pos);
+    }
+
+    bool deferredFormat() const noexcept { return options_.deferred_format; }
+
+    /// @brief 等待调用前放入的日志全部写入 sink 并 flush
+    void flush();
+
+    AsyncMetrics metrics() const;
+
+private:
+    static constexpr std::size_t kInlineText = 128;
+
+    struct Record {
+        LogLevel level{LogLevel::kInfo};
+        std::string_view name{};
+        std::source_location location{};
+        std::int64_t ticks{0};  // std::chrono::system_clock 的计数
+        std::size_t thread_id{0};
+        fmt::string_view format{};
+        bool deferred{false};
+        std::span<const ArgType> types{};                    // deferred 时参数的类型
+        fmt::basic_memory_buffer<char, kInlineText> text{};  // 消息或参数的原始字节, 槽位重用时保留容量
+    };
+
+    /// @brief 区分日志点, 各字段都指向静态存储
+    struct SiteKey {
+        const char* format;
+        const char* name;
+        const char* file;
+        std::uint32_t line;
+        LogLevel level;
+        bool deferred;
+
+        bool operator==(const SiteKey&) const = default;
+    };
+
+    struct SiteKeyHash {
+        std::size_t operator()(const SiteKey& key) const noexcept {
+            std::size_t hash = std::hash<const void*>{}(key.format);
+            hash = hash * 31 + std::hash<const void*>{}(key.file);
+            hash = hash * 31 + key.line;
+            return hash;
+        }
+    };
+
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        Record record{};
+    };
+
+    /// @brief 取得一个可写的槽位及其位置, 缓冲区满且策略不是 kBlock 时返回 nullptr
+    Cell* claim(std::size_t& pos);
+
+    /// @brief 填写记录的公共字段并清空 text
+    static void fill(Record& record, LogLevel level, std::string_view name, const std::source_location& location,
+                     fmt::string_view format);
+
+    /// @brief 提交已写好的槽位, 必要时唤醒后台线程
+    void commit(Cell* cell, std::size_t pos);
+
+    void run();
+
+    /// @brief 取出已提交的记录写入 sink, 返回条数, 有达到 immediate_level 的记录时 urgent 置为 true
+    std::size_t drain(bool& urgent);
+
+    void writeRecord(const Record& record);
+
+    /// @brief 编码为二进制条目并写入二进制 sink
+    void encodeRecord(const Record& record);
+
+    /// @brief 日志点的编号, 第一次出现时分配编号并把 site 的定义写入 binary_
+    std::uint32_t siteId(const SiteKey& key, BinarySite& site);
+
+    void writeText(LogLevel level, std::string_view line);
+
+    /// @brief 把 binary_ 写入二进制 sink
+    void writeBinary(LogLevel level);
+
+    /// @brief 报告 kCount 策略下新丢弃的条数
+    void reportDropped();
+
+    void flushSinks();
+
+    /// @brief 后台线程等待新日志, 最长等待 timeout
+    void waitForRecords(std::chrono::milliseconds timeout);
+
+    void wakeUp();
+
+    /// @brief 等待 Guard 不再引用 backend 后销毁, 需持有 lifecycle_mutex_
+    static void retire(AsyncBackend* backend);
+
+private:
+    static std::atomic<AsyncBackend*> current_;
+    static std::atomic<std::size_t> epoch_;                             // 每次 retire 加一
+    alignas(64) static std::array<std::atomic<std::size_t>, 2> users_;  // 按 epoch_ 奇偶计数持有 Guard 的调用者
+    static std::mutex lifecycle_mutex_;                                 // 串行化 start 和 stop
+
+    const std::vector<std::unique_ptr<LogSink>> sinks_;
+    const AsyncOptions options_;
+    const std::size_t mask_;
+    const std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> tail_{0};  // 下一个写入位置
+    alignas(64) std::atomic<std::size_t> head_{0};  // 下一个读取位置, 只有后台线程修改
+
+    std::atomic<std::size_t> flush_target_{0};  // flush 请求的位置
+    std::atomic<std::size_t> flushed_{0};       // 该位置之前的日志已写入并 flush
+    std::atomic<bool> sleeping_{false};         // 后台线程是否在等待
+    std::atomic<bool> stopping_{false};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> blocked_{0};
+
+    // 以下只由后台线程访问
+    bool has_text_sinks_{false};
+    bool has_binary_sinks_{false};
+    std::uint64_t reported_dropped_{0};
+    LineFormatter formatter_{};
+    fmt::memory_buffer message_{};
+    fmt::memory_buffer line_{};
+    fmt::memory_buffer binary_{};
+    fmt::memory_buffer args_{};
+    std::unordered_map<SiteKey, std::uint32_t, SiteKeyHash> sites_{};
+
+    std::thread thread_;
+};
+
+}  // namespace pyc
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "logger/log_format.h"
+
+namespace pyc {
+
+/// @brief 二进制日志流格式, 整数按本机字节序编码, 需在字节序相同的机器上解码
+/// 文件头为 kBinaryLogMagic, 之后是若干条目, 每个条目以 1 字节的 BinaryEntry 开头:
+/// - kSite: u32 id, u8 level, u32 line, u8 参数个数, 每个参数 1 字节 ArgType,
+///   然后是 name, format, file, function 四个字符串 (u32 长度 + 内容)
+/// - kLog: u32 site id, i64 纳秒时间戳, u32 线程号, u32 参数字节数, 参数按类型依次编码
+/// 日志点第一次出现时写出 kSite, 之后每条日志只有 site id 和参数的原始字节
+/// 每个 kBinaryLogMagic 之后 site id 重新编号, 多次运行可以追加到同一个文件
+inline constexpr std::string_view kBinaryLogMagic{"PYCLOG1\n"};
+
+enum class BinaryEntry : std::uint8_t { kSite = 1, kLog = 2 };
+
+/// @brief 参数编码: 字符串为 u32 长度 + 内容, 其余为对应类型的原始字节
+enum class ArgType : std::uint8_t { kBool, kChar, kInt64, kUint64, kFloat, kDouble, kString, kPointer };
+
+template <typename T>
+concept BinaryString = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                       std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+/// @brief 可以按原始字节保存的参数类型 (已 decay), 其他类型在调用线程上格式化
+template <typename T>
+concept BinaryEncodable = (std::is_arithmetic_v<T> && !std::is_same_v<T, long double>) || BinaryString<T> ||
+                          std::is_same_v<T, const void*> || std::is_same_v<T, void*>;
+
+template <BinaryEncodable T>
+consteval ArgType ArgTypeOf() {
+    if constexpr (std::is_same_v<T, bool>) {
+        return ArgType::kBool;
+    } else if constexpr (std::is_same_v<T, char>) {
+        return ArgType::kChar;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return ArgType::kFloat;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return ArgType::kDouble;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return ArgType::kInt64;
+    } else if constexpr (std::is_integral_v<T>) {
+        return ArgType::kUint64;
+    } else if constexpr (BinaryString<T>) {
+        return ArgType::kString;
+    } else {
+        return ArgType::kPointer;
+    }
+}
+
+/// @brief 每组参数类型对应一个静态数组, 记录中只保存其地址
+template <typename... Args>
+inline constexpr std::array<ArgType, sizeof...(Args)> kArgTypes{ArgTypeOf<std::decay_t<Args>>()...};
+
+/// @brief 把一个参数的原始字节追加到 buffer
+template <typename Buffer, typename T>
+void EncodeArg(Buffer& buffer, const T& value) {
+    using Decayed = std::decay_t<T>;
+    auto append = [&buffer](const void* data, std::size_t size) {
+        const char* begin = static_cast<const char*>(data);
+        buffer.append(begin, begin + size);
+    };
+    if constexpr (BinaryString<Decayed>) {
+        std::string_view text;
+        if constexpr (std::is_array_v<T>) {
+            text = std::string_view(value);
+        } else if constexpr (std::is_pointer_v<Decayed>) {
+            text = value ? std::string_view(value) : std::string_view();
+        } else {
+            text = value;
+        }
+        const auto size = static_cast<std::uint32_t>(text.size());
+        append(&size, sizeof(size));
+        append(text.data(), text.size());
+    } else {
+        constexpr ArgType kType = ArgTypeOf<Decayed>();
+        if constexpr (kType == ArgType::kInt64) {
+            const auto widened = static_cast<std::int64_t>(value);
+            append(&widened, sizeof(widened));
+        } else if constexpr (kType == ArgType::kUint64) {
+            const auto widened = static_cast<std::uint64_t>(value);
+            append(&widened, sizeof(widened));
+        } else if constexpr (kType == ArgType::kDouble) {
+            const auto widened = static_cast<double>(value);
+            append(&widened, sizeof(widened));
+        } else if constexpr (kType == ArgType::kPointer) {
+            const auto address = reinterpret_cast<std::uintptr_t>(value);
+            append(&address, sizeof(address));
+        } else {
+            append(&value, sizeof(value));
+        }
+    }
+}
+
+/// @brief 一个日志点的静态信息
+struct BinarySite {
+    std::uint32_t id{0};
+    LogLevel level{LogLevel::kInfo};
+    std::uint32_t line{0};
+    std::span<const ArgType> types{};
+    std::string_view name{};
+    std::string_view format{};
+    std::string_view file{};
+    std::string_view function{};
+};
+
+void EncodeSite(fmt::memory_buffer& out, const BinarySite& site);
+
+void EncodeLog(fmt::memory_buffer& out, std::uint32_t site_id, std::int64_t nanoseconds, std::uint32_t thread_id,
+               std::string_view args);
+
+/// @brief 按 types 解析 args 中的原始字节并用 format 格式化, 追加到 out, 数据不完整时抛出 std::runtime_error
+void FormatBinaryArgs(fmt::memory_buffer& out, fmt::string_view format, std::span<const ArgType> types,
+                      std::string_view args);
+
+/// @brief 解码二进制日志流, 每条日志按 LineFormatter 的格式还原为一行文本交给 output
+/// 流损坏或不完整时抛出 std::runtime_error
+void DecodeBinaryLog(std::istream& input, const std::function<void(LogLevel, std::string_view)>& output);
+
+}  // namespace pyc
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fmt/color.h>
+#include <fmt/format.h>
+
+/// @brief 编译期最低日志级别 (LogLevel 的数值), 低于该级别的日志调用被整条丢弃,
+/// 通过 PYC_LOG_* 调用时参数也不会求值
+/// 默认保留全部级别, 发布构建可以定义 PYC_LOG_MIN_LEVEL=1 去掉 debug
+#ifndef PYC_LOG_MIN_LEVEL
+#define PYC_LOG_MIN_LEVEL 0
+#endif
+
+namespace pyc {
+
+enum class LogLevel { kDebug, kInfo, kWarn, kError, kFatal };
+
+inline constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(PYC_LOG_MIN_LEVEL);
+
+constexpr std::string_view ToString(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::kDebug:
+            return "DEBUG";
+        case LogLevel::kInfo:
+            return "INFO";
+        case LogLevel::kWarn:
+            return "WARN";
+        case LogLevel::kError:
+            return "ERROR";
+        case LogLevel::kFatal:
+            return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+/// @brief 按名字解析级别, 不区分大小写, 如 "debug", "WARN", 无法识别时返回 std::nullopt
+std::optional<LogLevel> ParseLogLevel(std::string_view name) noexcept;
+
+constexpr fmt::text_style ToTextStyle(LogLevel level) noexcept {
+    switch (level) {
+        case LogLevel::kDebug:
+            return fg(fmt::color::cyan);
+        case LogLevel::kInfo:
+            return fg(fmt::color::green);
+        case LogLevel::kWarn:
+            return fg(fmt::color::yellow);
+        case LogLevel::kError:
+            return fg(fmt::color::red);
+        case LogLevel::kFatal:
+            return fg(fmt::color::dark_orange) | fmt::emphasis::reverse | fmt::emphasis::bold;
+    }
+    return {};
+}
+
+constexpr std::string_view ExtractFunctionName(std::string_view full_name) noexcept {
+    auto end_pos = full_name.find_last_of('(');
+    if (end_pos != std::string_view::npos) {
+        auto start_pos = full_name.rfind("::", end_pos);
+        if (start_pos != std::string_view::npos) {
+            start_pos += 2;
+        } else {
+            start_pos = full_name.rfind(' ', end_pos);
+            if (start_pos != std::string_view::npos) {
+                start_pos++;
+            } else {
+                return full_name.substr(0, end_pos);
+            }
+        }
+        return full_name.substr(start_pos, end_pos - start_pos);
+    }
+    return full_name;
+}
+
+/// @brief 生成异步日志和二进制日志解码共用的行格式, 不含换行符, 同一秒内复用格式化好的日期部分
+/// [name][LEVEL][thread][%Y-%m-%d %H:%M:%S.ms] <file:line> [function] message
+class LineFormatter {
+public:
+    void format(fmt::memory_buffer& out, std::string_view name, LogLevel level, std::size_t thread_id,
+                std::chrono::system_clock::time_point time, std::string_view file, std::uint32_t line,
+                std::string_view function, std::string_view message);
+
+private:
+    std::int64_t cached_second_{-1};
+    std::string cached_time_{};  // cached_second_ 对应的 "%Y-%m-%d %H:%M:%S"
+};
+
+}  // namespace pyc
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "common/noncopyable.h"
+#include "logger/log_format.h"
+
+namespace pyc {
+
+/// @brief 异步日志的输出目标, 只由后台线程调用, 实现不需要加锁
+class LogSink : public Noncopyable {
+public:
+    virtual ~LogSink() = default;
+
+    /// @brief 写入一行日志, line 不含换行符, 可以先缓冲, 由 flush 保证落盘
+    /// binary() 为 true 时 line 是二进制日志流的一段, 见 binary_log.h
+    virtual void write(LogLevel level, std::string_view line) = 0;
+
+    virtual void flush() = 0;
+
+    virtual bool binary() const noexcept { return false; }
+};
+
+/// @brief 输出到标准输出, 可选按级别着色
+class ConsoleSink : public LogSink {
+public:
+    explicit ConsoleSink(bool color = true) : color_(color) {}
+
+    void write(LogLevel level, std::string_view line) override;
+
+    void flush() override;
+
+private:
+    bool color_;
+};
+
+/// @brief 以追加方式输出到文件, 使用较大的 stdio 缓冲区, 多行日志合并为一次写入
+class FileSink : public LogSink {
+public:
+    static constexpr std::size_t kBufferSize = 64 * 1024;
+
+    /// @brief 打开失败时抛出 std::system_error
+    explicit FileSink(const std::string& path);
+
+    ~FileSink() override;
+
+    void write(LogLevel level, std::string_view line) override;
+
+    void flush() override;
+
+private:
+    std::FILE* file_;
+};
+
+/// @brief 以二进制日志流追加到文件, 每次打开时写入文件头, 用 log_decoder 还原为文本
+class BinaryFileSink : public LogSink {
+public:
+    /// @brief 打开失败时抛出 std::system_error
+    explicit BinaryFileSink(const std::string& path);
+
+    ~BinaryFileSink() override;
+
+    void write(LogLevel level, std::string_view bytes) override;
+
+    void flush() override;
+
+    bool binary() const noexcept override { return true; }
+
+private:
+    std::FILE* file_;
+};
+
+}  // namespace pyc
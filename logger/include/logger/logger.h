@@ -1,18 +1,23 @@
 #pragma once
 
+#include <atomic>
 #include <source_location>
 #include <string_view>
 
 #include <fmt/format.h>
 
-namespace pyc {
+#include "logger/async_backend.h"
+#include "logger/log_format.h"
 
-enum class LogLevel { kDebug, kInfo, kWarn, kError, kFatal };
+namespace pyc {
 
 class Logger {
 public:
     constexpr explicit Logger(std::string_view name = "DEFAULT") noexcept : name_(name) {}
 
+    Logger(const Logger& other) noexcept
+        : name_(other.name_), threshold_(other.threshold_.load(std::memory_order_relaxed)) {}
+
     template <typename... Args>
     struct FmtWithLocation {
         fmt::format_string<Args...> fmt;
@@ -29,41 +34,111 @@ public:
 
     template <typename... Args>
     inline void debug(FormatString<Args...> fmt_with_location, Args&&... args) const {
-        log<LogLevel::kDebug>(fmt::format(fmt_with_location.fmt, std::forward<Args>(args)...),
-                              fmt_with_location.location);
+        dispatch<LogLevel::kDebug, Args...>(fmt_with_location, args...);
     }
 
     template <typename... Args>
     inline void info(FormatString<Args...> fmt_with_location, Args&&... args) const {
-        log<LogLevel::kInfo>(fmt::format(fmt_with_location.fmt, std::forward<Args>(args)...),
-                             fmt_with_location.location);
+        dispatch<LogLevel::kInfo, Args...>(fmt_with_location, args...);
     }
 
     template <typename... Args>
     inline void warn(FormatString<Args...> fmt_with_location, Args&&... args) const {
-        log<LogLevel::kWarn>(fmt::format(fmt_with_location.fmt, std::forward<Args>(args)...),
-                             fmt_with_location.location);
+        dispatch<LogLevel::kWarn, Args...>(fmt_with_location, args...);
     }
 
     template <typename... Args>
     inline void error(FormatString<Args...> fmt_with_location, Args&&... args) const {
-        log<LogLevel::kError>(fmt::format(fmt_with_location.fmt, std::forward<Args>(args)...),
-                              fmt_with_location.location);
+        dispatch<LogLevel::kError, Args...>(fmt_with_location, args...);
     }
 
     template <typename... Args>
     inline void fatal(FormatString<Args...> fmt_with_location, Args&&... args) const {
-        log<LogLevel::kFatal>(fmt::format(fmt_with_location.fmt, std::forward<Args>(args)...),
-                              fmt_with_location.location);
+        dispatch<LogLevel::kFatal, Args...>(fmt_with_location, args...);
         exit(EXIT_FAILURE);
     }
 
+    /// @brief level 是否会输出: 不低于编译期的 kMinLogLevel, 也不低于该名字的运行期阈值, 只有两次原子读
+    bool enabled(LogLevel level) const noexcept {
+        return level >= kMinLogLevel && level >= threshold().load(std::memory_order_relaxed);
+    }
+
+    std::string_view name() const noexcept { return name_; }
+
+    /// @brief 设置名字为 name 的所有 logger 的运行期阈值, 立即对所有线程生效
+    static void setLevel(std::string_view name, LogLevel level);
+
+    /// @brief 取消 name 的单独设置, 恢复使用默认阈值
+    static void resetLevel(std::string_view name);
+
+    /// @brief 设置没有单独设置的 logger 的阈值, 初始为 kDebug
+    static void setDefaultLevel(LogLevel level);
+
+    static LogLevel getLevel(std::string_view name);
+
+    /// @brief 按 "info,co_async=debug,MysqlMgr=warn" 的格式批量设置, 不带名字的一项为默认阈值
+    /// 格式错误时抛出 std::invalid_argument, 不修改任何阈值, 可以用于运行中重新加载配置
+    static void configure(std::string_view spec);
+
 private:
+    /// @brief 低于编译期或运行期阈值时直接返回;
+    /// 后端开启 deferred_format 且参数都可以按原始字节保存时只复制参数, 否则在调用线程上格式化
+    template <LogLevel level, typename... Args>
+    inline void dispatch(const FormatString<Args...>& fmt_with_location, Args&... args) const {
+        if constexpr (level >= kMinLogLevel) {
+            if (!enabled(level)) {
+                return;
+            }
+            if constexpr ((BinaryEncodable<std::decay_t<Args>> && ...)) {
+                AsyncBackend::Guard backend;
+                if (backend && backend->deferredFormat()) {
+                    backend->pushDeferred(level, name_, fmt_with_location.location, fmt_with_location.fmt,
+                                          args...);
+                    if constexpr (level == LogLevel::kFatal) {
+                        backend->flush();
+                    }
+                    return;
+                }
+            }
+            log<level>(fmt_with_location.fmt, fmt::make_format_args(args...), fmt_with_location.location);
+        }
+    }
+
+    /// @brief 安装了 AsyncBackend 时放入其环形缓冲区, 否则同步格式化并输出到标准输出
     template <LogLevel level>
-    void log(std::string_view msg, const std::source_location location) const;
+    void log(fmt::string_view fmt, fmt::format_args args, const std::source_location location) const;
+
+    /// @brief 该名字的阈值, 第一次使用时从全局表中取得, 之后只有一次原子读
+    const std::atomic<LogLevel>& threshold() const noexcept {
+        const auto* threshold = threshold_.load(std::memory_order_acquire);
+        if (!threshold) [[unlikely]] {
+            threshold = &resolveThreshold(name_);
+            threshold_.store(threshold, std::memory_order_release);
+        }
+        return *threshold;
+    }
+
+    static const std::atomic<LogLevel>& resolveThreshold(std::string_view name);
 
 private:
     std::string_view name_;
+    mutable std::atomic<const std::atomic<LogLevel>*> threshold_{nullptr};
 };
 
-}  // namespace pyc
\ No newline at end of file
+}  // namespace pyc
+
+/// @brief 级别低于编译期的 kMinLogLevel 或 logger 的运行期阈值时整条跳过, 参数不会求值
+/// 例: PYC_LOG_DEBUG(logger, "state = {}", DumpState());
+#define PYC_LOG(logger, level, method, ...)             \
+    do {                                                \
+        if constexpr ((level) >= ::pyc::kMinLogLevel) { \
+            if ((logger).enabled(level)) {              \
+                (logger).method(__VA_ARGS__);           \
+            }                                           \
+        }                                               \
+    } while (0)
+
+#define PYC_LOG_DEBUG(logger, ...) PYC_LOG(logger, ::pyc::LogLevel::kDebug, debug, __VA_ARGS__)
+#define PYC_LOG_INFO(logger, ...) PYC_LOG(logger, ::pyc::LogLevel::kInfo, info, __VA_ARGS__)
+#define PYC_LOG_WARN(logger, ...) PYC_LOG(logger, ::pyc::LogLevel::kWarn, warn, __VA_ARGS__)
+#define PYC_LOG_ERROR(logger, ...) PYC_LOG(logger, ::pyc::LogLevel::kError, error, __VA_ARGS__)
\ No newline at end of file
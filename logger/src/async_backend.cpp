@@ -0,0 +1,377 @@
+#include "logger/async_backend.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iterator>
+
+
+#include "common/thread_id.h"
+
+namespace pyc {
+
+namespace {
+
+std::size_t RoundUpCapacity(std::size_t capacity) {
+    std::size_t result = 2;
+    while (result < capacity) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+std::atomic<AsyncBackend*> AsyncBackend::current_{nullptr};
+std::atomic<std::size_t> AsyncBackend::epoch_{0};
+alignas(64) std::array<std::atomic<std::size_t>, 2> AsyncBackend::users_{};
+std::mutex AsyncBackend::lifecycle_mutex_;
+
+AsyncBackend::AsyncBackend(std::vector<std::unique_ptr<LogSink>> sinks, const AsyncOptions& options)
+    : sinks_(std::move(sinks)),
+      options_(options),
+      mask_(RoundUpCapacity(options.capacity) - 1),
+      cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+    for (std::size_t i = 0; i <= mask_; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    for (const auto& sink : sinks_) {
+        (sink->binary() ? has_binary_sinks_ : has_text_sinks_) = true;
+    }
+    thread_ = std::thread([this]() { run(); });
+}
+
+AsyncBackend::~AsyncBackend() {
+    stopping_.store(true, std::memory_order_release);
+    wakeUp();
+    thread_.join();
+}
+
+void AsyncBackend::start(std::vector<std::unique_ptr<LogSink>> sinks, const AsyncOptions& options) {
+    // 进程正常退出时写出剩余日志
+    static const bool registered = []() {
+        std::atexit([]() { stop(); });
+        return true;
+    }();
+    (void)registered;
+    auto* backend = new AsyncBackend(std::move(sinks), options);
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    retire(current_.exchange(backend));
+}
+
+void AsyncBackend::stop() {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    retire(current_.exchange(nullptr));
+}
+
+void AsyncBackend::retire(AsyncBackend* backend) {
+    if (!backend) {
+        return;
+    }
+    // 以下都是 seq_cst: Guard 计数后确认 epoch_ 未变才读取 current_,
+    // 翻转之后完成确认的 Guard 一定读到新的 current_, 只需等待翻转之前完成确认的 Guard;
+    // 确认时发现已翻转的 Guard 撤回计数后重试
+    const std::size_t slot = epoch_.fetch_add(1) & 1;
+    while (users_[slot].load() != 0) {
+        std::this_thread::yield();
+    }
+    delete backend;
+}
+
+AsyncBackend::Cell* AsyncBackend::claim(std::size_t& pos) {
+    pos = tail_.load(std::memory_order_relaxed);
+    bool waited = false;
+    for (;;) {
+        Cell* cell = &cells_[pos & mask_];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return cell;
+            }
+        } else if (diff < 0) {
+            // 缓冲区已满
+            if (options_.overflow != OverflowPolicy::kBlock) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (!waited) {
+                blocked_.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+            }
+            wakeUp();
+            std::this_thread::yield();
+            pos = tail_.load(std::memory_order_relaxed);
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void AsyncBackend::push(LogLevel level, std::string_view name, const std::source_location& location,
+                        fmt::string_view format, fmt::format_args args) {
+    std::size_t pos = 0;
+    Cell* cell = claim(pos);
+    if (!cell) {
+        return;
+    }
+    Record& record = cell->record;
+    fill(record, level, name, location, format);
+    try {
+        fmt::vformat_to(std::back_inserter(record.text), format, args);
+    } catch (const std::exception& e) {
+        // 槽位已经占用, 必须提交, 否则后台线程会一直等待该槽位
+        record.text.clear();
+        fmt::format_to(std::back_inserter(record.text), "<format error: {}>", e.what());
+    }
+    commit(cell, pos);
+}
+
+void AsyncBackend::fill(Record& record, LogLevel level, std::string_view name,
+                        const std::source_location& location, fmt::string_view format) {
+    record.level = level;
+    record.name = name;
+    record.location = location;
+    record.ticks = std::chrono::system_clock::now().time_since_epoch().count();
+    record.thread_id = ShortThreadId();
+    record.format = format;
+    record.deferred = false;
+    record.types = {};
+    record.text.clear();
+}
+
+void AsyncBackend::commit(Cell* cell, std::size_t pos) {
+    // 提交和检查 sleeping_ 都使用 seq_cst, 与 waitForRecords 配对, 保证后台线程要么看到该记录, 要么被唤醒
+    cell->sequence.store(pos + 1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        wakeUp();
+    }
+}
+
+void AsyncBackend::flush() {
+    const std::size_t target = tail_.load(std::memory_order_acquire);
+    std::size_t current = flush_target_.load(std::memory_order_relaxed);
+    while (current < target && !flush_target_.compare_exchange_weak(current, target)) {
+    }
+    wakeUp();
+    std::size_t flushed = flushed_.load(std::memory_order_acquire);
+    while (flushed < target) {
+        flushed_.wait(flushed, std::memory_order_acquire);
+        flushed = flushed_.load(std::memory_order_acquire);
+    }
+}
+
+AsyncMetrics AsyncBackend::metrics() const {
+    AsyncMetrics metrics;
+    metrics.written = written_.load(std::memory_order_relaxed);
+    metrics.dropped = dropped_.load(std::memory_order_relaxed);
+    metrics.blocked = blocked_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void AsyncBackend::run() {
+    auto last_flush = std::chrono::steady_clock::now();
+    bool dirty = false;
+    for (;;) {
+        bool urgent = false;
+        const std::size_t count = drain(urgent);
+        if (options_.overflow == OverflowPolicy::kCount) {
+            reportDropped();
+        }
+        dirty = dirty || count > 0;
+
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const bool requested = flush_target_.load() > flushed_.load(std::memory_order_relaxed);
+        const bool stopping = stopping_.load(std::memory_order_acquire);
+        const auto now = std::chrono::steady_clock::now();
+        if (requested || stopping || (dirty && (urgent || now - last_flush >= options_.flush.interval))) {
+            flushSinks();
+            dirty = false;
+            last_flush = now;
+            flushed_.store(head, std::memory_order_release);
+            flushed_.notify_all();
+        }
+
+        if (count > 0) {
+            continue;
+        }
+        if (head != tail_.load(std::memory_order_acquire)) {
+            // 生产者已占用槽位但还未提交
+            std::this_thread::yield();
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        if (requested) {
+            continue;
+        }
+        auto timeout = options_.flush.interval;
+        if (dirty) {
+            timeout -= std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush);
+        }
+        waitForRecords(std::max(timeout, std::chrono::milliseconds(1)));
+    }
+}
+
+std::size_t AsyncBackend::drain(bool& urgent) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t count = 0;
+    for (;;) {
+        Cell& cell = cells_[head & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            break;
+        }
+        writeRecord(cell.record);
+        urgent = urgent || cell.record.level >= options_.flush.immediate_level;
+        // 写出后立即归还槽位, 阻塞的生产者可以尽早继续
+        cell.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head++;
+        count++;
+    }
+    head_.store(head, std::memory_order_relaxed);
+    written_.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+void AsyncBackend::writeRecord(const Record& record) {
+    if (has_text_sinks_) {
+        std::string_view message(record.text.data(), record.text.size());
+        if (record.deferred) {
+            message_.clear();
+            try {
+                FormatBinaryArgs(message_, record.format, record.types, message);
+            } catch (const std::exception& e) {
+                message_.clear();
+                fmt::format_to(std::back_inserter(message_), "<format error: {}>", e.what());
+            }
+            message = std::string_view(message_.data(), message_.size());
+        }
+        line_.clear();
+        formatter_.format(line_, record.name, record.level, record.thread_id,
+                          std::chrono::system_clock::time_point(std::chrono::system_clock::duration(record.ticks)),
+                          record.location.file_name(), record.location.line(), record.location.function_name(),
+                          message);
+        writeText(record.level, std::string_view(line_.data(), line_.size()));
+    }
+    if (has_binary_sinks_) {
+        encodeRecord(record);
+    }
+}
+
+void AsyncBackend::encodeRecord(const Record& record) {
+    // 已格式化的消息作为 "{}" 的一个字符串参数
+    static constexpr std::array<ArgType, 1> kTextTypes{ArgType::kString};
+    const SiteKey key{record.format.data(), record.name.data(), record.location.file_name(),
+                      record.location.line(), record.level, record.deferred};
+    BinarySite site;
+    site.level = record.level;
+    site.line = record.location.line();
+    site.types = record.deferred ? record.types : std::span<const ArgType>(kTextTypes);
+    site.name = record.name;
+    site.format = record.deferred ? std::string_view(record.format.data(), record.format.size()) : "{}";
+    site.file = record.location.file_name();
+    site.function = ExtractFunctionName(record.location.function_name());
+
+    binary_.clear();
+    const std::uint32_t id = siteId(key, site);
+    const auto time = std::chrono::system_clock::duration(record.ticks);
+    const std::string_view text(record.text.data(), record.text.size());
+    if (record.deferred) {
+        EncodeLog(binary_, id, std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+                  static_cast<std::uint32_t>(record.thread_id), text);
+    } else {
+        args_.clear();
+        EncodeArg(args_, text);
+        EncodeLog(binary_, id, std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+                  static_cast<std::uint32_t>(record.thread_id), std::string_view(args_.data(), args_.size()));
+    }
+    writeBinary(record.level);
+}
+
+std::uint32_t AsyncBackend::siteId(const SiteKey& key, BinarySite& site) {
+    auto [it, inserted] = sites_.try_emplace(key, static_cast<std::uint32_t>(sites_.size()));
+    if (inserted) {
+        site.id = it->second;
+        EncodeSite(binary_, site);
+    }
+    return it->second;
+}
+
+void AsyncBackend::reportDropped() {
+    static constexpr std::string_view kName{"AsyncBackend"};
+    static constexpr std::string_view kFormat{"{} log records dropped"};
+    const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped == reported_dropped_) {
+        return;
+    }
+    const std::uint64_t count = dropped - reported_dropped_;
+    reported_dropped_ = dropped;
+    if (has_text_sinks_) {
+        const std::string line = fmt::format("[{}][{:5}] {} log records dropped", kName, ToString(LogLevel::kWarn),
+                                             count);
+        writeText(LogLevel::kWarn, line);
+    }
+    if (has_binary_sinks_) {
+        const SiteKey key{kFormat.data(), kName.data(), "", 0, LogLevel::kWarn, true};
+        BinarySite site;
+        site.level = LogLevel::kWarn;
+        site.types = kArgTypes<std::uint64_t>;
+        site.name = kName;
+        site.format = kFormat;
+        binary_.clear();
+        const std::uint32_t id = siteId(key, site);
+        args_.clear();
+        EncodeArg(args_, count);
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        EncodeLog(binary_, id, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), 0,
+                  std::string_view(args_.data(), args_.size()));
+        writeBinary(LogLevel::kWarn);
+    }
+}
+
+void AsyncBackend::writeText(LogLevel level, std::string_view line) {
+    for (const auto& sink : sinks_) {
+        if (!sink->binary()) {
+            sink->write(level, line);
+        }
+    }
+}
+
+void AsyncBackend::writeBinary(LogLevel level) {
+    const std::string_view bytes(binary_.data(), binary_.size());
+    for (const auto& sink : sinks_) {
+        if (sink->binary()) {
+            sink->write(level, bytes);
+        }
+    }
+}
+
+void AsyncBackend::flushSinks() {
+    for (const auto& sink : sinks_) {
+        sink->flush();
+    }
+}
+
+void AsyncBackend::waitForRecords(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.store(true, std::memory_order_seq_cst);
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const bool ready = cells_[head & mask_].sequence.load(std::memory_order_seq_cst) == head + 1;
+    if (ready || stopping_.load(std::memory_order_acquire) || flush_target_.load() > flushed_.load()) {
+        sleeping_.store(false, std::memory_order_relaxed);
+        return;
+    }
+    cv_.wait_for(lock, timeout, [this]() { return !sleeping_.load(std::memory_order_relaxed); });
+    sleeping_.store(false, std::memory_order_relaxed);
+}
+
+void AsyncBackend::wakeUp() {
+    if (sleeping_.exchange(false)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_one();
+    }
+}
+
+}  // namespace pyc
@@ -0,0 +1,209 @@
+#include "logger/binary_log.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/args.h>
+
+namespace pyc {
+
+namespace {
+
+template <typename T>
+void AppendValue(fmt::memory_buffer& out, const T& value) {
+    const char* begin = reinterpret_cast<const char*>(&value);
+    out.append(begin, begin + sizeof(value));
+}
+
+void AppendString(fmt::memory_buffer& out, std::string_view text) {
+    AppendValue(out, static_cast<std::uint32_t>(text.size()));
+    out.append(text.data(), text.data() + text.size());
+}
+
+/// @brief 顺序读取一段字节, 数据不足时抛出异常
+class ByteReader {
+public:
+    explicit ByteReader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view readString() { return take(read<std::uint32_t>()); }
+
+private:
+    std::string_view take(std::size_t size) {
+        if (data_.size() < size) {
+            throw std::runtime_error("truncated binary log arguments");
+        }
+        auto result = data_.substr(0, size);
+        data_.remove_prefix(size);
+        return result;
+    }
+
+private:
+    std::string_view data_;
+};
+
+/// @brief 从流中读取 size 字节
+void ReadExact(std::istream& input, char* data, std::size_t size) {
+    if (!input.read(data, static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("truncated binary log");
+    }
+}
+
+template <typename T>
+T ReadValue(std::istream& input) {
+    T value;
+    ReadExact(input, reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+std::string ReadString(std::istream& input) {
+    std::string text(ReadValue<std::uint32_t>(input), '\0');
+    ReadExact(input, text.data(), text.size());
+    return text;
+}
+
+struct DecodedSite {
+    LogLevel level{LogLevel::kInfo};
+    std::uint32_t line{0};
+    std::vector<ArgType> types{};
+    std::string name{};
+    std::string format{};
+    std::string file{};
+    std::string function{};
+};
+
+}  // namespace
+
+void EncodeSite(fmt::memory_buffer& out, const BinarySite& site) {
+    AppendValue(out, BinaryEntry::kSite);
+    AppendValue(out, site.id);
+    AppendValue(out, static_cast<std::uint8_t>(site.level));
+    AppendValue(out, site.line);
+    AppendValue(out, static_cast<std::uint8_t>(site.types.size()));
+    for (ArgType type : site.types) {
+        AppendValue(out, type);
+    }
+    AppendString(out, site.name);
+    AppendString(out, site.format);
+    AppendString(out, site.file);
+    AppendString(out, site.function);
+}
+
+void EncodeLog(fmt::memory_buffer& out, std::uint32_t site_id, std::int64_t nanoseconds, std::uint32_t thread_id,
+               std::string_view args) {
+    AppendValue(out, BinaryEntry::kLog);
+    AppendValue(out, site_id);
+    AppendValue(out, nanoseconds);
+    AppendValue(out, thread_id);
+    AppendString(out, args);
+}
+
+void FormatBinaryArgs(fmt::memory_buffer& out, fmt::string_view format, std::span<const ArgType> types,
+                      std::string_view args) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    ByteReader reader(args);
+    for (ArgType type : types) {
+        switch (type) {
+            case ArgType::kBool:
+                store.push_back(reader.read<bool>());
+                break;
+            case ArgType::kChar:
+                store.push_back(reader.read<char>());
+                break;
+            case ArgType::kInt64:
+                store.push_back(reader.read<std::int64_t>());
+                break;
+            case ArgType::kUint64:
+                store.push_back(reader.read<std::uint64_t>());
+                break;
+            case ArgType::kFloat:
+                store.push_back(reader.read<float>());
+                break;
+            case ArgType::kDouble:
+                store.push_back(reader.read<double>());
+                break;
+            case ArgType::kString:
+                // 存储会复制字符串, 不依赖 args 的生命周期
+                store.push_back(std::string(reader.readString()));
+                break;
+            case ArgType::kPointer:
+                store.push_back(reinterpret_cast<const void*>(reader.read<std::uintptr_t>()));
+                break;
+            default:
+                throw std::runtime_error("unknown binary log argument type");
+        }
+    }
+    fmt::vformat_to(std::back_inserter(out), format, store);
+}
+
+void DecodeBinaryLog(std::istream& input, const std::function<void(LogLevel, std::string_view)>& output) {
+    std::vector<DecodedSite> sites;
+    LineFormatter formatter;
+    fmt::memory_buffer message;
+    fmt::memory_buffer line;
+    std::string args;
+    std::string magic(kBinaryLogMagic.size(), '\0');
+    for (int kind; (kind = input.peek()) != std::istream::traits_type::eof();) {
+        if (kind == kBinaryLogMagic.front()) {
+            // 新的一段日志流, site id 重新编号
+            ReadExact(input, magic.data(), magic.size());
+            if (magic != kBinaryLogMagic) {
+                throw std::runtime_error("invalid binary log header");
+            }
+            sites.clear();
+            continue;
+        }
+        if (sites.empty() && kind != static_cast<int>(BinaryEntry::kSite)) {
+            throw std::runtime_error("binary log does not start with a header");
+        }
+        input.get();
+        if (kind == static_cast<int>(BinaryEntry::kSite)) {
+            const auto id = ReadValue<std::uint32_t>(input);
+            if (id != sites.size()) {
+                throw std::runtime_error("unexpected binary log site id");
+            }
+            DecodedSite site;
+            site.level = static_cast<LogLevel>(ReadValue<std::uint8_t>(input));
+            site.line = ReadValue<std::uint32_t>(input);
+            site.types.resize(ReadValue<std::uint8_t>(input));
+            for (ArgType& type : site.types) {
+                type = ReadValue<ArgType>(input);
+            }
+            site.name = ReadString(input);
+            site.format = ReadString(input);
+            site.file = ReadString(input);
+            site.function = ReadString(input);
+            sites.push_back(std::move(site));
+        } else if (kind == static_cast<int>(BinaryEntry::kLog)) {
+            const auto id = ReadValue<std::uint32_t>(input);
+            if (id >= sites.size()) {
+                throw std::runtime_error("unknown binary log site id");
+            }
+            const auto nanoseconds = ReadValue<std::int64_t>(input);
+            const auto thread_id = ReadValue<std::uint32_t>(input);
+            args = ReadString(input);
+
+            const DecodedSite& site = sites[id];
+            message.clear();
+            FormatBinaryArgs(message, site.format, site.types, args);
+            line.clear();
+            const std::chrono::system_clock::time_point time{
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(nanoseconds))};
+            formatter.format(line, site.name, site.level, thread_id, time, site.file, site.line, site.function,
+                             std::string_view(message.data(), message.size()));
+            output(site.level, std::string_view(line.data(), line.size()));
+        } else {
+            throw std::runtime_error("unknown binary log entry");
+        }
+    }
+}
+
+}  // namespace pyc
@@ -0,0 +1,39 @@
+#include "logger/log_format.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+#include <fmt/chrono.h>
+
+namespace pyc {
+
+std::optional<LogLevel> ParseLogLevel(std::string_view name) noexcept {
+    constexpr LogLevel kLevels[] = {LogLevel::kDebug, LogLevel::kInfo, LogLevel::kWarn, LogLevel::kError,
+                                    LogLevel::kFatal};
+    for (LogLevel level : kLevels) {
+        const std::string_view expected = ToString(level);
+        if (std::equal(name.begin(), name.end(), expected.begin(), expected.end(), [](char lhs, char rhs) {
+                return std::toupper(static_cast<unsigned char>(lhs)) == rhs;
+            })) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+void LineFormatter::format(fmt::memory_buffer& out, std::string_view name, LogLevel level, std::size_t thread_id,
+                           std::chrono::system_clock::time_point time, std::string_view file, std::uint32_t line,
+                           std::string_view function, std::string_view message) {
+    using namespace std::chrono;
+    const std::int64_t ms = duration_cast<milliseconds>(time.time_since_epoch()).count();
+    const std::int64_t second = ms / 1000;
+    if (second != cached_second_) {
+        cached_second_ = second;
+        cached_time_ = fmt::format("{:%Y-%m-%d %H:%M:%S}", floor<seconds>(time));
+    }
+    fmt::format_to(std::back_inserter(out), "[{}][{:5}][{:0>5}][{}.{:03}] <{}:{}> [{}] {}", name, ToString(level),
+                   thread_id, cached_time_, ms % 1000, file, line, ExtractFunctionName(function), message);
+}
+
+}  // namespace pyc
@@ -0,0 +1,50 @@
+#include "logger/log_sink.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include "logger/binary_log.h"
+
+namespace pyc {
+
+void ConsoleSink::write(LogLevel level, std::string_view line) {
+    if (color_) {
+        fmt::print(stdout, ToTextStyle(level), "{}\n", line);
+    } else {
+        fmt::print(stdout, "{}\n", line);
+    }
+}
+
+void ConsoleSink::flush() { std::fflush(stdout); }
+
+FileSink::FileSink(const std::string& path) : file_(std::fopen(path.c_str(), "a")) {
+    if (!file_) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, kBufferSize);
+}
+
+FileSink::~FileSink() { std::fclose(file_); }
+
+void FileSink::write(LogLevel, std::string_view line) {
+    std::fwrite(line.data(), 1, line.size(), file_);
+    std::fputc('\n', file_);
+}
+
+void FileSink::flush() { std::fflush(file_); }
+
+BinaryFileSink::BinaryFileSink(const std::string& path) : file_(std::fopen(path.c_str(), "ab")) {
+    if (!file_) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, FileSink::kBufferSize);
+    std::fwrite(kBinaryLogMagic.data(), 1, kBinaryLogMagic.size(), file_);
+}
+
+BinaryFileSink::~BinaryFileSink() { std::fclose(file_); }
+
+void BinaryFileSink::write(LogLevel, std::string_view bytes) { std::fwrite(bytes.data(), 1, bytes.size(), file_); }
+
+void BinaryFileSink::flush() { std::fflush(file_); }
+
+}  // namespace pyc
@@ -1,76 +1,189 @@
 #include "logger/logger.h"
 
 #include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <fmt/chrono.h>
 #include <fmt/color.h>
 
+#include "common/string_hash.h"
 #include "common/thread_id.h"
+#include "logger/async_backend.h"
 
 namespace pyc {
 
-consteval inline std::string_view ToString(LogLevel level) noexcept {
-    switch (level) {
-        case LogLevel::kDebug:
-            return "DEBUG";
-        case LogLevel::kInfo:
-            return "INFO";
-        case LogLevel::kWarn:
-            return "WARN";
-        case LogLevel::kError:
-            return "ERROR";
-        case LogLevel::kFatal:
-            return "FATAL";
+namespace {
+
+/// @brief 按名字保存运行期阈值, 每个名字一个地址不变的原子变量, Logger 第一次使用时取得其地址
+/// 有意不析构, 静态对象析构时仍然可以写日志
+class LevelRegistry {
+public:
+    static LevelRegistry& GetInstance() {
+        static auto* instance = new LevelRegistry();
+        return *instance;
     }
-    return "UNKNOWN";
-}
 
-consteval inline fmt::text_style ToTextStyle(LogLevel level) noexcept {
-    switch (level) {
-        case LogLevel::kDebug:
-            return fg(fmt::color::cyan);
-        case LogLevel::kInfo:
-            return fg(fmt::color::green);
-        case LogLevel::kWarn:
-            return fg(fmt::color::yellow);
-        case LogLevel::kError:
-            return fg(fmt::color::red);
-        case LogLevel::kFatal:
-            return fg(fmt::color::dark_orange) | fmt::emphasis::reverse | fmt::emphasis::bold;
+    const std::atomic<LogLevel>& threshold(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return find(name).level;
+    }
+
+    void set(std::string_view name, LogLevel level) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot& slot = find(name);
+        slot.overridden = true;
+        slot.level.store(level, std::memory_order_relaxed);
     }
-    return {};
-}
 
-constexpr std::string_view ExtractFunctionName(std::string_view full_name) noexcept {
-    auto end_pos = full_name.find_last_of('(');
-    if (end_pos != std::string::npos) {
-        auto start_pos = full_name.rfind("::", end_pos);
-        if (start_pos != std::string::npos) {
-            start_pos += 2;
-        } else {
-            start_pos = full_name.rfind(' ', end_pos);
-            if (start_pos != std::string::npos) {
-                start_pos++;
-            } else {
-                return full_name.substr(0, end_pos);
+    void reset(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Slot& slot = find(name);
+        slot.overridden = false;
+        slot.level.store(default_level_, std::memory_order_relaxed);
+    }
+
+    void setDefault(LogLevel level) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        setDefaultLocked(level);
+    }
+
+    /// @brief 在同一次加锁中应用默认阈值和各个名字的阈值
+    void apply(std::optional<LogLevel> default_level,
+               const std::vector<std::pair<std::string, LogLevel>>& levels) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (default_level) {
+            setDefaultLocked(*default_level);
+        }
+        for (const auto& [name, level] : levels) {
+            Slot& slot = find(name);
+            slot.overridden = true;
+            slot.level.store(level, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<LogLevel> level;
+        bool overridden{false};  // 是否单独设置过, 否则跟随默认阈值
+    };
+
+    LevelRegistry() = default;
+
+    Slot& find(std::string_view name) {
+        auto it = slots_.find(name);
+        if (it == slots_.end()) {
+            auto slot = std::make_unique<Slot>();
+            slot->level.store(default_level_, std::memory_order_relaxed);
+            it = slots_.emplace(std::string(name), std::move(slot)).first;
+        }
+        return *it->second;
+    }
+
+    void setDefaultLocked(LogLevel level) {
+        default_level_ = level;
+        for (auto& [name, slot] : slots_) {
+            if (!slot->overridden) {
+                slot->level.store(level, std::memory_order_relaxed);
             }
         }
-        return full_name.substr(start_pos, end_pos - start_pos);
     }
-    return full_name;
+
+private:
+    std::mutex mutex_;
+    LogLevel default_level_{LogLevel::kDebug};
+    std::unordered_map<std::string, std::unique_ptr<Slot>, StringHash, StringEqual> slots_;
+};
+
+std::string_view Trim(std::string_view text) {
+    const auto begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const auto end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+}  // namespace
+
+const std::atomic<LogLevel>& Logger::resolveThreshold(std::string_view name) {
+    return LevelRegistry::GetInstance().threshold(name);
+}
+
+void Logger::setLevel(std::string_view name, LogLevel level) { LevelRegistry::GetInstance().set(name, level); }
+
+void Logger::resetLevel(std::string_view name) { LevelRegistry::GetInstance().reset(name); }
+
+void Logger::setDefaultLevel(LogLevel level) { LevelRegistry::GetInstance().setDefault(level); }
+
+LogLevel Logger::getLevel(std::string_view name) {
+    return LevelRegistry::GetInstance().threshold(name).load(std::memory_order_relaxed);
+}
+
+void Logger::configure(std::string_view spec) {
+    // 先完整解析, 出错时不修改任何阈值
+    std::optional<LogLevel> default_level;
+    std::vector<std::pair<std::string, LogLevel>> levels;
+    while (!spec.empty()) {
+        const auto comma = spec.find(',');
+        const std::string_view item = Trim(spec.substr(0, comma));
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+        if (item.empty()) {
+            continue;
+        }
+        const auto equal = item.find('=');
+        const std::string_view level_name = Trim(equal == std::string_view::npos ? item : item.substr(equal + 1));
+        const auto level = ParseLogLevel(level_name);
+        if (!level) {
+            throw std::invalid_argument(fmt::format("invalid log level '{}'", level_name));
+        }
+        if (equal == std::string_view::npos) {
+            default_level = level;
+            continue;
+        }
+        const std::string_view name = Trim(item.substr(0, equal));
+        if (name.empty()) {
+            throw std::invalid_argument(fmt::format("missing logger name in '{}'", item));
+        }
+        levels.emplace_back(std::string(name), *level);
+    }
+    LevelRegistry::GetInstance().apply(default_level, levels);
 }
 
 template <LogLevel level>
-void Logger::log(std::string_view msg, const std::source_location location) const {
+void Logger::log(fmt::string_view fmt, fmt::format_args args, const std::source_location location) const {
+    if (AsyncBackend::Guard backend; backend) {
+        backend->push(level, name_, location, fmt, args);
+        if constexpr (level == LogLevel::kFatal) {
+            // 进程随后退出, 先等待日志写出
+            backend->flush();
+        }
+        return;
+    }
+    fmt::memory_buffer msg;
+    fmt::vformat_to(std::back_inserter(msg), fmt, args);
     fmt::print(ToTextStyle(level), "[{}][{:5}][{:0>5}][{:%Y-%m-%d %H:%M:%S}] <{}:{}> [{}] {}\n", name_,
                ToString(level), ShortThreadId(), std::chrono::system_clock::now(), location.file_name(),
-               location.line(), ExtractFunctionName(location.function_name()), msg);
+               location.line(), ExtractFunctionName(location.function_name()),
+               std::string_view(msg.data(), msg.size()));
 }
 
-template void Logger::log<LogLevel::kDebug>(std::string_view msg, const std::source_location location) const;
-template void Logger::log<LogLevel::kInfo>(std::string_view msg, const std::source_location location) const;
-template void Logger::log<LogLevel::kWarn>(std::string_view msg, const std::source_location location) const;
-template void Logger::log<LogLevel::kError>(std::string_view msg, const std::source_location location) const;
-template void Logger::log<LogLevel::kFatal>(std::string_view msg, const std::source_location location) const;
+template void Logger::log<LogLevel::kDebug>(fmt::string_view fmt, fmt::format_args args,
+                                            const std::source_location location) const;
+template void Logger::log<LogLevel::kInfo>(fmt::string_view fmt, fmt::format_args args,
+                                           const std::source_location location) const;
+template void Logger::log<LogLevel::kWarn>(fmt::string_view fmt, fmt::format_args args,
+                                           const std::source_location location) const;
+template void Logger::log<LogLevel::kError>(fmt::string_view fmt, fmt::format_args args,
+                                            const std::source_location location) const;
+template void Logger::log<LogLevel::kFatal>(fmt::string_view fmt, fmt::format_args args,
+                                            const std::source_location location) const;
 
 }  // namespace pyc
\ No newline at end of file
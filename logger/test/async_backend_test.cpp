@@ -0,0 +1,196 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logger/async_backend.h"
+#include "logger/binary_log.h"
+#include "logger/logger.h"
+
+namespace pyc {
+
+namespace {
+
+/// @brief 记录写入的行, 可以暂停写入以填满环形缓冲区
+class MemorySink : public LogSink {
+public:
+    struct State {
+        std::mutex mutex;
+        std::vector<std::string> lines;
+        std::atomic<bool> paused{false};
+        std::atomic<int> flushes{0};
+    };
+
+    explicit MemorySink(State& state) : state_(state) {}
+
+    void write(LogLevel, std::string_view line) override {
+        while (state_.paused.load()) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(state_.mutex);
+        state_.lines.emplace_back(line);
+    }
+
+    void flush() override { state_.flushes++; }
+
+private:
+    State& state_;
+};
+
+}  // namespace
+
+TEST(AsyncBackendTest, MultiThreadTest) {
+    const auto path =
+        std::filesystem::temp_directory_path() / ("async_backend_test_" + std::to_string(::getpid()));
+    MemorySink::State state;
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    sinks.push_back(std::make_unique<MemorySink>(state));
+    sinks.push_back(std::make_unique<FileSink>(path.string()));
+    AsyncBackend::start(std::move(sinks), {.capacity = 64});
+
+    constexpr int kThreads = 4;
+    constexpr int kLines = 1000;
+    Logger logger("async");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&logger, i]() {
+            for (int j = 0; j < kLines; j++) {
+                logger.info("thread {} line {}", i, j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    AsyncBackend::Guard()->flush();
+    EXPECT_EQ(AsyncBackend::Guard()->metrics().written, static_cast<std::uint64_t>(kThreads * kLines));
+    EXPECT_EQ(AsyncBackend::Guard()->metrics().dropped, 0U);
+    AsyncBackend::stop();
+
+    ASSERT_EQ(state.lines.size(), static_cast<std::size_t>(kThreads * kLines));
+    EXPECT_NE(state.lines.front().find("[async][INFO ]"), std::string::npos);
+    // 同一线程的日志保持顺序
+    int last = -1;
+    for (const auto& line : state.lines) {
+        if (line.find("thread 0 line ") != std::string::npos) {
+            const int index = std::stoi(line.substr(line.rfind(' ') + 1));
+            EXPECT_EQ(index, last + 1);
+            last = index;
+        }
+    }
+    EXPECT_EQ(last, kLines - 1);
+
+    std::ifstream file(path);
+    std::size_t file_lines = 0;
+    for (std::string line; std::getline(file, line);) {
+        file_lines++;
+    }
+    EXPECT_EQ(file_lines, static_cast<std::size_t>(kThreads * kLines));
+    std::filesystem::remove(path);
+}
+
+TEST(AsyncBackendTest, OverflowTest) {
+    MemorySink::State state;
+    state.paused = true;
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    sinks.push_back(std::make_unique<MemorySink>(state));
+    AsyncBackend::start(std::move(sinks), {.capacity = 8, .overflow = OverflowPolicy::kCount});
+
+    Logger logger("overflow");
+    for (int i = 0; i < 100; i++) {
+        logger.debug("line {}", i);
+    }
+    EXPECT_GT(AsyncBackend::Guard()->metrics().dropped, 0U);
+    state.paused = false;
+    AsyncBackend::Guard()->flush();
+    logger.error("after");
+    AsyncBackend::Guard()->flush();
+    const auto metrics = AsyncBackend::Guard()->metrics();
+    AsyncBackend::stop();
+
+    EXPECT_EQ(metrics.written + metrics.dropped, 101U);
+    // 丢弃的条数以一行警告补充在输出中
+    bool reported = false;
+    for (const auto& line : state.lines) {
+        reported = reported || line.find("log records dropped") != std::string::npos;
+    }
+    EXPECT_TRUE(reported);
+    EXPECT_NE(state.lines.back().find("[overflow][ERROR]"), std::string::npos);
+    EXPECT_GT(state.flushes.load(), 0);
+}
+
+TEST(AsyncBackendTest, RestartWhileLoggingTest) {
+    // 其他线程持续写日志时替换和卸载后端, 旧后端在使用它的调用者结束后才销毁
+    MemorySink::State state;
+    std::atomic<bool> running{true};
+    Logger logger("restart");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&logger, &running, i]() {
+            for (int j = 0; running.load(); j++) {
+                logger.info("thread {} line {}", i, j);
+            }
+        });
+    }
+    for (int i = 0; i < 20; i++) {
+        std::vector<std::unique_ptr<LogSink>> sinks;
+        sinks.push_back(std::make_unique<MemorySink>(state));
+        AsyncBackend::start(std::move(sinks), {.capacity = 16});
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    AsyncBackend::stop();
+    EXPECT_FALSE(AsyncBackend::Guard());
+    running = false;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(state.lines.empty());
+}
+
+TEST(AsyncBackendTest, DeferredFormatTest) {
+    const auto path =
+        std::filesystem::temp_directory_path() / ("async_backend_binary_" + std::to_string(::getpid()));
+    MemorySink::State state;
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    sinks.push_back(std::make_unique<MemorySink>(state));
+    sinks.push_back(std::make_unique<BinaryFileSink>(path.string()));
+    AsyncBackend::start(std::move(sinks), {.deferred_format = true});
+
+    Logger logger("binary");
+    const std::string text = "string";
+    for (int i = 0; i < 100; i++) {
+        logger.info("{} {:>4} {:x} {} {:.2f} {}", i, -7, 255U, true, 2.5, 'c');
+        logger.warn("{} {} {} {}", text, std::string_view("view"), "literal", 1.25f);
+    }
+    // long double 不能按原始字节保存, 在调用线程上格式化
+    logger.error("{}", 1.5L);
+    AsyncBackend::stop();
+
+    ASSERT_EQ(state.lines.size(), 201U);
+    EXPECT_NE(state.lines[0].find("] 0   -7 ff true 2.50 c"), std::string::npos);
+    EXPECT_NE(state.lines[1].find("] string view literal 1.25"), std::string::npos);
+    EXPECT_NE(state.lines.back().find("] 1.5"), std::string::npos);
+
+    // 离线解码得到与文本 sink 相同的内容
+    std::vector<std::string> decoded;
+    std::ifstream file(path, std::ios::binary);
+    DecodeBinaryLog(file, [&decoded](LogLevel, std::string_view line) { decoded.emplace_back(line); });
+    EXPECT_EQ(decoded, state.lines);
+    // 同一日志点只写出一次定义, 之后每条只有参数
+    std::size_t text_size = 0;
+    for (const auto& line : state.lines) {
+        text_size += line.size() + 1;
+    }
+    EXPECT_LT(std::filesystem::file_size(path) * 3, text_size * 2);
+    std::filesystem::remove(path);
+}
+
+}  // namespace pyc
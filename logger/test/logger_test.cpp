@@ -1,3 +1,5 @@
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 
 #include "logger/logger.h"
@@ -13,4 +15,40 @@ TEST(LoggerTest, LogTest) {
     EXPECT_EXIT(logger.fatal("{}", "Hello, World!"), ::testing::ExitedWithCode(EXIT_FAILURE), "");
 }
 
-}  // namespace pyc
+TEST(LoggerTest, LevelTest) {
+    EXPECT_EQ(ParseLogLevel("warn"), LogLevel::kWarn);
+    EXPECT_EQ(ParseLogLevel("ERROR"), LogLevel::kError);
+    EXPECT_FALSE(ParseLogLevel("verbose"));
+
+    Logger logger("LevelTest");
+    EXPECT_TRUE(logger.enabled(LogLevel::kDebug));
+    Logger::setLevel("LevelTest", LogLevel::kWarn);
+    EXPECT_FALSE(logger.enabled(LogLevel::kInfo));
+    EXPECT_TRUE(logger.enabled(LogLevel::kWarn));
+
+    // 关闭的级别不求值参数
+    int evaluated = 0;
+    auto evaluate = [&evaluated]() { return ++evaluated; };
+    PYC_LOG_INFO(logger, "{}", evaluate());
+    EXPECT_EQ(evaluated, 0);
+    PYC_LOG_WARN(logger, "{}", evaluate());
+    EXPECT_EQ(evaluated, 1);
+
+    // 默认阈值不影响单独设置过的名字
+    Logger::setDefaultLevel(LogLevel::kError);
+    EXPECT_FALSE(Logger("LevelTestOther").enabled(LogLevel::kWarn));
+    EXPECT_TRUE(logger.enabled(LogLevel::kWarn));
+
+    Logger::configure("debug, LevelTest = error");
+    EXPECT_TRUE(Logger("LevelTestOther").enabled(LogLevel::kDebug));
+    EXPECT_FALSE(logger.enabled(LogLevel::kWarn));
+    // 格式错误时不修改任何阈值
+    EXPECT_THROW(Logger::configure("info,LevelTest=verbose"), std::invalid_argument);
+    EXPECT_EQ(Logger::getLevel("LevelTest"), LogLevel::kError);
+    EXPECT_EQ(Logger::getLevel("LevelTestOther"), LogLevel::kDebug);
+
+    Logger::resetLevel("LevelTest");
+    EXPECT_TRUE(logger.enabled(LogLevel::kDebug));
+}
+
+}  // namespace pyc
\ No newline at end of file
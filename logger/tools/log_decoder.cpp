@@ -0,0 +1,28 @@
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+#include <fmt/format.h>
+
+#include "logger/binary_log.h"
+
+/// @brief 把 BinaryFileSink 写出的二进制日志还原为文本, 输出到标准输出
+/// 例: log_decoder app.binlog > app.log
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fmt::print(stderr, "Usage: {} <binary log file>\n", argv[0]);
+        return 1;
+    }
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        fmt::print(stderr, "Cannot open {}\n", argv[1]);
+        return 1;
+    }
+    try {
+        pyc::DecodeBinaryLog(input, [](pyc::LogLevel, std::string_view line) { fmt::print("{}\n", line); });
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "Decode failed: {}\n", e.what());
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <fmt/base.h>
+#include <gflags/gflags.h>
+#include <nlohmann/json.hpp>
+
+#include "network/base/latency_histogram.h"
+#include "network/msg_node.h"
+#include "network/utils.h"
+
+namespace asio = boost::asio;
+
+using namespace network;
+using namespace std::literals::chrono_literals;
+
+DEFINE_string(host, "127.0.0.1", "server address");
+DEFINE_uint32(port, 10086, "server port");
+DEFINE_uint32(connections, 100, "number of connections");
+DEFINE_uint32(threads, 4, "number of client io threads");
+DEFINE_double(rate, 10000, "total requests per second over all connections (open loop)");
+DEFINE_double(duration, 10, "measurement duration in seconds");
+DEFINE_double(warmup, 1, "seconds to send before recording latencies");
+DEFINE_uint32(payload, 16, "request data size in bytes");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief 单个线程的统计结果, 结束后汇总
+struct Stats {
+    LatencyHistogram latency{};  // 纳秒
+    std::uint64_t sent{0};
+    std::uint64_t received{0};
+    std::uint64_t errors{0};
+};
+
+/// @brief 压测配置, 所有连接共享
+struct LoadConfig {
+    asio::ip::tcp::endpoint endpoint;
+    std::string request;             // 已编码的请求帧, 每次发送同一份数据
+    Clock::duration interval;        // 单个连接的请求间隔
+    Clock::time_point record_begin;  // 之后发送的请求计入延迟统计
+    Clock::time_point send_end;      // 之后不再发送
+    Clock::time_point drain_end;     // 之后不再等待响应
+};
+
+/// @brief 一个压测连接
+/// 开环发送: 请求按固定间隔的计划时间发出, 不等待上一个响应, 延迟从计划时间开始计算,
+/// 服务器变慢时请求在客户端排队的时间也计入延迟, 避免协同遗漏 (coordinated omission) 低估尾延迟
+class LoadConnection : public std::enable_shared_from_this<LoadConnection> {
+public:
+    LoadConnection(asio::io_context& io_context, const LoadConfig& config, Stats& stats)
+        : socket_(io_context), timer_(io_context), config_(config), stats_(stats) {}
+
+    void Start(Clock::time_point first_send) {
+        next_send_ = first_send;
+        socket_.async_connect(config_.endpoint,
+                              [shared_this = shared_from_this()](const boost::system::error_code& error_code) {
+                                  if (error_code) {
+                                      shared_this->Fail(error_code);
+                                      return;
+                                  }
+                                  shared_this->socket_.set_option(asio::ip::tcp::no_delay(true));
+                                  shared_this->ScheduleSend();
+                                  shared_this->AsyncRead();
+                              });
+    }
+
+private:
+    void ScheduleSend() {
+        if (next_send_ >= config_.send_end) {
+            // 发送结束, 等待剩余响应到 drain_end 后关闭
+            timer_.expires_at(config_.drain_end);
+            timer_.async_wait([shared_this = shared_from_this()](const boost::system::error_code& error_code) {
+                if (!error_code) {
+                    shared_this->Close();
+                }
+            });
+            return;
+        }
+        timer_.expires_at(next_send_);
+        timer_.async_wait([shared_this = shared_from_this()](const boost::system::error_code& error_code) {
+            if (!error_code) {
+                shared_this->HandleTimer();
+            }
+        });
+    }
+
+    void HandleTimer() {
+        if (closed_) {
+            return;
+        }
+        // 定时器可能晚于计划时间触发, 补发期间所有到期的请求
+        const auto now = Clock::now();
+        while (next_send_ <= now && next_send_ < config_.send_end) {
+            in_flight_.push_back(next_send_);
+            pending_write_.append(config_.request);
+            stats_.sent++;
+            next_send_ += config_.interval;
+        }
+        AsyncWrite();
+        ScheduleSend();
+    }
+
+    void AsyncWrite() {
+        if (writing_ || pending_write_.empty() || closed_) {
+            return;
+        }
+        writing_ = true;
+        writing_data_.swap(pending_write_);
+        asio::async_write(
+            socket_, asio::buffer(writing_data_),
+            [shared_this = shared_from_this()](const boost::system::error_code& error_code, std::size_t) {
+                shared_this->writing_ = false;
+                shared_this->writing_data_.clear();
+                if (error_code) {
+                    shared_this->Fail(error_code);
+                    return;
+                }
+                shared_this->AsyncWrite();
+            });
+    }
+
+    void AsyncRead() {
+        if (recv_buffer_.size() - recv_size_ < kReadSize) {
+            recv_buffer_.resize(recv_size_ + kReadSize);
+        }
+        socket_.async_read_some(
+            asio::buffer(recv_buffer_.data() + recv_size_, recv_buffer_.size() - recv_size_),
+            [shared_this = shared_from_this()](const boost::system::error_code& error_code,
+                                               std::size_t bytes_transferred) {
+                if (error_code) {
+                    shared_this->Fail(error_code);
+                    return;
+                }
+                shared_this->recv_size_ += bytes_transferred;
+                shared_this->ParseResponses();
+                shared_this->AsyncRead();
+            });
+    }
+
+    void ParseResponses() {
+        const auto now = Clock::now();
+        std::size_t offset = 0;
+        while (recv_size_ - offset >= kHeadLength) {
+            MsgHead head = MsgHead::ParseHead(recv_buffer_.data() + offset);
+            if (recv_size_ - offset < kHeadLength + head.length) {
+                break;
+            }
+            offset += kHeadLength + head.length;
+            // 服务器开启空闲检测时可能发送心跳
+            if (head.id == MsgId::kMsgHeartbeat) {
+                continue;
+            }
+            if (in_flight_.empty()) {
+                stats_.errors++;
+                continue;
+            }
+            const auto scheduled = in_flight_.front();
+            in_flight_.pop_front();
+            stats_.received++;
+            if (scheduled >= config_.record_begin) {
+                stats_.latency.Record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - scheduled).count()));
+            }
+        }
+        recv_buffer_.erase(recv_buffer_.begin(), recv_buffer_.begin() + static_cast<std::ptrdiff_t>(offset));
+        recv_size_ -= offset;
+
+        if (next_send_ >= config_.send_end && in_flight_.empty()) {
+            Close();
+        }
+    }
+
+    void Fail(const boost::system::error_code& error_code) {
+        if (closed_) {
+            return;
+        }
+        fmt::println(stderr, "[{}]: Error code = {}. Message: {}", __func__, error_code.value(),
+                     error_code.message());
+        Close();
+    }
+
+    void Close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        // 未收到响应的请求计为错误
+        stats_.errors += in_flight_.size();
+        in_flight_.clear();
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+        timer_.cancel();
+    }
+
+private:
+    static constexpr std::size_t kReadSize = 16 * 1024;
+
+    asio::ip::tcp::socket socket_;
+    asio::steady_timer timer_;
+    const LoadConfig& config_;
+    Stats& stats_;
+    Clock::time_point next_send_{};
+    std::deque<Clock::time_point> in_flight_{};  // 已发送请求的计划时间, 响应按请求顺序返回
+    std::string pending_write_{};
+    std::string writing_data_{};
+    bool writing_{false};
+    bool closed_{false};
+    std::vector<char> recv_buffer_{};
+    std::size_t recv_size_{0};
+};
+
+std::string MakeRequest(std::size_t payload) {
+    nlohmann::json root;
+    root["id"] = MsgId::kMsgHelloWorld;
+    root["data"] = std::string(payload, 'x');
+    std::string body = root.dump();
+    SendNode node(body.data(), static_cast<MsgSizeType>(body.size()), MsgId::kMsgHelloWorld);
+    return std::string(node.Data(), node.Size());
+}
+
+double ToMicros(std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+}  // namespace
+
+/// @brief TLV 服务器的开环压测工具, 结果以 JSON 输出到标准输出
+/// 例: load_generator --port=10086 --connections=200 --rate=50000 --duration=30
+int main(int argc, char* argv[]) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+    const std::size_t connections = std::max<std::uint32_t>(FLAGS_connections, 1);
+    const std::size_t thread_num = std::clamp<std::size_t>(FLAGS_threads, 1, connections);
+    // 响应会在请求的 data 前加上说明文字, 预留空间保证响应仍是 v1 帧
+    const std::size_t payload = std::min<std::size_t>(FLAGS_payload, kMaxLength / 2);
+    if (FLAGS_rate <= 0 || FLAGS_duration <= 0) {
+        fmt::println(stderr, "rate and duration must be positive");
+        return 1;
+    }
+
+    LoadConfig config;
+    try {
+        config.endpoint = asio::ip::tcp::endpoint(asio::ip::make_address(FLAGS_host),
+                                                  static_cast<unsigned short>(FLAGS_port));
+    } catch (const std::exception& e) {
+        fmt::println(stderr, "Invalid host {}: {}", FLAGS_host, e.what());
+        return 1;
+    }
+    config.request = MakeRequest(payload);
+    config.interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(connections) / FLAGS_rate));
+    const auto start = Clock::now() + 100ms;  // 留出建立连接的时间
+    const auto warmup = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(FLAGS_warmup));
+    const auto duration =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(FLAGS_duration));
+    config.record_begin = start + warmup;
+    config.send_end = config.record_begin + duration;
+    config.drain_end = config.send_end + 2s;
+
+    std::vector<std::unique_ptr<asio::io_context>> io_contexts;
+    std::vector<Stats> stats(thread_num);
+    for (std::size_t i = 0; i < thread_num; i++) {
+        io_contexts.push_back(std::make_unique<asio::io_context>(1));
+    }
+    for (std::size_t i = 0; i < connections; i++) {
+        // 各连接的首次发送均匀错开, 使总请求速率平滑
+        const auto offset = config.interval * static_cast<long>(i) / static_cast<long>(connections);
+        auto connection =
+            std::make_shared<LoadConnection>(*io_contexts[i % thread_num], config, stats[i % thread_num]);
+        connection->Start(start + offset);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_num);
+    for (auto& io_context : io_contexts) {
+        threads.emplace_back([&io_context]() { io_context->run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Stats total;
+    for (const auto& item : stats) {
+        total.latency.Merge(item.latency);
+        total.sent += item.sent;
+        total.received += item.received;
+        total.errors += item.errors;
+    }
+
+    const double seconds = std::chrono::duration<double>(duration).count();
+    nlohmann::json result;
+    result["server"] = fmt::format("{}:{}", FLAGS_host, FLAGS_port);
+    result["connections"] = connections;
+    result["threads"] = thread_num;
+    result["target_rate"] = FLAGS_rate;
+    result["duration_s"] = seconds;
+    result["warmup_s"] = FLAGS_warmup;
+    result["payload_bytes"] = payload;
+    result["sent"] = total.sent;
+    result["received"] = total.received;
+    result["errors"] = total.errors;
+    result["qps"] = static_cast<double>(total.latency.Count()) / seconds;
+    result["latency_us"] = {
+        {"count", total.latency.Count()},
+        {"min", ToMicros(total.latency.Min())},
+        {"mean", total.latency.Mean() / 1000.0},
+        {"p50", ToMicros(total.latency.ValueAtPercentile(50))},
+        {"p90", ToMicros(total.latency.ValueAtPercentile(90))},
+        {"p99", ToMicros(total.latency.ValueAtPercentile(99))},
+        {"p999", ToMicros(total.latency.ValueAtPercentile(99.9))},
+        {"max", ToMicros(total.latency.Max())},
+    };
+    fmt::println("{}", result.dump(4));
+
+    gflags::ShutDownCommandLineFlags();
+    return total.errors == 0 ? 0 : 2;
+}
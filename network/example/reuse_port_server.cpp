@@ -0,0 +1,24 @@
+#include "network/io_service_pool/reuse_port_server.h"
+
+#include <iostream>
+
+#include "network/io_service_pool/io_service_pool_session.h"
+
+int main() {
+    try {
+        auto& pool = network::IOServicePool::GetInstance();
+        boost::asio::io_context io_context;
+        boost::asio::signal_set signals(io_context, SIGINT, SIGTERM);
+        signals.async_wait([&](auto, auto) {
+            io_context.stop();
+            pool.Stop();
+        });
+        network::ReusePortServer<network::IOServicePoolSession> server(io_context, 10086);
+        server.StartAccept();
+        io_context.run();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+
+    return 0;
+}
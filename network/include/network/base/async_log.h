@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "common/noncopyable.h"
+#include "network/base/mpsc_queue.h"
+
+/// @brief 编译期最低日志级别 (LogLevel 的数值), 低于该级别的 NET_LOG_* 整条语句被丢弃, 参数也不会求值
+/// 默认丢弃 kDebug, 构建时定义 NETWORK_MIN_LOG_LEVEL=0 开启
+#ifndef NETWORK_MIN_LOG_LEVEL
+#define NETWORK_MIN_LOG_LEVEL 1
+#endif
+
+namespace network {
+
+enum class LogLevel : std::uint8_t {
+    kDebug = 0,
+    kInfo = 1,
+    kWarn = 2,
+    kError = 3,
+};
+
+/// @brief 日志运行指标快照
+struct LogMetrics {
+    std::uint64_t written{0};     // 已写出的行数
+    std::uint64_t dropped{0};     // 待写队列已满而丢弃的行数
+    std::uint64_t suppressed{0};  // 被单点限流丢弃的行数
+};
+
+/// @brief 单个日志点的限流器, 每秒最多放行 per_second 条, 由 NET_LOG_* 为每个调用点生成一个静态实例
+/// 固定一秒窗口, 只有原子操作; 被丢弃的条数附加在下一条放行的日志后面
+class LogRateLimiter : public pyc::Noncopyable {
+public:
+    explicit LogRateLimiter(std::uint32_t per_second) : per_second_(per_second) {}
+
+    /// @brief 放行时返回 true, suppressed 为上次放行以来被丢弃的条数
+    bool Allow(std::uint64_t& suppressed);
+
+private:
+    const std::uint32_t per_second_;
+    std::atomic<std::int64_t> window_{0};  // 当前窗口的起始秒
+    std::atomic<std::uint32_t> count_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+};
+
+/// @brief 异步日志, io 线程只格式化消息并无锁入队, 由后台线程批量写出, 不会阻塞在终端或文件输出上
+/// - 入队使用 MpscQueue, 队列从空变为非空时才唤醒写线程
+/// - 待写行数超过 kMaxPending 时丢弃新日志并计数, 写出速度跟不上时不会无限占用内存
+/// - 实例从不析构, 进程退出时 (atexit) 停止写线程并写出剩余日志, 之后的日志直接同步写出,
+///   其他单例在析构函数中仍然可以使用
+class AsyncLog : public pyc::Noncopyable {
+public:
+    static constexpr std::size_t kMaxPending = 64 * 1024;
+    static constexpr std::uint32_t kDefaultRatePerSite = 100;  // 每个日志点每秒最多写出的条数
+
+    static AsyncLog& GetInstance();
+
+    /// @brief 格式化并写入一条日志, 由 NET_LOG_* 调用
+    template <typename... Args>
+    void Log(LogLevel level, LogRateLimiter& limiter, std::string_view function,
+             fmt::format_string<Args...> format, Args&&... args) {
+        if (level < MinLevel()) {
+            return;
+        }
+        std::uint64_t suppressed = 0;
+        if (!limiter.Allow(suppressed)) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto record = std::make_unique<Record>();
+        auto out = std::back_inserter(record->text);
+        fmt::format_to(out, "[{}][{}]: ", ToString(level), function);
+        fmt::format_to(out, format, std::forward<Args>(args)...);
+        if (suppressed != 0) {
+            fmt::format_to(out, " ({} similar messages suppressed)", suppressed);
+        }
+        record->text.push_back('\n');
+        Push(std::move(record));
+    }
+
+    /// @brief 运行期最低日志级别, 只能比编译期级别更高
+    void SetMinLevel(LogLevel level) { min_level_.store(level, std::memory_order_relaxed); }
+
+    LogLevel MinLevel() const { return min_level_.load(std::memory_order_relaxed); }
+
+    /// @brief 设置输出文件, 默认 stdout, 需在写入日志前设置, file 由调用者管理
+    void SetOutput(std::FILE* file) { output_.store(file, std::memory_order_relaxed); }
+
+    /// @brief 等待调用前入队的日志全部写出
+    void Flush();
+
+    LogMetrics Metrics() const;
+
+    static std::string_view ToString(LogLevel level);
+
+private:
+    struct Record : MpscNode {
+        std::string text;
+    };
+
+    AsyncLog();
+
+    void Push(std::unique_ptr<Record> record);
+
+    void WriteThread();
+
+    /// @brief 取出队列中的日志并写出, 返回写出的行数
+    std::size_t Drain(std::string& batch);
+
+    /// @brief 停止写线程并写出剩余日志, 进程退出时调用
+    void Stop();
+
+private:
+    MpscQueue<Record> queue_{};
+    std::atomic<std::size_t> pending_{0};   // 已入队未写出的行数, 写线程在为 0 时等待
+    std::atomic<bool> stopped_{false};      // 为 true 时日志直接同步写出
+    std::atomic<std::uint64_t> flushed_{0};  // 已写出的入队行数, 与 pushed_ 比较用于 Flush
+    std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<LogLevel> min_level_{static_cast<LogLevel>(NETWORK_MIN_LOG_LEVEL)};
+    std::atomic<std::FILE*> output_{stdout};
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+
+    std::thread write_thread_;
+};
+
+}  // namespace network
+
+/// @brief 带级别和单点限流的异步日志, 格式与 fmt::println("[{}]: ...", __func__, ...) 一致
+#define NET_LOG(level, ...)                                                                            \
+    do {                                                                                               \
+        if constexpr (static_cast<int>(level) >= NETWORK_MIN_LOG_LEVEL) {                              \
+            static ::network::LogRateLimiter network_log_limiter{                                      \
+                ::network::AsyncLog::kDefaultRatePerSite};                                             \
+            ::network::AsyncLog::GetInstance().Log(level, network_log_limiter, __func__, __VA_ARGS__); \
+        }                                                                                              \
+    } while (0)
+
+#define NET_LOG_DEBUG(...) NET_LOG(::network::LogLevel::kDebug, __VA_ARGS__)
+#define NET_LOG_INFO(...) NET_LOG(::network::LogLevel::kInfo, __VA_ARGS__)
+#define NET_LOG_WARN(...) NET_LOG(::network::LogLevel::kWarn, __VA_ARGS__)
+#define NET_LOG_ERROR(...) NET_LOG(::network::LogLevel::kError, __VA_ARGS__)
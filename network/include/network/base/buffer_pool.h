@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "common/noncopyable.h"
+
+namespace network {
+
+namespace asio = boost::asio;
+
+class BufferPool;
+
+/// @brief 引用计数的定长内存块, 最后一个引用释放时归还给 BufferPool
+class Buffer : public pyc::Noncopyable {
+    friend class BufferPool;
+    friend class BufferRef;
+
+public:
+    static constexpr std::size_t kCapacity = 16ul * 1024;
+
+    char* Data() { return data_; }
+
+    const char* Data() const { return data_; }
+
+    std::size_t UseCount() const { return ref_count_.load(std::memory_order_acquire); }
+
+private:
+    Buffer() = default;
+
+    void AddRef() { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+
+    void Release();
+
+private:
+    std::atomic<std::size_t> ref_count_{0};
+    std::shared_ptr<BufferPool> pool_{};  // 使用期间持有, 保证所属的池比内存块活得久
+    alignas(std::max_align_t) char data_[kCapacity];
+};
+
+/// @brief Buffer 的侵入式智能指针
+class BufferRef {
+public:
+    BufferRef() = default;
+
+    explicit BufferRef(Buffer* buffer) : buffer_(buffer) {
+        if (buffer_) {
+            buffer_->AddRef();
+        }
+    }
+
+    BufferRef(const BufferRef& other) : BufferRef(other.buffer_) {}
+
+    BufferRef(BufferRef&& other) noexcept : buffer_(std::exchange(other.buffer_, nullptr)) {}
+
+    BufferRef& operator=(BufferRef other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        return *this;
+    }
+
+    ~BufferRef() {
+        if (buffer_) {
+            buffer_->Release();
+        }
+    }
+
+    Buffer* Get() const { return buffer_; }
+
+    Buffer* operator->() const { return buffer_; }
+
+    explicit operator bool() const { return buffer_ != nullptr; }
+
+private:
+    Buffer* buffer_{nullptr};
+};
+
+/// @brief 内存块中的一段只读数据, 持有内存块的引用, 可以传递到其他线程, 不复制数据
+class BufferSlice {
+public:
+    BufferSlice() = default;
+
+    BufferSlice(BufferRef buffer, std::size_t offset, std::size_t size)
+        : buffer_(std::move(buffer)), offset_(offset), size_(size) {}
+
+    const char* Data() const { return buffer_ ? buffer_->Data() + offset_ : nullptr; }
+
+    std::size_t Size() const { return size_; }
+
+    bool Empty() const { return size_ == 0; }
+
+    std::string_view View() const { return {Data(), size_}; }
+
+private:
+    BufferRef buffer_{};
+    std::size_t offset_{0};
+    std::size_t size_{0};
+};
+
+/// @brief 线程安全的定长内存块池, 每个 io_context 一个, 接收缓冲区从这里获取, 避免每条消息分配内存
+/// 空闲块最多缓存 kMaxFreeBuffers 个, 超出的直接释放
+class BufferPool : public std::enable_shared_from_this<BufferPool>, public pyc::Noncopyable {
+    friend class Buffer;
+
+public:
+    static constexpr std::size_t kMaxFreeBuffers = 1024;
+
+    BufferPool() = default;
+
+    ~BufferPool();
+
+    /// @brief io_context 对应的内存池, 第一次调用时创建, 随 io_context 销毁释放 (仍在使用的块会延长其生命周期)
+    static std::shared_ptr<BufferPool> ForIoContext(asio::io_context& io_context);
+
+    BufferRef Acquire();
+
+    /// @brief 空闲的内存块数量
+    std::size_t FreeCount() const;
+
+    /// @brief 已分配的内存块总数, 包括使用中和空闲的
+    std::size_t AllocatedCount() const { return allocated_.load(std::memory_order_relaxed); }
+
+private:
+    void Recycle(Buffer* buffer);
+
+private:
+    mutable std::mutex mutex_{};
+    std::vector<Buffer*> free_buffers_{};
+    std::atomic<std::size_t> allocated_{0};
+};
+
+}  // namespace network
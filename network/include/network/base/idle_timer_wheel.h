@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "common/noncopyable.h"
+
+namespace network {
+
+namespace asio = boost::asio;
+
+/// @brief 连接的空闲策略, idle_timeout 为 0 表示不检测空闲
+struct IdlePolicy {
+    std::chrono::milliseconds idle_timeout{0};        // 超过该时间没有收到数据则关闭连接
+    std::chrono::milliseconds heartbeat_interval{0};  // 空闲超过该时间后按此间隔发送心跳, 为 0 表示不发送
+
+    bool Enabled() const { return idle_timeout.count() > 0; }
+};
+
+/// @brief 空闲检测运行指标快照
+struct IdleMetrics {
+    std::size_t watched{0};       // 正在检测的连接数
+    std::uint64_t heartbeats{0};  // 发送的心跳数
+    std::uint64_t reaped{0};      // 因空闲超时关闭的连接数
+};
+
+class IdleTimerWheel;
+
+/// @brief 一个连接的空闲检测项, 由连接持有
+/// 收到数据时调用 Touch, 只是一次原子写, 不操作时间轮; 时间轮到期时再按最后活跃时间决定心跳, 关闭或重新排期
+class IdleWatch : public pyc::Noncopyable {
+    friend class IdleTimerWheel;
+
+public:
+    using Callback = std::function<void()>;
+
+    IdleWatch(const IdlePolicy& policy, Callback on_heartbeat, Callback on_timeout)
+        : policy_(policy), on_heartbeat_(std::move(on_heartbeat)), on_timeout_(std::move(on_timeout)) {
+        Touch();
+    }
+
+    /// @brief 记录一次活动, 可在任意线程调用
+    void Touch() { last_active_ns_.store(NowNs(), std::memory_order_relaxed); }
+
+    /// @brief 取消检测, 之后不会再调用回调 (正在执行的回调除外)
+    void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    bool IsCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    static std::int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+private:
+    const IdlePolicy policy_;
+    const Callback on_heartbeat_;
+    const Callback on_timeout_;
+    std::atomic<std::int64_t> last_active_ns_{0};
+    std::atomic<bool> cancelled_{false};
+    std::int64_t last_heartbeat_ns_{0};  // 以下只由时间轮访问
+    std::uint64_t expire_tick_{0};
+};
+
+/// @brief 哈希时间轮, 每个 io_context 一个, 管理该 io_context 上所有连接的空闲检测
+/// - 所有连接共用一个 steady_timer, 没有检测项时不运行
+/// - 检测项按到期 tick 哈希到 kSlots 个槽位, 超过一圈的检测项留在槽位中等下一圈
+/// - 取消是惰性的, 到期时才移除已取消的检测项
+/// 回调在 io_context 的线程中执行
+class IdleTimerWheel : public asio::execution_context::service {
+public:
+    static inline asio::execution_context::id id;
+
+    static constexpr std::size_t kSlots = 512;
+    static constexpr std::chrono::milliseconds kDefaultTick{100};
+
+    explicit IdleTimerWheel(asio::io_context& io_context);
+
+    /// @brief io_context 对应的时间轮, 第一次调用时创建, 随 io_context 销毁
+    static IdleTimerWheel& ForIoContext(asio::io_context& io_context);
+
+    /// @brief 开始检测一个连接, 策略未启用时返回 nullptr
+    std::shared_ptr<IdleWatch> Watch(const IdlePolicy& policy, IdleWatch::Callback on_heartbeat,
+                                     IdleWatch::Callback on_timeout);
+
+    /// @brief 设置 tick 间隔, 即检测精度, 只影响之后的排期
+    void SetTick(std::chrono::milliseconds tick);
+
+    IdleMetrics Metrics() const;
+
+private:
+    void shutdown() override;
+
+    std::uint64_t CurrentTick(std::int64_t now_ns) const;
+
+    /// @brief 按检测项的下一个检查时间放入槽位, 需持有 mutex_
+    void Schedule(const std::shared_ptr<IdleWatch>& watch, std::int64_t now_ns);
+
+    /// @brief 启动定时器, 需持有 mutex_
+    void Arm();
+
+    void OnTick();
+
+    /// @brief 检查一个到期的检测项, 返回是否继续检测
+    bool Check(IdleWatch& watch, std::int64_t now_ns);
+
+private:
+    mutable std::mutex mutex_{};
+    asio::steady_timer timer_;
+    std::int64_t start_ns_;
+    std::int64_t tick_ns_;
+    std::uint64_t processed_tick_{0};  // 已处理到的 tick
+    bool armed_{false};
+    bool stopped_{false};
+    std::vector<std::vector<std::shared_ptr<IdleWatch>>> slots_;
+
+    std::atomic<std::size_t> watched_{0};
+    std::atomic<std::uint64_t> heartbeats_{0};
+    std::atomic<std::uint64_t> reaped_{0};
+};
+
+}  // namespace network
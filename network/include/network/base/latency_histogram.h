@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace network {
+
+/// @brief HDR 风格的对数线性直方图, 用于统计延迟分布
+/// - 小于 2 * kSubBuckets 的值精确记录, 更大的值按 2 的幂分段, 每段再线性分为 kSubBuckets 个桶
+/// - 相对误差不超过 1 / kSubBuckets, 记录是 O(1) 的数组自增, 内存固定约 60KB
+/// 非线程安全, 多线程统计时每个线程一个直方图, 结束后 Merge
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr std::uint64_t kSubBuckets = 1ull << kSubBucketBits;
+
+    LatencyHistogram();
+
+    void Record(std::uint64_t value);
+
+    void Merge(const LatencyHistogram& other);
+
+    void Reset();
+
+    std::uint64_t Count() const { return count_; }
+
+    std::uint64_t Min() const { return count_ == 0 ? 0 : min_; }
+
+    std::uint64_t Max() const { return max_; }
+
+    double Mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_); }
+
+    /// @brief percentile 取值 [0, 100], 返回不小于该比例记录值的最小桶的上界, 不超过 Max
+    std::uint64_t ValueAtPercentile(double percentile) const;
+
+private:
+    static std::size_t IndexOf(std::uint64_t value);
+
+    /// @brief 桶中可记录的最大值
+    static std::uint64_t HighestEquivalentValue(std::size_t index);
+
+private:
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t min_{UINT64_MAX};
+    std::uint64_t max_{0};
+};
+
+}  // namespace network
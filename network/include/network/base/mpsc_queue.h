@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+#include "common/noncopyable.h"
+
+namespace network {
+
+/// @brief MpscQueue 的侵入式链接, 入队的类型需要继承它
+struct MpscNode {
+    std::atomic<MpscNode*> mpsc_next_{nullptr};
+};
+
+/// @brief 侵入式无锁多生产者单消费者队列 (Vyukov), 队列持有入队节点的所有权
+/// - Push 可以在任意线程并发调用, 只有一次原子交换, 不需要加锁
+/// - Pop 只能由一个消费者调用, 生产者交换完队尾但还未链接时会暂时返回 nullptr, 调用者稍后重试即可
+template <typename T>
+class MpscQueue : public pyc::Noncopyable {
+    static_assert(std::is_base_of_v<MpscNode, T>, "T must derive from MpscNode");
+
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    ~MpscQueue() {
+        while (Pop()) {
+        }
+    }
+
+    void Push(std::unique_ptr<T> node) { PushNode(node.release()); }
+
+    std::unique_ptr<T> Pop() {
+        MpscNode* tail = tail_;
+        MpscNode* next = tail->mpsc_next_.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = tail = next;
+            next = next->mpsc_next_.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return Take(tail);
+        }
+
+        // tail 是最后一个已链接的节点, 有生产者正在入队时等待其完成链接
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        // 重新放入 stub, 使 tail 之后有节点, 从而可以取出 tail
+        PushNode(&stub_);
+        next = tail->mpsc_next_.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return Take(tail);
+        }
+        return nullptr;
+    }
+
+private:
+    void PushNode(MpscNode* node) {
+        node->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+        MpscNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->mpsc_next_.store(node, std::memory_order_release);
+    }
+
+    static std::unique_ptr<T> Take(MpscNode* node) { return std::unique_ptr<T>(static_cast<T*>(node)); }
+
+private:
+    alignas(64) std::atomic<MpscNode*> head_;  // 生产者端
+    alignas(64) MpscNode* tail_;               // 消费者端
+    MpscNode stub_;
+};
+
+}  // namespace network
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
 #include <boost/asio.hpp>
 
 namespace network {
@@ -11,6 +15,38 @@ public:
     using IOService = asio::io_context;
     using Work = asio::executor_work_guard<asio::io_context::executor_type>;
 
+    /// @brief 持有期间计入所在 io_context 的负载 (会话数), 由会话持有, 析构时扣除
+    class LoadToken {
+    public:
+        LoadToken() = default;
+
+        explicit LoadToken(std::atomic<std::size_t>& load) : load_(&load) {
+            load_->fetch_add(1, std::memory_order_relaxed);
+        }
+
+        LoadToken(LoadToken&& other) noexcept : load_(std::exchange(other.load_, nullptr)) {}
+
+        LoadToken& operator=(LoadToken&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                load_ = std::exchange(other.load_, nullptr);
+            }
+            return *this;
+        }
+
+        ~LoadToken() { Reset(); }
+
+        void Reset() {
+            if (load_) {
+                load_->fetch_sub(1, std::memory_order_relaxed);
+                load_ = nullptr;
+            }
+        }
+
+    private:
+        std::atomic<std::size_t>* load_{nullptr};
+    };
+
     virtual ~Pool() = default;
 
     virtual IOService& GetIOService() = 0;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include "common/noncopyable.h"
+#include "network/base/buffer_pool.h"
+#include "network/msg_node.h"
+
+namespace network {
+
+namespace asio = boost::asio;
+
+/// @brief 会话的接收缓冲区, 负责粘包处理
+/// - 数据直接读入从 BufferPool 获取的内存块, 完整的消息以 BufferSlice 的形式交给逻辑层, 不复制消息体
+/// - 剩余空间不足一个完整帧时, 内存块没有被其他 BufferSlice 引用则原地搬移未处理的数据,
+///   否则把未处理的数据复制到新的内存块, 旧内存块在所有 BufferSlice 释放后归还内存池
+/// - 同时支持 v1 帧和 v2 帧, 超过 kMaxWholeFrameLength 的 v2 帧不等待收全, 按到达的数据分片交出
+/// 只能在会话的读操作中使用, 不是线程安全的
+class RecvBuffer : public pyc::Noncopyable {
+public:
+    /// @brief 整帧交出的最大帧长度 (含帧头), 更大的帧分片交出, 内存占用不随消息大小增长
+    static constexpr std::size_t kMaxWholeFrameLength = Buffer::kCapacity / 2;
+
+    enum class ParseResult {
+        kFrame,     // 解析出帧数据, 可能是完整的帧或大帧的一片
+        kNeedMore,  // 数据不足, 需要继续读取
+        kInvalid,   // 头部非法
+    };
+
+    /// @brief 帧数据, v1 帧的头部转换为 flags 为 0 的 FrameHead
+    struct Piece {
+        FrameHead head{};        // 所属帧的头部
+        BufferSlice data{};      // 帧体的全部或一部分
+        std::size_t offset{0};   // data 在帧体中的偏移
+        bool frame_end{false};   // data 是否到达帧尾
+    };
+
+    explicit RecvBuffer(std::shared_ptr<BufferPool> pool) : pool_(std::move(pool)) {}
+
+    /// @brief 准备下一次读取的空间, 保证至少能容纳一个整帧交出的帧
+    asio::mutable_buffer Prepare();
+
+    /// @brief 提交读取到的字节数
+    void Commit(std::size_t bytes_transferred) { end_ += bytes_transferred; }
+
+    /// @brief 解析下一段帧数据, 返回 kFrame 时 piece 有效, 返回 kInvalid 时 piece.head 为非法头部
+    ParseResult Next(Piece& piece);
+
+    /// @brief 尚未解析的字节数
+    std::size_t Readable() const { return end_ - begin_; }
+
+private:
+    /// @brief 从 begin_ 开始交出 length 字节的帧体数据
+    BufferSlice Consume(std::size_t length);
+
+private:
+    std::shared_ptr<BufferPool> pool_;
+    BufferRef buffer_{};
+    std::size_t begin_{0};  // 未解析数据的起始位置
+    std::size_t end_{0};    // 已读取数据的结束位置
+
+    FrameHead stream_head_{};        // 正在分片交出的大帧的头部
+    std::size_t stream_offset_{0};   // 大帧已交出的字节数
+    std::size_t stream_remain_{0};   // 大帧剩余的字节数, 为 0 表示没有正在交出的大帧
+};
+
+}  // namespace network
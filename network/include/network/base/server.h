@@ -1,11 +1,12 @@
 #pragma once
 
 #include <memory>
-#include <mutex>
-#include <unordered_map>
 
 #include <boost/asio.hpp>
 
+#include "network/base/idle_timer_wheel.h"
+#include "network/base/session_registry.h"
+
 namespace network {
 
 namespace asio = boost::asio;
@@ -22,16 +23,25 @@ public:
     // 使用 IOServicePool 或者 ThreadPool 这里的行为会不一样
     virtual void StartAccept() = 0;
 
-    void DeleteSession(const std::string& uuid);
+    void DeleteSession(SessionId id);
+
+    /// @brief 当前连接的会话, 可用于查找和广播
+    const SessionRegistry<Session>& Sessions() const { return sessions_; }
+
+    /// @brief 之后接受的连接使用的空闲策略, 默认不检测
+    void SetIdlePolicy(const IdlePolicy& policy) { idle_policy_ = policy; }
 
 protected:
+    /// @brief 不创建监听 socket, 由派生类自行管理 acceptor
+    explicit Server(asio::io_context& io_context);
+
     void HandleAccept(const std::shared_ptr<Session>& session, const boost::system::error_code& error_code);
 
 protected:
     asio::io_context& io_context_;
-    tcp::acceptor acceptor_;
-    std::unordered_map<std::string, std::shared_ptr<Session>> sessions_{};
-    std::mutex mutex_{};
+    tcp::acceptor acceptor_;  // 使用 Server(io_context) 构造时未打开
+    SessionRegistry<Session> sessions_{};
+    IdlePolicy idle_policy_{};
 };
 
 }  // namespace network
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <string>
+#include <vector>
 
 #include <boost/asio.hpp>
 
+#include "network/base/idle_timer_wheel.h"
+#include "network/base/mpsc_queue.h"
+#include "network/base/pool.h"
+#include "network/base/recv_buffer.h"
+#include "network/base/session_registry.h"
 #include "network/msg_node.h"
 
 namespace network {
@@ -20,35 +25,75 @@ class Server;
 
 class Session : public std::enable_shared_from_this<Session> {
 public:
+    static constexpr std::size_t kDefaultMaxWriteBytes = 64ul * 1024;  // 一次批量写入的默认字节上限
+    static constexpr std::size_t kMaxWriteBuffers = 64;                // 一次批量写入的最大消息数, 不超过 IOV_MAX
+
     Session(asio::io_context& io_context, Server* server);
 
     virtual ~Session() = default;
 
     tcp::socket& Socket() { return socket_; }
 
-    const std::string& GetUuid() const { return uuid_; }
+    SessionId GetId() const { return id_; }
+
+    /// @brief 会话计入所在 io_context 的负载, 会话销毁时扣除
+    void SetLoadToken(Pool::LoadToken load_token) { load_token_ = std::move(load_token); }
 
     /// @brief 开始异步读取数据
     virtual void Start() = 0;
 
-    /// @brief 往发送队列添加发送数据并异步发送
+    /// @brief 往发送队列添加发送数据并异步发送, 可在任意线程调用
+    /// 写入进行中时新消息只入队, 写入完成后队列中积攒的消息合并为一次 scatter/gather 写入
+    /// 不超过 kMaxLength 的消息使用 v1 帧, 更大的消息使用 v2 帧
     void Send(const char* msg, std::size_t max_len, MsgId msg_id);
     void Send(const std::string& msg, MsgId msg_id);
 
+    /// @brief 以 v2 帧发送流式消息的一片, 除最后一片外都带 kFrameContinuation, 同一消息的各片需按顺序调用
+    /// 发送队列已满时返回 false, 调用方稍后重试, 不必把整条消息缓存在内存中
+    /// 各片之间可以穿插其他 id 的 Send 和心跳, 接收方按 id 区分; 同一时间只能有一条分片发送中的消息,
+    /// 分片发送期间不能用同一 id 调用 Send
+    bool SendChunk(const char* data, std::size_t len, MsgId msg_id, bool last, std::uint8_t flags = 0);
+
+    /// @brief 逻辑层背压解除后恢复读取, 可在任意线程调用
+    virtual void ResumeRead();
+
+    /// @brief 关闭连接, 可在任意线程调用
+    virtual void Close();
+
+    /// @brief 按 policy 开启空闲检测, 需在 Start 前调用
+    /// 空闲超过 heartbeat_interval 时发送 kMsgHeartbeat, 超过 idle_timeout 时关闭连接
+    void WatchIdle(const IdlePolicy& policy);
+
+    /// @brief 设置一次批量写入的字节上限, 单条消息超过上限时仍然完整发送
+    void SetMaxWriteBytes(std::size_t max_write_bytes) {
+        max_write_bytes_.store(max_write_bytes, std::memory_order_relaxed);
+    }
+
 protected:
     /// @brief 关闭连接
     void Stop();
 
-    /// @brief 对缓冲区数据进行粘包处理
-    void ParseBuffer(std::size_t bytes_transferred);
+    /// @brief 提交读取到的数据并进行粘包处理, 完整的消息以 BufferSlice 的形式投递给逻辑层
+    /// @return 是否继续读取, 逻辑层背压或连接关闭时返回 false
+    bool ParseBuffer(std::size_t bytes_transferred);
+
+    /// @brief 把一段帧数据交给逻辑层, 流式处理的消息直接投递, 否则组装为完整的消息后投递
+    /// @return 是否继续读取
+    bool DispatchPiece(RecvBuffer::Piece& piece);
+
+    /// @brief 把消息放入发送队列, 队列已满时返回 false
+    bool EnqueueSend(std::unique_ptr<SendNode> node);
 
     /// @brief 打印缓冲区数据
     void PrintBuffer(const char* buffer, std::size_t len);
 
-    /// @brief 异步读取数据
+    /// @brief 异步读取数据, 读取完成后交给 HandleRead
     virtual void AsyncRead() = 0;
 
-    /// @brief 异步写入数据
+    /// @brief 从发送队列取出一批消息填入 write_buffers_ 并调用 AsyncWrite
+    void FlushSendQueue();
+
+    /// @brief 异步写入 write_buffers_ 中的全部数据, 完成后调用 HandleWrite
     virtual void AsyncWrite() = 0;
 
     /// @brief 异步读回调
@@ -60,17 +105,31 @@ protected:
 protected:
     tcp::socket socket_;
     Server* server_;
-    std::string uuid_{};
+    const SessionId id_{NextSessionId()};
     std::atomic<bool> is_stop_{false};
-
-    char data_[kMaxLength];  // 接收数据缓冲区
-
-    std::queue<std::unique_ptr<SendNode>> send_queue_{};  // 发送队列
-    std::mutex send_lock_{};                              // 发送队列锁
-
-    bool is_head_parsed_ = false;  // 是否已经解析出头部
-    std::unique_ptr<RecvNode> recv_head_ = std::make_unique<RecvNode>(kHeadLength, MsgId::kMaxId);  // 头部数据
-    std::unique_ptr<RecvNode> recv_msg_{};                                                          // 接收数据
+    Pool::LoadToken load_token_{};
+    std::shared_ptr<IdleWatch> idle_watch_{};  // 由所属 io_context 的 IdleTimerWheel 检测
+
+    RecvBuffer recv_buffer_;  // 接收缓冲区, 内存块来自所属 io_context 的 BufferPool
+
+    /// @brief 正在接收的多帧消息或分片交出的大帧消息
+    struct InboundMessage {
+        bool active_{false};
+        bool streaming_{false};  // 是否流式投递
+        MsgId id_{};
+        std::uint8_t flags_{0};
+        std::uint64_t offset_{0};  // 已接收的字节数
+        std::string data_{};       // 非流式处理时组装的消息体
+    };
+    InboundMessage chunked_{};       // 带 kFrameContinuation 的多帧消息, 帧之间可以插入其他 id 的单帧消息
+    InboundMessage single_{};        // 插入的单帧消息中分片交出的大帧
+    bool receiving_chunked_{false};  // 当前帧是否属于 chunked_
+
+    MpscQueue<SendNode> send_queue_{};                                 // 无锁发送队列
+    std::atomic<std::size_t> send_pending_{0};                         // 已入队未写完的消息数, 非 0 时有写入进行中
+    std::atomic<std::size_t> max_write_bytes_{kDefaultMaxWriteBytes};  // 一次批量写入的字节上限
+    std::vector<std::unique_ptr<SendNode>> writing_{};                 // 正在写入的消息, 仅由写入方访问
+    std::vector<asio::const_buffer> write_buffers_{};                  // 正在写入的缓冲区序列
 };
 
 }  // namespace network
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/noncopyable.h"
+
+namespace network {
+
+/// @brief 会话 id, 进程内单调递增, 0 表示无效
+using SessionId = std::uint64_t;
+
+/// @brief 生成下一个会话 id, 只是一次原子加, 可以在任意线程调用
+inline SessionId NextSessionId() {
+    static std::atomic<SessionId> next_id{1};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// @brief 按会话 id 分片的并发会话表
+/// - 每个分片一把读写锁, 连接建立和断开只锁一个分片, 不同分片互不竞争
+/// - id 单调递增, 直接取模即可均匀分布到各个分片
+/// - ForEach 逐个分片复制快照后在锁外回调, 回调中可以发送数据或删除会话
+template <typename T>
+class SessionRegistry : public pyc::Noncopyable {
+public:
+    static constexpr std::size_t kShardCount = 16;
+
+    /// @brief 添加会话, id 已存在时返回 false
+    bool Add(SessionId id, std::shared_ptr<T> session) {
+        Shard& shard = ShardOf(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        if (!shard.sessions_.emplace(id, std::move(session)).second) {
+            return false;
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief 删除会话, 返回被删除的会话, 不存在时返回 nullptr
+    /// 返回值在锁外析构, 会话的析构函数不会在持锁时执行
+    std::shared_ptr<T> Remove(SessionId id) {
+        Shard& shard = ShardOf(id);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.sessions_.find(id);
+        if (iter == shard.sessions_.end()) {
+            return nullptr;
+        }
+        std::shared_ptr<T> session = std::move(iter->second);
+        shard.sessions_.erase(iter);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return session;
+    }
+
+    std::shared_ptr<T> Find(SessionId id) const {
+        const Shard& shard = ShardOf(id);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+        auto iter = shard.sessions_.find(id);
+        return iter == shard.sessions_.end() ? nullptr : iter->second;
+    }
+
+    /// @brief 对每个会话调用 f(const std::shared_ptr<T>&), 遍历期间新增或删除的会话可能不被访问
+    template <typename F>
+    void ForEach(F&& f) const {
+        std::vector<std::shared_ptr<T>> snapshot;
+        for (const Shard& shard : shards_) {
+            snapshot.clear();
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+                snapshot.reserve(shard.sessions_.size());
+                for (const auto& [id, session] : shard.sessions_) {
+                    snapshot.push_back(session);
+                }
+            }
+            for (const auto& session : snapshot) {
+                f(session);
+            }
+        }
+    }
+
+    std::size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex_{};
+        std::unordered_map<SessionId, std::shared_ptr<T>> sessions_{};
+    };
+
+    Shard& ShardOf(SessionId id) { return shards_[id % kShardCount]; }
+
+    const Shard& ShardOf(SessionId id) const { return shards_[id % kShardCount]; }
+
+private:
+    std::array<Shard, kShardCount> shards_{};
+    std::atomic<std::size_t> size_{0};
+};
+
+}  // namespace network
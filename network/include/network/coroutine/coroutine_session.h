@@ -15,9 +15,11 @@ public:
     void Start() override;
 
 protected:
+    /// @brief 循环读取直到连接关闭或逻辑层背压
     asio::awaitable<void> CoawaitRead();
 
-    void AsyncRead() override {}
+    /// @brief 开启读取协程
+    void AsyncRead() override;
     void AsyncWrite() override;
 
 private:
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include "network/http/http_message.h"
+#include "network/http/router.h"
+
+namespace network {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+/// @brief HTTP 服务器配置
+struct HttpServerOptions {
+    std::chrono::seconds keep_alive_timeout{30};  // 没有待写出的响应时等待下一个请求的超时时间
+    std::size_t max_pipeline{16};                 // 已读取但未写完的请求数上限, 达到后暂停读取
+    std::uint64_t body_limit{1024 * 1024};        // 请求体大小上限
+};
+
+/// @brief 一个 HTTP/1.1 持久连接
+/// - 连接在请求和响应都允许 keep-alive 时保持打开, 空闲超过 keep_alive_timeout 后关闭.
+///   写出响应期间不计时, 慢速客户端接收大文件时不会被截断
+/// - 支持流水线: 写出响应的同时继续读取和处理后续请求, 响应按请求顺序写出
+/// - 文件响应先写出头部, 再以 sendfile 从文件直接写入 socket
+/// 所有操作在连接自己的 strand 上执行, 处理函数在 io 线程中同步调用, 不应阻塞
+class HttpConnection : public std::enable_shared_from_this<HttpConnection> {
+public:
+    /// @brief router 和 options 需在连接结束前保持有效
+    HttpConnection(tcp::socket&& socket, const Router& router, const HttpServerOptions& options);
+
+    void Start();
+
+private:
+    struct PendingResponse {
+        HttpResponse response;
+        bool head_only;  // HEAD 请求只写出头部
+    };
+
+    void AsyncRead();
+
+    void HandleRead(const beast::error_code& error_code);
+
+    /// @brief 路由并调用处理函数, 生成的响应放入队列
+    void Dispatch(const HttpRequest& request);
+
+    void PushResponse(HttpResponse response, bool head_only);
+
+    /// @brief 写出队首的响应
+    void AsyncWrite();
+
+    /// @brief 以 sendfile 写出队首响应的文件内容, socket 不可写时等待后继续
+    void SendFile();
+
+    /// @brief 队首响应写完, 继续写出或读取
+    void FinishResponse();
+
+    /// @brief 读取中且没有待写出的响应时开始空闲计时, 到期时关闭连接
+    void StartIdleTimer();
+
+    void Shutdown();
+
+private:
+    beast::tcp_stream stream_;
+    asio::steady_timer idle_timer_;  // 不使用 tcp_stream 的超时, 它会在写出期间关闭 socket
+    beast::flat_buffer buffer_{};
+    std::optional<http::request_parser<http::string_body>> parser_{};
+    const Router& router_;
+    const HttpServerOptions& options_;
+
+    std::deque<PendingResponse> responses_{};
+    std::unique_ptr<http::response_serializer<http::string_body>> header_serializer_{};
+    std::unique_ptr<char[]> file_buffer_{};  // 不支持 sendfile 的平台上读取文件的缓冲区
+    bool reading_{false};
+    bool writing_{false};
+    bool closing_{false};  // 不再读取新的请求, 写完已有响应后关闭
+};
+
+}  // namespace network
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/beast/http.hpp>
+
+namespace network {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+using HttpRequest = http::request<http::string_body>;
+
+/// @brief 路由中 :name 和 *name 匹配到的路径参数
+using RouteParams = std::unordered_map<std::string, std::string>;
+
+/// @brief 独占的文件描述符, 析构时关闭
+class FileHandle {
+public:
+    FileHandle() = default;
+
+    explicit FileHandle(int fd) : fd_(fd) {}
+
+    FileHandle(FileHandle&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+
+    FileHandle& operator=(FileHandle&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+
+    ~FileHandle() { Reset(); }
+
+    int Get() const { return fd_; }
+
+    bool IsOpen() const { return fd_ >= 0; }
+
+    void Reset();
+
+private:
+    int fd_{-1};
+};
+
+/// @brief 处理函数生成的响应
+/// 消息体通常放在 message.body() 中; 设置 file 后消息体为文件的 [file_offset, file_offset + file_length),
+/// 由连接以 sendfile 直接从页缓存发送, 不经过用户态缓冲区
+struct HttpResponse {
+    http::response<http::string_body> message{};
+    FileHandle file{};
+    std::uint64_t file_offset{0};
+    std::uint64_t file_length{0};
+
+    bool HasFile() const { return file.IsOpen(); }
+};
+
+using HttpHandler = std::function<void(const HttpRequest&, const RouteParams&, HttpResponse&)>;
+
+}  // namespace network
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <boost/asio.hpp>
+
+#include "common/noncopyable.h"
+#include "network/http/http_connection.h"
+#include "network/http/router.h"
+
+namespace network {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+/// @brief HTTP/1.1 服务器, 在 StartAccept 前通过 GetRouter 注册路由
+/// 可以由多个线程运行 io_context, 每个连接绑定一个 strand; 服务器需在所有连接结束后析构
+class HttpServer : public pyc::Noncopyable {
+public:
+    HttpServer(asio::io_context& io_context, unsigned short port, const HttpServerOptions& options = {});
+
+    Router& GetRouter() { return router_; }
+
+    void StartAccept();
+
+    unsigned short Port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    asio::io_context& io_context_;
+    tcp::acceptor acceptor_;
+    Router router_{};
+    const HttpServerOptions options_;
+};
+
+}  // namespace network
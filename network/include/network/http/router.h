@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/string_hash.h"
+#include "network/http/http_message.h"
+
+namespace network {
+
+/// @brief HTTP 路由表
+/// - 不含参数的路径放在哈希表中, 一次查找完成匹配
+/// - 含参数的路径放在按 '/' 分段的前缀树中, :name 匹配一段, *name 匹配剩余的所有段 (只能在末尾)
+/// - 前缀树匹配时静态段优先于 :name, :name 优先于 *name, 失败时回溯
+/// 路由应在服务器开始接受连接前注册完毕, 之后只读, 可被多个线程同时查找
+class Router {
+public:
+    /// @brief 查找结果
+    struct Match {
+        const HttpHandler* handler{nullptr};
+        RouteParams params{};
+        bool path_found{false};  // 路径存在但方法不匹配时为 true, 用于返回 405
+    };
+
+    Router();
+    ~Router();
+
+    void Add(http::verb method, std::string_view pattern, HttpHandler handler);
+
+    void Get(std::string_view pattern, HttpHandler handler) { Add(http::verb::get, pattern, std::move(handler)); }
+
+    void Post(std::string_view pattern, HttpHandler handler) {
+        Add(http::verb::post, pattern, std::move(handler));
+    }
+
+    /// @brief 按方法和路径 (不含查询串) 查找处理函数, HEAD 请求在没有单独注册时使用 GET 的处理函数
+    Match Find(http::verb method, std::string_view path) const;
+
+private:
+    using Handlers = std::unordered_map<http::verb, HttpHandler>;
+
+    template <typename T>
+    using StringMap = std::unordered_map<std::string, T, pyc::StringHash, pyc::StringEqual>;
+
+    struct Node {
+        StringMap<std::unique_ptr<Node>> children{};
+        std::unique_ptr<Node> param_child{};
+        std::string param_name{};
+        std::string wildcard_name{};  // 非空时本节点之后的所有段由 wildcard_handlers 处理
+        Handlers wildcard_handlers{};
+        Handlers handlers{};
+    };
+
+    static const HttpHandler* FindHandler(const Handlers& handlers, http::verb method);
+
+    bool MatchNode(const Node& node, const std::vector<std::string_view>& segments, std::size_t index,
+                   http::verb method, Match& match) const;
+
+private:
+    StringMap<Handlers> static_routes_{};
+    std::unique_ptr<Node> root_;
+};
+
+}  // namespace network
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "network/http/http_message.h"
+
+namespace network {
+
+/// @brief 创建静态文件处理函数, 注册时路径的最后一段需为通配参数, 如 router.Get("/static/*path", ...)
+/// - 只提供 root 目录下的文件, 拒绝包含 ".." 的路径, 目录返回其中的 index.html
+/// - 响应带强 ETag (由文件大小和修改时间生成), If-None-Match 命中时返回 304
+/// - 支持单个 Range (bytes=a-b, bytes=a-, bytes=-n) 和 If-Range, 多个范围时返回完整文件
+/// - 文件内容由连接以 sendfile 发送
+HttpHandler MakeStaticFileHandler(std::filesystem::path root, std::string param_name = "path");
+
+}  // namespace network
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -12,25 +14,54 @@ namespace network {
 
 namespace asio = boost::asio;
 
+/// @brief 会话分配到 io_context 的策略
+enum class LoadBalancePolicy {
+    kRoundRobin,   // 轮流分配
+    kLeastLoaded,  // 分配给当前会话数最少的 io_context
+};
+
+/// @brief 每个 io_context 一个线程的 io_context 池, 通常使用 GetInstance 的全局实例,
+/// 也可以单独构造, 例如测试中使用互不影响的 io_context
 class IOServicePool : public Pool, public pyc::Singleton<IOServicePool> {
     friend class pyc::Singleton<IOServicePool>;
 
 public:
-    /// @brief 使用 round-robin 返回一个 io_context
+    explicit IOServicePool(std::size_t size = std::max(1u, std::thread::hardware_concurrency() / 2));
+
+    /// @brief 未调用 Stop 时先停止所有 io 线程
+    ~IOServicePool();
+
+    /// @brief 按分配策略返回一个 io_context
     IOService& GetIOService() override;
 
-    void Stop() override;
+    IOService& GetIOService(std::size_t index) { return io_services_[index]; }
 
-private:
-    IOServicePool(std::size_t size = std::max(1u, std::thread::hardware_concurrency() / 2));
+    /// @brief 按分配策略选出下一个 io_context 的下标
+    std::size_t NextIndex();
 
-    ~IOServicePool();
+    /// @brief 在下标为 index 的 io_context 上计入一个会话, 会话持有返回的 LoadToken
+    LoadToken AcquireLoad(std::size_t index) { return LoadToken(loads_[index]); }
+
+    /// @brief 下标为 index 的 io_context 当前的会话数
+    std::size_t Load(std::size_t index) const { return loads_[index].load(std::memory_order_relaxed); }
+
+    std::size_t Size() const { return io_services_.size(); }
+
+    void SetPolicy(LoadBalancePolicy policy) { policy_.store(policy, std::memory_order_relaxed); }
+
+    /// @brief 把第 i 个 io 线程绑定到第 i 个 CPU 核 (超出核数时取模), 不支持时返回 false
+    bool PinThreads();
+
+    /// @brief 停止所有 io_context 并等待 io 线程退出, 可以重复调用
+    void Stop() override;
 
 private:
+    std::vector<std::atomic<std::size_t>> loads_{};  // 每个 io_context 上的会话数, 比 io_context 晚析构
     std::vector<IOService> io_services_{};
     std::vector<Work> works_{};  // 防止 IOService run 后直接返回
     std::vector<std::thread> threads_{};
-    std::size_t curr_idx_ = 0;  // 当前 io_service 下标
+    std::atomic<std::size_t> curr_idx_{0};           // round-robin 计数
+    std::atomic<LoadBalancePolicy> policy_{LoadBalancePolicy::kRoundRobin};
 };
 
 }  // namespace network
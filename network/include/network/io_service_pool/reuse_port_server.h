@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <fmt/base.h>
+
+#include "network/base/async_log.h"
+#include "network/base/server.h"
+#include "network/base/session.h"
+#include "network/io_service_pool/io_service_pool.h"
+
+namespace network {
+
+/// @brief 每个 io 线程各自监听的服务器
+/// - IOServicePool 的每个 io_context 一个 SO_REUSEPORT 的 acceptor, 由内核把新连接分散到各个 acceptor,
+///   会话留在接受它的 io_context 上, 没有跨线程的转交
+/// - 可选把 io 线程绑定到 CPU 核, 会话的读写和回调始终在同一个核上
+/// - 不支持 SO_REUSEPORT 时退化为单个 acceptor, 按最少会话数分配 io_context
+/// SessionType 为运行在 IOServicePool 上的会话, 如 IOServicePoolSession, CoroutineSession
+/// 默认使用全局的 IOServicePool, pool 需比服务器晚停止
+template <typename SessionType>
+class ReusePortServer : public Server {
+public:
+    ReusePortServer(asio::io_context& io_context, unsigned short port_num, bool pin_threads = true,
+                    IOServicePool& pool = IOServicePool::GetInstance())
+        : Server(io_context), pool_(pool) {
+        if (pin_threads) {
+            pool_.PinThreads();
+        }
+        if (OpenReusePortAcceptors(port_num)) {
+            fmt::println("[{}]: Server start success on port {} with {} acceptors", __func__, Port(),
+                         acceptors_.size());
+            return;
+        }
+
+        acceptors_.clear();
+        tcp::endpoint endpoint(tcp::v4(), port_num);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+        pool_.SetPolicy(LoadBalancePolicy::kLeastLoaded);
+        fmt::println("[{}]: Server start success on port {} with least-loaded fallback", __func__, Port());
+    }
+
+    void StartAccept() override {
+        if (acceptors_.empty()) {
+            StartAcceptFallback();
+            return;
+        }
+        for (std::size_t i = 0; i < acceptors_.size(); ++i) {
+            Accept(i);
+        }
+    }
+
+    /// @brief 是否使用 SO_REUSEPORT 的多 acceptor 模式
+    bool IsReusePort() const { return !acceptors_.empty(); }
+
+    /// @brief 实际监听的端口, 构造时传入 0 则为系统分配的端口
+    unsigned short Port() const {
+        return (acceptors_.empty() ? acceptor_ : acceptors_.front()).local_endpoint().port();
+    }
+
+private:
+    bool OpenReusePortAcceptors(unsigned short port_num) {
+#if defined(SO_REUSEPORT)
+        using ReusePort = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+        boost::system::error_code error_code;
+        for (std::size_t i = 0; i < pool_.Size(); ++i) {
+            tcp::acceptor acceptor(pool_.GetIOService(i));
+            tcp::endpoint endpoint(tcp::v4(), port_num);
+            acceptor.open(endpoint.protocol(), error_code);
+            if (!error_code) {
+                acceptor.set_option(ReusePort(true), error_code);
+            }
+            if (!error_code) {
+                acceptor.bind(endpoint, error_code);
+            }
+            if (!error_code) {
+                acceptor.listen(asio::socket_base::max_listen_connections, error_code);
+            }
+            if (error_code) {
+                NET_LOG_WARN("Error code = {}. Message: {}", error_code.value(), error_code.message());
+                return false;
+            }
+            // 端口为 0 时其余 acceptor 复用第一个分配到的端口
+            port_num = acceptor.local_endpoint().port();
+            acceptors_.push_back(std::move(acceptor));
+        }
+        return true;
+#else
+        (void)port_num;
+        return false;
+#endif
+    }
+
+    /// @brief 在第 index 个 acceptor 上接受连接, 会话创建在同一个 io_context 上
+    void Accept(std::size_t index) {
+        auto session = std::make_shared<SessionType>(pool_.GetIOService(index), this);
+        session->SetLoadToken(pool_.AcquireLoad(index));
+        acceptors_[index].async_accept(session->Socket(),
+                                       [this, index, session](const boost::system::error_code& error_code) {
+                                           if (error_code == asio::error::operation_aborted) {
+                                               return;
+                                           }
+                                           HandleAccept(session, error_code);
+                                           Accept(index);
+                                       });
+    }
+
+    void StartAcceptFallback() {
+        const std::size_t index = pool_.NextIndex();
+        auto session = std::make_shared<SessionType>(pool_.GetIOService(index), this);
+        session->SetLoadToken(pool_.AcquireLoad(index));
+        acceptor_.async_accept(session->Socket(), [this, session](const boost::system::error_code& error_code) {
+            if (error_code == asio::error::operation_aborted) {
+                return;
+            }
+            HandleAccept(session, error_code);
+            StartAcceptFallback();
+        });
+    }
+
+private:
+    IOServicePool& pool_;
+    std::vector<tcp::acceptor> acceptors_{};  // 与 pool_ 的 io_context 一一对应
+};
+
+}  // namespace network
@@ -1,22 +1,61 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
+#include "network/base/buffer_pool.h"
 #include "network/base/session.h"
 #include "network/msg_node.h"
 
 namespace network {
 
+/// @brief 流式消息的一片, 交给注册为流式处理的回调, 同一消息的各片按顺序到达
+struct MsgChunk {
+    MsgId id;
+    std::uint8_t flags;     // 消息的 FrameFlag, 不含 kFrameContinuation
+    std::uint64_t offset;   // 本片在整条消息中的偏移
+    bool last;              // 是否为消息的最后一片
+    std::string_view data;  // 本片数据, 只在回调期间有效
+};
+
 class LogicNode {
     friend class LogicSystem;
 
 public:
-    LogicNode(const std::shared_ptr<Session>& session, std::unique_ptr<RecvNode> recv_node)
-        : session_(session), recv_node_(std::move(recv_node)) {}
+    /// @brief 完整的消息, 引用接收缓冲区中的消息体
+    LogicNode(const std::shared_ptr<Session>& session, MsgId msg_id, BufferSlice body)
+        : session_(session), msg_id_(msg_id), body_(std::move(body)) {}
+
+    /// @brief 由多个帧组装的完整消息
+    LogicNode(const std::shared_ptr<Session>& session, MsgId msg_id, std::string body)
+        : session_(session), msg_id_(msg_id), owned_body_(std::move(body)) {}
+
+    /// @brief 流式消息的一片
+    LogicNode(const std::shared_ptr<Session>& session, MsgId msg_id, BufferSlice body, std::uint8_t flags,
+              std::uint64_t offset, bool last)
+        : session_(session),
+          msg_id_(msg_id),
+          body_(std::move(body)),
+          is_chunk_(true),
+          flags_(flags),
+          offset_(offset),
+          last_(last) {}
+
+    std::string_view Body() const { return body_.Empty() ? std::string_view(owned_body_) : body_.View(); }
 
 private:
     std::shared_ptr<Session> session_;
-    std::unique_ptr<RecvNode> recv_node_;
+    MsgId msg_id_;
+    BufferSlice body_{};       // 引用接收缓冲区中的消息体, 不复制数据
+    std::string owned_body_{};  // 跨帧组装的消息体
+    bool is_chunk_{false};
+    std::uint8_t flags_{0};
+    std::uint64_t offset_{0};
+    bool last_{true};
+    std::chrono::steady_clock::time_point enqueue_time_{};  // 投递到逻辑层的时间, 用于统计排队延迟
 };
 
 }  // namespace network
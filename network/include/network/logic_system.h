@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "common/singleton.h"
 #include "network/base/session.h"
@@ -15,15 +21,66 @@
 
 namespace network {
 
+/// @brief 逻辑层分片运行指标快照, 时间单位为纳秒
+struct LogicShardMetrics {
+    std::size_t queue_depth{0};
+    std::uint64_t processed{0};
+    std::uint64_t paused{0};  // 队列超过高水位而暂停会话读取的次数
+    std::uint64_t total_wait_ns{0};
+    std::uint64_t max_wait_ns{0};
+    std::uint64_t total_run_ns{0};
+};
+
+/// @brief 分片的逻辑处理系统
+/// - 每个分片一个工作线程和一条队列, 消息按会话哈希到分片, 同一会话的消息按接收顺序串行处理
+/// - 普通回调收到完整的消息 (多帧消息由会话组装), 流式回调按到达的数据分片收到 MsgChunk, 不缓存整条消息
+/// - 分片队列达到 kHighWatermark 时 PostMsgToQueue 返回 false, 会话暂停读取;
+///   队列回落到 kLowWatermark 时调用 Session::ResumeRead 恢复, 背压通过 TCP 窗口传递给对端
 class LogicSystem : public pyc::Singleton<LogicSystem> {
     friend class pyc::Singleton<LogicSystem>;
-    using FunCallBack = std::function<void(const std::shared_ptr<Session>&, const std::string& msg_data)>;
+    using FunCallBack = std::function<void(const std::shared_ptr<Session>&, std::string_view msg_data)>;
 
 public:
-    void PostMsgToQueue(std::unique_ptr<LogicNode> msg);
+    using StreamCallBack = std::function<void(const std::shared_ptr<Session>&, const MsgChunk& chunk)>;
+
+    static constexpr std::size_t kHighWatermark = kMaxRecvQueue;    // 暂停读取的队列长度
+    static constexpr std::size_t kLowWatermark = kMaxRecvQueue / 2;  // 恢复读取的队列长度
+
+    /// @brief 投递消息, 返回 false 表示所在分片已超过高水位, 会话应暂停读取直到 ResumeRead 被调用
+    bool PostMsgToQueue(std::unique_ptr<LogicNode> msg);
+
+    /// @brief 注册流式处理回调, 该 id 的消息不再组装, 按到达的数据分片交给回调
+    /// 需要在开始接收消息之前注册, 运行期间不能修改
+    void RegisterStreamCallBack(MsgId msg_id, StreamCallBack callback) {
+        stream_callback_map_[msg_id] = std::move(callback);
+    }
+
+    /// @brief 该 id 的消息是否流式处理
+    bool IsStreaming(MsgId msg_id) const { return stream_callback_map_.contains(msg_id); }
+
+    std::size_t ShardCount() const { return shards_.size(); }
+
+    LogicShardMetrics ShardMetrics(std::size_t index) const;
 
 private:
-    LogicSystem();
+    using Clock = std::chrono::steady_clock;
+
+    struct alignas(64) Shard {
+        std::mutex mutex_{};
+        std::condition_variable consume_{};
+        std::deque<std::unique_ptr<LogicNode>> msg_queue_{};
+        std::vector<std::shared_ptr<Session>> paused_sessions_{};  // 因本分片背压而暂停读取的会话
+        std::thread work_thread_{};
+
+        std::atomic<std::size_t> queue_depth_{0};
+        std::atomic<std::uint64_t> processed_{0};
+        std::atomic<std::uint64_t> paused_{0};
+        std::atomic<std::uint64_t> total_wait_ns_{0};
+        std::atomic<std::uint64_t> max_wait_ns_{0};
+        std::atomic<std::uint64_t> total_run_ns_{0};
+    };
+
+    LogicSystem(std::size_t shard_count = std::max(1u, std::thread::hardware_concurrency() / 2));
 
     ~LogicSystem();
 
@@ -31,21 +88,22 @@ private:
     void RegisterCallBack();
 
     /// @brief 处理 kMsgHelloWorld 类型的消息
-    void HelloWorldCallBack(const std::shared_ptr<Session>& session, const std::string& msg_data);
+    void HelloWorldCallBack(const std::shared_ptr<Session>& session, std::string_view msg_data);
+
+    /// @brief 会话所在的分片
+    Shard& ShardOf(const Session& session);
 
-    /// @brief 线程调用处理消息
-    void DealMsg();
+    /// @brief 分片工作线程调用处理消息
+    void DealMsg(Shard& shard);
 
-    /// @brief 处理队列中的第一个消息
-    void DealFirstMsg();
+    /// @brief 处理一条消息并更新分片指标
+    void DealOneMsg(Shard& shard, const LogicNode& msg_node);
 
 private:
-    std::queue<std::unique_ptr<LogicNode>> msg_queue_{};
-    std::mutex mutex_{};
-    std::condition_variable consume_{};
-    std::thread work_thread_{};
-    bool is_stop_{false};
+    std::vector<std::unique_ptr<Shard>> shards_{};
+    std::atomic<bool> is_stop_{false};
     std::unordered_map<MsgId, FunCallBack> callback_map_{};
+    std::unordered_map<MsgId, StreamCallBack> stream_callback_map_{};
 };
 
 }  // namespace network
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <numeric>
 
 #include "common/noncopyable.h"
+#include "network/base/mpsc_queue.h"
 
 namespace network {
 
 using MsgSizeType = unsigned short;
 
 enum class MsgId : MsgSizeType {
+    kMsgHeartbeat = 1000,  // 空闲检测心跳, 消息体为空, 收到后只刷新连接的活跃时间
     kMsgHelloWorld = 1001,
 
     kMaxId,
@@ -23,14 +26,35 @@ struct MsgHead {
     static MsgHead ParseHead(const char* data);
 };
 
+/// @brief v2 帧标志位
+enum FrameFlag : std::uint8_t {
+    kFrameContinuation = 0x01,  // 消息未结束, 后续帧 (id 相同) 继续携带消息体
+    kFrameCompressed = 0x02,    // 消息体已由发送方压缩, 原样交给处理函数解压
+};
+
+/// @brief v2 帧头: [kFrameV2Magic: u8][flags: u8][id: u16][length: u32], 网络字节序
+/// v1 帧头的第一个字节是 id 的高字节, 合法的 id 不会以 kFrameV2Magic 开头, 两种帧可以在同一连接上混用
+struct FrameHead {
+    MsgId id;
+    std::uint8_t flags;
+    std::uint32_t length;
+
+    /// @brief 从网络数据中解析出 v2 帧头, data 至少包含 kFrameHeadLength 字节
+    static FrameHead ParseHead(const char* data);
+};
+
 static constexpr std::size_t kHeadLength = sizeof(MsgHead);  // tlv 头部长度
 static constexpr std::size_t kMaxLength = 2ul * 1024;        // 消息体最大长度 2KB
 static constexpr std::size_t kMaxRecvQueue = 10000;          // 接收队列最大长度
 static constexpr std::size_t kMaxSendQueue = 1000;           // 发送队列最大长度
 
+static constexpr std::uint8_t kFrameV2Magic = 0xff;                 // v2 帧头的第一个字节
+static constexpr std::size_t kFrameHeadLength = 8;                  // v2 帧头长度
+static constexpr std::size_t kMaxMessageLength = 64ul * 1024 * 1024;  // 非流式处理时组装的消息最大长度 64MB
+
 class MsgNode : public pyc::Noncopyable {
 public:
-    MsgNode(MsgSizeType max_len) : total_len_(max_len) {
+    MsgNode(std::size_t max_len) : total_len_(max_len) {
         data_ = new char[total_len_ + 1];
         data_[total_len_] = '\0';
     }
@@ -68,9 +92,13 @@ private:
     MsgId msg_id_;
 };
 
-class SendNode : public MsgNode {
+class SendNode : public MsgNode, public MpscNode {
 public:
+    /// @brief v1 帧, 消息体不超过 kMaxLength
     SendNode(const char* msg, MsgSizeType max_len, MsgId msg_id);
+
+    /// @brief v2 帧, 消息体长度不超过 UINT32_MAX, flags 为 FrameFlag 的组合
+    SendNode(const char* msg, std::size_t max_len, MsgId msg_id, std::uint8_t flags);
 };
 
 }  // namespace network
@@ -12,6 +12,12 @@ public:
 
     void Start() override;
 
+    /// @brief 通过 strand 恢复读取, 与正在执行的读回调串行
+    void ResumeRead() override;
+
+    /// @brief 通过 strand 关闭连接
+    void Close() override;
+
 protected:
     void AsyncRead() override;
     void AsyncWrite() override;
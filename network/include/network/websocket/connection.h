@@ -1,13 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 
+#include "network/base/idle_timer_wheel.h"
+#include "network/base/session_registry.h"
+#include "network/websocket/ws_frame.h"
+
 namespace network {
 
 namespace asio = boost::asio;
@@ -15,17 +21,46 @@ namespace beast = boost::beast;
 namespace websocket = beast::websocket;
 using tcp = asio::ip::tcp;
 
+/// @brief 发送队列已满时的处理方式
+enum class OverflowPolicy {
+    kDrop,        // 丢弃新消息, 适合可以容忍丢失的通知
+    kDisconnect,  // 断开连接, 由客户端重连后重新同步
+};
+
+/// @brief 连接的发送队列配置, 慢速消费者最多积压 max_frames 条消息
+struct SendQueueOptions {
+    std::size_t max_frames{1024};
+    OverflowPolicy overflow{OverflowPolicy::kDrop};
+};
+
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
     Connection(asio::io_context& io_context);
 
     tcp::socket& Socket() { return beast::get_lowest_layer(*websocket_).socket(); }
 
-    const std::string& GetUuid() const { return uuid_; }
+    SessionId GetId() const { return id_; }
 
     /// @brief 开启 websocket 连接
     void StartAccept();
 
+    /// @brief 按 policy 开启空闲检测, 需在 StartAccept 前调用
+    /// 空闲超过 heartbeat_interval 时发送 ping, 收到任何数据帧或控制帧都视为活跃, 超过 idle_timeout 时关闭连接
+    void WatchIdle(const IdlePolicy& policy);
+
+    /// @brief 设置发送队列配置, 需在 StartAccept 前调用
+    void SetSendQueueOptions(const SendQueueOptions& options) { send_options_ = options; }
+
+    /// @brief 把消息放入发送队列, 可在任意线程调用, 同一个 frame 可以同时发给多个连接
+    /// @return 连接已关闭或队列已满时返回 false, 队列已满时按 OverflowPolicy 丢弃消息或断开连接
+    bool Send(WsFramePtr frame);
+
+    /// @brief 关闭连接, 可在任意线程调用
+    void Close();
+
+    /// @brief 因队列已满而丢弃的消息数
+    std::uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
 private:
     void HandleAccept(const beast::error_code& error_code);
 
@@ -33,19 +68,25 @@ private:
 
     void HandleRead(const beast::error_code& error_code);
 
-    void AsyncSend(std::string msg);
-
+    /// @brief 写出队首消息, 只在 strand 上调用
     void AsyncWrite();
 
     void HandleSend(const beast::error_code& error_code);
 
+    /// @brief 连接出错时停止空闲检测并移出 ConnectionManager
+    void Remove();
+
 private:
     asio::io_context& io_context_;
     std::unique_ptr<websocket::stream<beast::tcp_stream>> websocket_;
-    std::string uuid_{};
+    const SessionId id_{NextSessionId()};
     beast::flat_buffer recv_buffer_{};
-    std::queue<std::string> send_queue_{};
+    SendQueueOptions send_options_{};
+    std::deque<WsFramePtr> send_queue_{};  // 队首是正在写出的消息
     std::mutex send_mutex_{};
+    std::atomic<bool> closed_{false};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::shared_ptr<IdleWatch> idle_watch_{};
 };
 
-}  // namespace network
\ No newline at end of file
+}  // namespace network
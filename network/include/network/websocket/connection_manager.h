@@ -1,26 +1,87 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/singleton.h"
+#include "network/base/session_registry.h"
 #include "network/websocket/connection.h"
+#include "network/websocket/ws_frame.h"
 
 namespace network {
 
+/// @brief 广播运行指标快照
+struct BroadcastMetrics {
+    std::uint64_t broadcasts{0};  // Broadcast 调用次数
+    std::uint64_t deliveries{0};  // 成功放入发送队列的次数
+    std::uint64_t dropped{0};     // 连接已关闭或发送队列已满而未投递的次数
+};
+
+/// @brief 管理所有 websocket 连接和房间
+/// - 广播时消息只编码一次, 所有目标连接共享同一个 WsFrame, 每个连接的发送队列只保存引用
+/// - 慢速消费者由各连接的有界发送队列处理, 不影响其他连接
+/// - 房间表使用读写锁, 广播只持读锁复制成员快照, 在锁外投递
 class ConnectionManager : public pyc::Singleton<ConnectionManager> {
     friend class pyc::Singleton<ConnectionManager>;
 
 public:
     void AddConnection(const std::shared_ptr<Connection>& connection);
 
-    void RemoveConnection(const std::string& uuid);
+    /// @brief 删除连接并退出其加入的所有房间
+    void RemoveConnection(SessionId id);
+
+    std::shared_ptr<Connection> Find(SessionId id) const { return connections_.Find(id); }
+
+    std::size_t Size() const { return connections_.Size(); }
+
+    /// @brief 对每个连接调用 f(const std::shared_ptr<Connection>&)
+    template <typename F>
+    void ForEach(F&& f) const {
+        connections_.ForEach(std::forward<F>(f));
+    }
+
+    /// @brief 加入房间, 房间不存在时创建
+    /// @return 连接未登记或已被删除时返回 false, 不会加入房间
+    bool Join(const std::string& room, const std::shared_ptr<Connection>& connection);
+
+    /// @brief 退出房间, 房间为空时删除
+    void Leave(const std::string& room, SessionId id);
+
+    std::size_t RoomSize(const std::string& room) const;
+
+    /// @brief 发送给所有连接, 返回成功投递的连接数
+    std::size_t Broadcast(const WsFramePtr& frame);
+
+    /// @brief 发送给房间内的所有连接, 返回成功投递的连接数
+    std::size_t Broadcast(const std::string& room, const WsFramePtr& frame);
+
+    BroadcastMetrics Metrics() const;
 
 private:
     ConnectionManager() = default;
 
+    /// @brief 退出房间, 需持有 rooms_mutex_ 写锁
+    void LeaveLocked(const std::string& room, SessionId id);
+
+    /// @brief 投递并记录指标
+    bool Deliver(Connection& connection, const WsFramePtr& frame);
+
 private:
-    std::unordered_map<std::string, std::shared_ptr<Connection>> connections_;
+    SessionRegistry<Connection> connections_;
+
+    mutable std::shared_mutex rooms_mutex_{};
+    std::unordered_map<std::string, std::unordered_map<SessionId, std::weak_ptr<Connection>>> rooms_{};
+    std::unordered_map<SessionId, std::vector<std::string>> joined_rooms_{};  // 连接加入的房间, 用于断开时退出
+
+    std::atomic<std::uint64_t> broadcasts_{0};
+    std::atomic<std::uint64_t> deliveries_{0};
+    std::atomic<std::uint64_t> dropped_{0};
 };
 
 }  // namespace network
@@ -3,6 +3,7 @@
 #include <boost/asio.hpp>
 
 #include "common/noncopyable.h"
+#include "network/websocket/connection.h"
 
 namespace network {
 
@@ -16,9 +17,19 @@ public:
     /// @brief 开启 tcp 连接
     void StartAccept();
 
+    /// @brief 之后接受的连接使用的空闲策略, 默认不检测
+    void SetIdlePolicy(const IdlePolicy& policy) { idle_policy_ = policy; }
+
+    /// @brief 之后接受的连接使用的发送队列配置
+    void SetSendQueueOptions(const SendQueueOptions& options) { send_options_ = options; }
+
+    unsigned short Port() const { return acceptor_.local_endpoint().port(); }
+
 private:
     asio::io_context& io_context_;
     tcp::acceptor acceptor_;
+    IdlePolicy idle_policy_{};
+    SendQueueOptions send_options_{};
 };
 
 }  // namespace network
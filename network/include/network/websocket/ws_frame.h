@@ -0,0 +1,21 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace network {
+
+/// @brief 不可变的 websocket 消息, 广播时所有连接共享同一份
+/// 服务端发出的帧不加掩码, 各连接只生成几个字节的帧头, 消息体以 const_buffer 直接写出, 不复制
+struct WsFrame {
+    std::string payload;
+    bool text{true};
+};
+
+using WsFramePtr = std::shared_ptr<const WsFrame>;
+
+inline WsFramePtr MakeWsFrame(std::string payload, bool text = true) {
+    return std::make_shared<const WsFrame>(WsFrame{std::move(payload), text});
+}
+
+}  // namespace network
@@ -0,0 +1,152 @@
+#include "network/base/async_log.h"
+
+#include <cstdlib>
+
+namespace network {
+
+namespace {
+
+constexpr std::size_t kBatchBytes = 64 * 1024;  // 批量写出的字节数上限
+
+}  // namespace
+
+bool LogRateLimiter::Allow(std::uint64_t& suppressed) {
+    const std::int64_t now =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    std::int64_t window = window_.load(std::memory_order_relaxed);
+    // 进入新窗口时由一个线程清零计数, 并发的少量误差可以接受
+    if (now != window && window_.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+        count_.store(0, std::memory_order_relaxed);
+    }
+    if (count_.fetch_add(1, std::memory_order_relaxed) >= per_second_) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+AsyncLog& AsyncLog::GetInstance() {
+    // 有意不析构, 见类注释
+    static AsyncLog* instance = []() {
+        auto* log = new AsyncLog();
+        std::atexit([]() { GetInstance().Stop(); });
+        return log;
+    }();
+    return *instance;
+}
+
+AsyncLog::AsyncLog() : write_thread_([this]() { WriteThread(); }) {}
+
+std::string_view AsyncLog::ToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::kDebug:
+            return "DEBUG";
+        case LogLevel::kInfo:
+            return "INFO";
+        case LogLevel::kWarn:
+            return "WARN";
+        case LogLevel::kError:
+            return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+void AsyncLog::Push(std::unique_ptr<Record> record) {
+    if (stopped_.load(std::memory_order_acquire)) {
+        std::fputs(record->text.c_str(), output_.load(std::memory_order_relaxed));
+        written_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (pending_.load(std::memory_order_relaxed) >= kMaxPending) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // 先计数再链接, 写线程取出的条数不会超过已计数的条数, pending_ 不会减到负数
+    const std::size_t pending = pending_.fetch_add(1, std::memory_order_acq_rel);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    queue_.Push(std::move(record));
+    // 队列从空变为非空时唤醒写线程, 其余情况只有一次原子加
+    if (pending == 0) {
+        pending_.notify_one();
+    }
+}
+
+void AsyncLog::WriteThread() {
+    std::string batch;
+    for (;;) {
+        pending_.wait(0, std::memory_order_acquire);
+        if (Drain(batch) == 0) {
+            if (stopped_.load(std::memory_order_acquire)) {
+                return;
+            }
+            // 生产者已计数但还未完成链接
+            std::this_thread::yield();
+        }
+    }
+}
+
+std::size_t AsyncLog::Drain(std::string& batch) {
+    std::FILE* output = output_.load(std::memory_order_relaxed);
+    // 每轮最多取出开始时已计数的条数, 与 Session::FlushSendQueue 相同
+    const std::size_t pending = pending_.load(std::memory_order_acquire);
+    std::size_t count = 0;
+    batch.clear();
+    while (count < pending) {
+        auto record = queue_.Pop();
+        if (!record) {
+            break;
+        }
+        batch += record->text;
+        count++;
+        if (batch.size() >= kBatchBytes) {
+            std::fwrite(batch.data(), 1, batch.size(), output);
+            batch.clear();
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+    std::fwrite(batch.data(), 1, batch.size(), output);
+    std::fflush(output);
+
+    pending_.fetch_sub(count, std::memory_order_acq_rel);
+    written_.fetch_add(count, std::memory_order_relaxed);
+    flushed_.fetch_add(count, std::memory_order_release);
+    flushed_.notify_all();
+    return count;
+}
+
+void AsyncLog::Flush() {
+    const std::uint64_t target = pushed_.load(std::memory_order_relaxed);
+    std::uint64_t flushed = flushed_.load(std::memory_order_acquire);
+    while (flushed < target && !stopped_.load(std::memory_order_acquire)) {
+        flushed_.wait(flushed, std::memory_order_acquire);
+        flushed = flushed_.load(std::memory_order_acquire);
+    }
+}
+
+void AsyncLog::Stop() {
+    if (stopped_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    // 唤醒写线程, 写出剩余日志后退出
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    pending_.notify_one();
+    write_thread_.join();
+    flushed_.notify_all();
+
+    std::string batch;
+    Drain(batch);
+}
+
+LogMetrics AsyncLog::Metrics() const {
+    LogMetrics metrics;
+    metrics.written = written_.load(std::memory_order_relaxed);
+    metrics.dropped = dropped_.load(std::memory_order_relaxed);
+    metrics.suppressed = suppressed_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+}  // namespace network
@@ -0,0 +1,78 @@
+#include "network/base/buffer_pool.h"
+
+namespace network {
+
+namespace {
+
+/// @brief 把 BufferPool 挂在 io_context 上, 每个 io_context 一个实例
+class BufferPoolService : public asio::execution_context::service {
+public:
+    static inline asio::execution_context::id id;
+
+    explicit BufferPoolService(asio::execution_context& context)
+        : asio::execution_context::service(context), pool_(std::make_shared<BufferPool>()) {}
+
+    const std::shared_ptr<BufferPool>& Pool() const { return pool_; }
+
+private:
+    void shutdown() override {}
+
+private:
+    std::shared_ptr<BufferPool> pool_;
+};
+
+}  // namespace
+
+void Buffer::Release() {
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // 先取出池的引用, 归还后内存块可能立即被其他线程复用
+        std::shared_ptr<BufferPool> pool = std::move(pool_);
+        pool->Recycle(this);
+    }
+}
+
+BufferPool::~BufferPool() {
+    for (Buffer* buffer : free_buffers_) {
+        delete buffer;
+    }
+}
+
+std::shared_ptr<BufferPool> BufferPool::ForIoContext(asio::io_context& io_context) {
+    return asio::use_service<BufferPoolService>(io_context).Pool();
+}
+
+BufferRef BufferPool::Acquire() {
+    Buffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_buffers_.empty()) {
+            buffer = free_buffers_.back();
+            free_buffers_.pop_back();
+        }
+    }
+    if (!buffer) {
+        buffer = new Buffer;  // 不做值初始化, 避免清零整个内存块
+        allocated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    buffer->pool_ = shared_from_this();
+    return BufferRef(buffer);
+}
+
+std::size_t BufferPool::FreeCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_buffers_.size();
+}
+
+void BufferPool::Recycle(Buffer* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_buffers_.size() < kMaxFreeBuffers) {
+            free_buffers_.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+    allocated_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace network
@@ -0,0 +1,159 @@
+#include "network/base/idle_timer_wheel.h"
+
+#include <algorithm>
+
+namespace network {
+
+IdleTimerWheel::IdleTimerWheel(asio::io_context& io_context)
+    : asio::execution_context::service(io_context),
+      timer_(io_context),
+      start_ns_(IdleWatch::NowNs()),
+      tick_ns_(std::chrono::nanoseconds(kDefaultTick).count()),
+      slots_(kSlots) {}
+
+IdleTimerWheel& IdleTimerWheel::ForIoContext(asio::io_context& io_context) {
+    return asio::use_service<IdleTimerWheel>(io_context);
+}
+
+std::shared_ptr<IdleWatch> IdleTimerWheel::Watch(const IdlePolicy& policy, IdleWatch::Callback on_heartbeat,
+                                                 IdleWatch::Callback on_timeout) {
+    if (!policy.Enabled()) {
+        return nullptr;
+    }
+    auto watch = std::make_shared<IdleWatch>(policy, std::move(on_heartbeat), std::move(on_timeout));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        return nullptr;
+    }
+    Schedule(watch, IdleWatch::NowNs());
+    watched_.fetch_add(1, std::memory_order_relaxed);
+    Arm();
+    return watch;
+}
+
+void IdleTimerWheel::SetTick(std::chrono::milliseconds tick) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 换算已处理的 tick, 保持已排期的检测项不被跳过
+    const std::int64_t processed_ns = start_ns_ + static_cast<std::int64_t>(processed_tick_) * tick_ns_;
+    tick_ns_ = std::max<std::int64_t>(std::chrono::nanoseconds(tick).count(), 1);
+    start_ns_ = processed_ns - static_cast<std::int64_t>(processed_tick_) * tick_ns_;
+}
+
+IdleMetrics IdleTimerWheel::Metrics() const {
+    IdleMetrics metrics;
+    metrics.watched = watched_.load(std::memory_order_relaxed);
+    metrics.heartbeats = heartbeats_.load(std::memory_order_relaxed);
+    metrics.reaped = reaped_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void IdleTimerWheel::shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    timer_.cancel();
+    for (auto& slot : slots_) {
+        slot.clear();
+    }
+}
+
+std::uint64_t IdleTimerWheel::CurrentTick(std::int64_t now_ns) const {
+    return static_cast<std::uint64_t>(std::max<std::int64_t>(now_ns - start_ns_, 0) / tick_ns_);
+}
+
+void IdleTimerWheel::Schedule(const std::shared_ptr<IdleWatch>& watch, std::int64_t now_ns) {
+    // 下一个检查时间: 空闲超时时间, 启用心跳时取更早的心跳时间
+    const IdlePolicy& policy = watch->policy_;
+    const std::int64_t last_active = watch->last_active_ns_.load(std::memory_order_relaxed);
+    std::int64_t deadline = last_active + std::chrono::nanoseconds(policy.idle_timeout).count();
+    if (policy.heartbeat_interval.count() > 0) {
+        const std::int64_t interval = std::chrono::nanoseconds(policy.heartbeat_interval).count();
+        deadline = std::min(deadline, std::max(last_active, watch->last_heartbeat_ns_) + interval);
+    }
+    deadline = std::max(deadline, now_ns);
+
+    // 向上取整到 tick, 且不早于下一个待处理的 tick
+    const std::uint64_t tick = std::max(CurrentTick(deadline + tick_ns_ - 1), processed_tick_ + 1);
+    watch->expire_tick_ = tick;
+    slots_[tick % kSlots].push_back(watch);
+}
+
+void IdleTimerWheel::Arm() {
+    if (armed_ || stopped_ || watched_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    armed_ = true;
+    const std::int64_t next_ns = start_ns_ + static_cast<std::int64_t>(processed_tick_ + 1) * tick_ns_;
+    timer_.expires_after(std::chrono::nanoseconds(std::max<std::int64_t>(next_ns - IdleWatch::NowNs(), 0)));
+    timer_.async_wait([this](const boost::system::error_code& error_code) {
+        if (error_code != asio::error::operation_aborted) {
+            OnTick();
+        }
+    });
+}
+
+void IdleTimerWheel::OnTick() {
+    std::vector<std::shared_ptr<IdleWatch>> expired;
+    std::int64_t now_ns = IdleWatch::NowNs();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed_ = false;
+        if (stopped_) {
+            return;
+        }
+        // 长时间阻塞后最多处理一圈, 其余槽位中的检测项在这一圈中都会被访问到
+        const std::uint64_t now_tick = CurrentTick(now_ns);
+        const std::uint64_t end_tick = std::min(now_tick, processed_tick_ + kSlots);
+        for (std::uint64_t tick = processed_tick_ + 1; tick <= end_tick; ++tick) {
+            auto& slot = slots_[tick % kSlots];
+            auto remain = std::partition(slot.begin(), slot.end(),
+                                         [now_tick](const auto& watch) { return watch->expire_tick_ > now_tick; });
+            std::move(remain, slot.end(), std::back_inserter(expired));
+            slot.erase(remain, slot.end());
+        }
+        processed_tick_ = std::max(processed_tick_, now_tick);
+    }
+
+    // 回调在锁外执行, 回调中可以关闭连接或发送数据
+    std::vector<std::shared_ptr<IdleWatch>> rescheduled;
+    for (auto& watch : expired) {
+        if (Check(*watch, now_ns)) {
+            rescheduled.push_back(std::move(watch));
+        } else {
+            watched_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        return;
+    }
+    now_ns = IdleWatch::NowNs();
+    for (const auto& watch : rescheduled) {
+        Schedule(watch, now_ns);
+    }
+    Arm();
+}
+
+bool IdleTimerWheel::Check(IdleWatch& watch, std::int64_t now_ns) {
+    if (watch.IsCancelled()) {
+        return false;
+    }
+    const IdlePolicy& policy = watch.policy_;
+    const std::int64_t idle_ns = now_ns - watch.last_active_ns_.load(std::memory_order_relaxed);
+    if (idle_ns >= std::chrono::nanoseconds(policy.idle_timeout).count()) {
+        reaped_.fetch_add(1, std::memory_order_relaxed);
+        watch.Cancel();
+        watch.on_timeout_();
+        return false;
+    }
+
+    const std::int64_t interval = std::chrono::nanoseconds(policy.heartbeat_interval).count();
+    if (interval > 0 && idle_ns >= interval && now_ns - watch.last_heartbeat_ns_ >= interval) {
+        watch.last_heartbeat_ns_ = now_ns;
+        heartbeats_.fetch_add(1, std::memory_order_relaxed);
+        watch.on_heartbeat_();
+    }
+    return true;
+}
+
+}  // namespace network
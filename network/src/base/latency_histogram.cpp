@@ -0,0 +1,75 @@
+#include "network/base/latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace network {
+
+namespace {
+
+/// @brief 值所在分段的位移, 分段 shift 中的值为 [kSubBuckets, 2 * kSubBuckets) << shift
+int ShiftOf(std::uint64_t value) {
+    return std::max(static_cast<int>(std::bit_width(value)) - (LatencyHistogram::kSubBucketBits + 1), 0);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() : counts_(IndexOf(UINT64_MAX) + 1, 0) {}
+
+std::size_t LatencyHistogram::IndexOf(std::uint64_t value) {
+    const int shift = ShiftOf(value);
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(shift) * kSubBuckets + (value >> shift));
+}
+
+std::uint64_t LatencyHistogram::HighestEquivalentValue(std::size_t index) {
+    const std::uint64_t shift = std::max<std::uint64_t>(index / kSubBuckets, 1) - 1;
+    const std::uint64_t sub_bucket = index - shift * kSubBuckets;
+    // 最后一个桶的上界会溢出, 回绕后减一恰好是 UINT64_MAX
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::uint64_t value) {
+    counts_[IndexOf(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < counts_.size(); i++) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+std::uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const auto target = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count_))), 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return std::min(HighestEquivalentValue(i), max_);
+        }
+    }
+    return max_;
+}
+
+}  // namespace network
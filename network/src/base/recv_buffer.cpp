@@ -0,0 +1,105 @@
+#include "network/base/recv_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace network {
+
+namespace {
+
+static_assert(RecvBuffer::kMaxWholeFrameLength >= kHeadLength + kMaxLength, "v1 frame must be delivered whole");
+
+bool IsValidId(MsgId id) { return id <= MsgId::kMaxId; }
+
+}  // namespace
+
+asio::mutable_buffer RecvBuffer::Prepare() {
+    if (!buffer_) {
+        buffer_ = pool_->Acquire();
+        begin_ = end_ = 0;
+    } else if (Buffer::kCapacity - end_ < kMaxWholeFrameLength) {
+        const std::size_t readable = Readable();
+        if (buffer_->UseCount() == 1) {
+            // 没有 BufferSlice 引用该内存块, 原地搬移
+            ::memmove(buffer_->Data(), buffer_->Data() + begin_, readable);
+        } else {
+            BufferRef buffer = pool_->Acquire();
+            ::memcpy(buffer->Data(), buffer_->Data() + begin_, readable);
+            buffer_ = std::move(buffer);
+        }
+        begin_ = 0;
+        end_ = readable;
+    }
+    return asio::buffer(buffer_->Data() + end_, Buffer::kCapacity - end_);
+}
+
+RecvBuffer::ParseResult RecvBuffer::Next(Piece& piece) {
+    // 正在分片交出大帧, 有多少交多少
+    if (stream_remain_ > 0) {
+        if (Readable() == 0) {
+            return ParseResult::kNeedMore;
+        }
+        const std::size_t length = std::min(Readable(), stream_remain_);
+        piece.head = stream_head_;
+        piece.offset = stream_offset_;
+        piece.data = Consume(length);
+        stream_offset_ += length;
+        stream_remain_ -= length;
+        piece.frame_end = stream_remain_ == 0;
+        return ParseResult::kFrame;
+    }
+
+    if (Readable() == 0) {
+        return ParseResult::kNeedMore;
+    }
+
+    const char* data = buffer_->Data() + begin_;
+    std::size_t head_length = kHeadLength;
+    if (static_cast<std::uint8_t>(data[0]) == kFrameV2Magic) {
+        if (Readable() < kFrameHeadLength) {
+            return ParseResult::kNeedMore;
+        }
+        head_length = kFrameHeadLength;
+        piece.head = FrameHead::ParseHead(data);
+        if (!IsValidId(piece.head.id)) {
+            return ParseResult::kInvalid;
+        }
+    } else {
+        if (Readable() < kHeadLength) {
+            return ParseResult::kNeedMore;
+        }
+        const MsgHead head = MsgHead::ParseHead(data);
+        piece.head = FrameHead{head.id, 0, head.length};
+        if (!IsValidId(head.id) || head.length > kMaxLength) {
+            return ParseResult::kInvalid;
+        }
+    }
+
+    const std::size_t frame_length = head_length + piece.head.length;
+    if (Readable() >= frame_length || frame_length <= kMaxWholeFrameLength) {
+        if (Readable() < frame_length) {
+            return ParseResult::kNeedMore;
+        }
+        // 整帧交出
+        begin_ += head_length;
+        piece.offset = 0;
+        piece.data = Consume(piece.head.length);
+        piece.frame_end = true;
+        return ParseResult::kFrame;
+    }
+
+    // 大帧: 跳过帧头, 之后的数据按到达分片交出
+    begin_ += head_length;
+    stream_head_ = piece.head;
+    stream_offset_ = 0;
+    stream_remain_ = piece.head.length;
+    return Next(piece);
+}
+
+BufferSlice RecvBuffer::Consume(std::size_t length) {
+    BufferSlice slice(buffer_, begin_, length);
+    begin_ += length;
+    return slice;
+}
+
+}  // namespace network
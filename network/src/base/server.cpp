@@ -2,6 +2,7 @@
 
 #include <fmt/base.h>
 
+#include "network/base/async_log.h"
 #include "network/base/session.h"
 
 namespace network {
@@ -11,18 +12,17 @@ Server::Server(asio::io_context& io_context, unsigned short port_num)
     fmt::println("[{}]: Server start success on port {}", __func__, port_num);
 }
 
-void Server::DeleteSession(const std::string& uuid) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    sessions_.erase(uuid);
-}
+Server::Server(asio::io_context& io_context) : io_context_(io_context), acceptor_(io_context) {}
+
+void Server::DeleteSession(SessionId id) { sessions_.Remove(id); }
 
 void Server::HandleAccept(const std::shared_ptr<Session>& session, const boost::system::error_code& error_code) {
     if (!error_code) {
+        session->WatchIdle(idle_policy_);
         session->Start();
-        std::lock_guard<std::mutex> lock(mutex_);
-        sessions_.emplace(session->GetUuid(), session);
+        sessions_.Add(session->GetId(), session);
     } else {
-        fmt::println("[{}]: Error code = {}. Message: {}", __func__, error_code.value(), error_code.message());
+        NET_LOG_WARN("Error code = {}. Message: {}", error_code.value(), error_code.message());
     }
 }
 
@@ -1,124 +1,247 @@
 #include "network/base/session.h"
 
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
+#include <algorithm>
 
+#include "network/base/async_log.h"
 #include "network/base/server.h"
 #include "network/logic_system.h"
 #include "network/utils.h"
 
 namespace network {
 
-Session::Session(asio::io_context& io_context, Server* server) : socket_(io_context), server_(server) {
-    boost::uuids::uuid uuid = boost::uuids::random_generator()();
-    uuid_ = boost::uuids::to_string(uuid);
-}
+Session::Session(asio::io_context& io_context, Server* server)
+    : socket_(io_context), server_(server), recv_buffer_(BufferPool::ForIoContext(io_context)) {}
 
 void Session::Send(const char* msg, std::size_t max_len, MsgId msg_id) {
-    std::lock_guard<std::mutex> lock(send_lock_);
-    std::size_t send_queue_size = send_queue_.size();
+    if (max_len <= kMaxLength) {
+        EnqueueSend(std::make_unique<SendNode>(msg, static_cast<MsgSizeType>(max_len), msg_id));
+    } else if (max_len <= UINT32_MAX) {
+        EnqueueSend(std::make_unique<SendNode>(msg, max_len, msg_id, 0));
+    } else {
+        NET_LOG_WARN("Message length = {} is too large", max_len);
+    }
+}
+
+void Session::Send(const std::string& msg, MsgId msg_id) { Send(msg.data(), msg.size(), msg_id); }
+
+bool Session::SendChunk(const char* data, std::size_t len, MsgId msg_id, bool last, std::uint8_t flags) {
+    if (len > UINT32_MAX) {
+        NET_LOG_WARN("Chunk length = {} is too large", len);
+        return false;
+    }
+    flags = last ? (flags & ~kFrameContinuation) : (flags | kFrameContinuation);
+    return EnqueueSend(std::make_unique<SendNode>(data, len, msg_id, flags));
+}
+
+bool Session::EnqueueSend(std::unique_ptr<SendNode> node) {
+    std::size_t send_queue_size = send_pending_.load(std::memory_order_relaxed);
     if (send_queue_size > kMaxSendQueue) {
-        fmt::println("[{}]: Send queue size = {} is full", __func__, send_queue_size);
-        return;
+        NET_LOG_WARN("Send queue size = {} is full", send_queue_size);
+        return false;
     }
-    send_queue_.emplace(std::make_unique<SendNode>(msg, max_len, msg_id));
-    if (send_queue_size > 0) {
-        return;
+    send_queue_.Push(std::move(node));
+    // 计数从 0 变为 1 的线程负责发起写入, 其余线程只入队
+    if (send_pending_.fetch_add(1, std::memory_order_acq_rel) > 0) {
+        return true;
     }
 
-    AsyncWrite();
+    FlushSendQueue();
+    return true;
 }
 
-void Session::Send(const std::string& msg, MsgId msg_id) { Send(msg.data(), msg.size(), msg_id); }
-
 void Session::Stop() {
     if (is_stop_.exchange(true)) {
         return;
     }
 
+    if (idle_watch_) {
+        idle_watch_->Cancel();
+    }
     // 关闭 socket 并取消所有挂起的异步操作
     socket_.close();
     // 从服务器中删除 session 引用
-    server_->DeleteSession(uuid_);
+    server_->DeleteSession(id_);
 }
 
-void Session::ParseBuffer(std::size_t bytes_transferred) {
-    // For debug 打印接收数据
-    // fmt::print("[{}]: Server receive raw data: ", __func__);
-    // PrintBuffer(data_, bytes_transferred);
-    // std::this_thread::sleep_for(std::chrono::seconds(2));
+void Session::WatchIdle(const IdlePolicy& policy) {
+    auto& io_context = static_cast<asio::io_context&>(socket_.get_executor().context());
+    std::weak_ptr<Session> weak_this = shared_from_this();
+    idle_watch_ = IdleTimerWheel::ForIoContext(io_context).Watch(
+        policy,
+        [weak_this]() {
+            if (auto shared_this = weak_this.lock()) {
+                shared_this->Send("", 0, MsgId::kMsgHeartbeat);
+            }
+        },
+        [weak_this]() {
+            if (auto shared_this = weak_this.lock()) {
+                NET_LOG_INFO("Session id = {} idle timeout", shared_this->GetId());
+                shared_this->Close();
+            }
+        });
+}
 
-    // 已经处理的字节
-    std::size_t offset = 0;
-    while (bytes_transferred > 0) {
-        if (!is_head_parsed_) {
-            std::size_t copy_len = recv_head_->Copy(data_ + offset, bytes_transferred);
+bool Session::ParseBuffer(std::size_t bytes_transferred) {
+    recv_buffer_.Commit(bytes_transferred);
+    if (idle_watch_) {
+        idle_watch_->Touch();
+    }
 
-            // 收到的数据不足以解析出头部
-            if (recv_head_->Remain() > 0) {
+    // 已读入的消息全部投递, 逻辑层背压只影响是否发起下一次读取
+    bool keep_reading = true;
+    RecvBuffer::Piece piece{};
+    for (;;) {
+        switch (recv_buffer_.Next(piece)) {
+            case RecvBuffer::ParseResult::kFrame:
+                if (!DispatchPiece(piece)) {
+                    if (is_stop_.load()) {
+                        return false;
+                    }
+                    keep_reading = false;
+                }
                 break;
-            }
-
-            // 更新已处理的字节数
-            offset += copy_len;
-            bytes_transferred -= copy_len;
-            // 获取头部数据
-            MsgHead head = MsgHead::ParseHead(recv_head_->Data());
-            // 头部长度非法
-            if (head.id > MsgId::kMaxId || head.length > kMaxLength) {
-                fmt::println("[{}]: Server receive valid head: {}", __func__, head);
+            case RecvBuffer::ParseResult::kNeedMore:
+                // 收到的数据不足以解析出完整的消息, 等待后续数据
+                return keep_reading;
+            case RecvBuffer::ParseResult::kInvalid:
+                // 头部长度非法
+                NET_LOG_WARN("Server receive valid head: id = {}, length = {}", piece.head.id, piece.head.length);
                 Stop();
-                return;
-            }
-            fmt::println("[{}]: Server receive head: {}", __func__, head);
-            recv_msg_ = std::make_unique<RecvNode>(head.length, head.id);
+                return false;
+        }
+    }
+}
 
-            is_head_parsed_ = true;
-        } else {
-            std::size_t copy_len = recv_msg_->Copy(data_ + offset, bytes_transferred);
+bool Session::DispatchPiece(RecvBuffer::Piece& piece) {
+    auto& logic_system = LogicSystem::GetInstance();
+    const FrameHead& head = piece.head;
+    const bool message_end = piece.frame_end && !(head.flags & kFrameContinuation);
 
-            // 消息的长度小于头部长度, 数据未收全
-            if (recv_msg_->Remain() > 0) {
-                break;
+    // 心跳只用于刷新活跃时间, 不投递给逻辑层; 心跳由时间轮线程发送, 可能插在多帧消息的分片之间
+    if (head.id == MsgId::kMsgHeartbeat && message_end && piece.offset == 0) {
+        return true;
+    }
+    if (piece.offset == 0) {
+        // 发送方的其他线程可能在分片之间插入单帧消息, 与正在接收的多帧消息 id 相同的帧才是它的后续帧
+        const bool continuation = chunked_.active_ && head.id == chunked_.id_;
+        if (!continuation && chunked_.active_ && (head.flags & kFrameContinuation)) {
+            // 同一时间只能有一条多帧消息
+            NET_LOG_WARN("Continuation frame id = {} does not match message id = {}", head.id, chunked_.id_);
+            Stop();
+            return false;
+        }
+        receiving_chunked_ = continuation || (head.flags & kFrameContinuation);
+    }
+    InboundMessage& inbound = receiving_chunked_ ? chunked_ : single_;
+
+    if (!inbound.active_) {
+        NET_LOG_DEBUG("Server receive head: id = {}, flags = {:#x}, length = {}", head.id, head.flags,
+                      head.length);
+        // 单帧且完整的消息, 直接投递, 消息体引用接收缓冲区, 不复制
+        if (message_end && piece.offset == 0) {
+            if (logic_system.IsStreaming(head.id)) {
+                return logic_system.PostMsgToQueue(std::make_unique<LogicNode>(
+                    shared_from_this(), head.id, std::move(piece.data), head.flags, 0, true));
             }
+            return logic_system.PostMsgToQueue(
+                std::make_unique<LogicNode>(shared_from_this(), head.id, std::move(piece.data)));
+        }
+        inbound.active_ = true;
+        inbound.streaming_ = logic_system.IsStreaming(head.id);
+        inbound.id_ = head.id;
+        inbound.flags_ = head.flags & ~kFrameContinuation;
+        inbound.offset_ = 0;
+    }
 
-            // 更新已处理的字节数
-            offset += copy_len;
-            bytes_transferred -= copy_len;
-            // 投递数据
-            LogicSystem::GetInstance().PostMsgToQueue(
-                std::make_unique<LogicNode>(shared_from_this(), std::move(recv_msg_)));
-            // 处理新的数据块
-            is_head_parsed_ = false;
-            recv_head_->Clear();
+    bool keep_reading = true;
+    const std::size_t size = piece.data.Size();
+    if (inbound.streaming_) {
+        keep_reading = logic_system.PostMsgToQueue(std::make_unique<LogicNode>(
+            shared_from_this(), inbound.id_, std::move(piece.data), inbound.flags_, inbound.offset_, message_end));
+    } else {
+        if (inbound.data_.size() + size > kMaxMessageLength) {
+            NET_LOG_WARN("Message id = {} exceeds {} bytes", inbound.id_, kMaxMessageLength);
+            Stop();
+            return false;
+        }
+        inbound.data_.append(piece.data.View());
+        if (message_end) {
+            keep_reading = logic_system.PostMsgToQueue(
+                std::make_unique<LogicNode>(shared_from_this(), inbound.id_, std::move(inbound.data_)));
         }
     }
+    inbound.offset_ += size;
+
+    if (message_end) {
+        inbound = InboundMessage{};
+    }
+    return keep_reading;
 }
 
 void Session::HandleRead(const boost::system::error_code& error_code, std::size_t bytes_transferred) {
     if (error_code) {
-        fmt::println("[{}]: Error code = {}. Message: {}", __func__, error_code.value(), error_code.message());
+        NET_LOG_WARN("Error code = {}. Message: {}", error_code.value(), error_code.message());
         Stop();
         return;
     }
 
-    ParseBuffer(bytes_transferred);
+    // 继续轮询剩余未处理数据, 背压时由 ResumeRead 恢复
+    if (ParseBuffer(bytes_transferred)) {
+        AsyncRead();
+    }
+}
 
-    // 继续轮询剩余未处理数据
-    AsyncRead();
+void Session::ResumeRead() {
+    if (is_stop_.load()) {
+        return;
+    }
+    asio::post(socket_.get_executor(), [shared_this = shared_from_this()]() { shared_this->AsyncRead(); });
+}
+
+void Session::Close() {
+    if (is_stop_.load()) {
+        return;
+    }
+    asio::post(socket_.get_executor(), [shared_this = shared_from_this()]() { shared_this->Stop(); });
+}
+
+void Session::FlushSendQueue() {
+    const std::size_t max_write_bytes = max_write_bytes_.load(std::memory_order_relaxed);
+    const std::size_t pending = send_pending_.load(std::memory_order_acquire);
+    std::size_t write_bytes = 0;
+    while (writing_.size() < std::min(pending, kMaxWriteBuffers) && write_bytes < max_write_bytes) {
+        auto node = send_queue_.Pop();
+        if (!node) {
+            break;
+        }
+        write_bytes += node->Size();
+        write_buffers_.emplace_back(node->Data(), node->Size());
+        writing_.push_back(std::move(node));
+    }
+
+    if (writing_.empty()) {
+        // 生产者已计数但还未完成链接, 稍后重试
+        asio::post(socket_.get_executor(),
+                   [shared_this = shared_from_this()]() { shared_this->FlushSendQueue(); });
+        return;
+    }
+
+    AsyncWrite();
 }
 
 void Session::HandleWrite(const boost::system::error_code& error_code) {
     if (error_code) {
-        fmt::println("[{}]: Error code = {}. Message: {}", __func__, error_code.value(), error_code.message());
+        NET_LOG_WARN("Error code = {}. Message: {}", error_code.value(), error_code.message());
+        // 不清零 send_pending_, 之后的 Send 只入队不再发起写入
         Stop();
         return;
     }
 
-    std::lock_guard<std::mutex> lock(send_lock_);
-    send_queue_.pop();
-    if (!send_queue_.empty()) {
-        AsyncWrite();
+    const std::size_t written = writing_.size();
+    writing_.clear();
+    write_buffers_.clear();
+    if (send_pending_.fetch_sub(written, std::memory_order_acq_rel) > written) {
+        FlushSendQueue();
     }
 }
 
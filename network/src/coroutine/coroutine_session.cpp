@@ -1,17 +1,20 @@
 #include "network/coroutine/coroutine_session.h"
 
-#include <fmt/base.h>
+#include "network/base/async_log.h"
 
 namespace network {
 
 CoroutineSession::~CoroutineSession() {
-    fmt::println("[{}]: CoroutineSession {} destruct uuid = {}", __func__, reinterpret_cast<uint64_t>(this),
-                 uuid_);
+    NET_LOG_DEBUG("CoroutineSession {} destruct id = {}", reinterpret_cast<uint64_t>(this), id_);
 }
 
 void CoroutineSession::Start() {
-    fmt::println("[{}]: CoroutineSession {} start uuid = {}", __func__, reinterpret_cast<uint64_t>(this), uuid_);
-    // 开启协程接收
+    NET_LOG_DEBUG("CoroutineSession {} start id = {}", reinterpret_cast<uint64_t>(this), id_);
+    AsyncRead();
+}
+
+void CoroutineSession::AsyncRead() {
+    // 开启协程接收, 背压时协程退出, 由 ResumeRead 重新开启
     asio::co_spawn(
         io_context_,
         [shared_this = std::static_pointer_cast<CoroutineSession>(shared_from_this())]() -> asio::awaitable<void> {
@@ -23,22 +26,24 @@ void CoroutineSession::Start() {
 asio::awaitable<void> CoroutineSession::CoawaitRead() {
     try {
         while (is_stop_.load() == false) {
-            std::size_t recv_size =
-                co_await socket_.async_read_some(asio::buffer(data_, kMaxLength), asio::use_awaitable);
+            std::size_t recv_size = co_await socket_.async_read_some(recv_buffer_.Prepare(), asio::use_awaitable);
 
-            ParseBuffer(recv_size);
+            if (!ParseBuffer(recv_size)) {
+                break;
+            }
         }
     } catch (const std::exception& e) {
-        fmt::println(stderr, "[{}]: exception: {}", __func__, e.what());
+        NET_LOG_ERROR("exception: {}", e.what());
         Stop();
     }
 }
 
 void CoroutineSession::AsyncWrite() {
-    asio::async_write(
-        socket_, asio::buffer(send_queue_.front()->Data(), send_queue_.front()->Size()),
-        [shared_this = std::static_pointer_cast<CoroutineSession>(shared_from_this())](
-            const boost::system::error_code& error_code, std::size_t) { shared_this->HandleWrite(error_code); });
+    asio::async_write(socket_, write_buffers_,
+                      [shared_this = std::static_pointer_cast<CoroutineSession>(shared_from_this())](
+                          const boost::system::error_code& error_code, std::size_t) {
+                          shared_this->HandleWrite(error_code);
+                      });
 }
 
 }  // namespace network
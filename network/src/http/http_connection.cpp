@@ -0,0 +1,278 @@
+#include "network/http/http_connection.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <exception>
+#include <string_view>
+
+#include <boost/beast/version.hpp>
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#include "network/base/async_log.h"
+
+namespace network {
+
+namespace {
+
+constexpr std::size_t kFileChunkSize = 256 * 1024;  // 一次 sendfile 或读取文件的最大字节数
+
+void SetStatus(HttpResponse& response, http::status status) {
+    response.message.result(status);
+    response.message.set(http::field::content_type, "text/plain");
+    response.message.body() = std::string(http::obsolete_reason(status)) + "\r\n";
+}
+
+}  // namespace
+
+HttpConnection::HttpConnection(tcp::socket&& socket, const Router& router, const HttpServerOptions& options)
+    : stream_(std::move(socket)), idle_timer_(stream_.get_executor()), router_(router), options_(options) {}
+
+void HttpConnection::Start() {
+    // 接受的 socket 绑定在 strand 上, 在 strand 中开始读取
+    asio::dispatch(stream_.get_executor(), [shared_this = shared_from_this()]() { shared_this->AsyncRead(); });
+}
+
+void HttpConnection::AsyncRead() {
+    reading_ = true;
+    parser_.emplace();
+    parser_->body_limit(options_.body_limit);
+    // 写出响应期间发起的读取不计时, 队列写完后由 FinishResponse 开始计时
+    if (responses_.empty()) {
+        StartIdleTimer();
+    }
+    http::async_read(stream_, buffer_, *parser_,
+                     [shared_this = shared_from_this()](const beast::error_code& error_code, std::size_t) {
+                         shared_this->HandleRead(error_code);
+                     });
+}
+
+void HttpConnection::HandleRead(const beast::error_code& error_code) {
+    reading_ = false;
+    idle_timer_.cancel();
+    if (error_code) {
+        closing_ = true;
+        if (error_code == http::error::end_of_stream) {
+            // 对端关闭了发送端, 写完已有的响应后关闭
+            if (!writing_) {
+                Shutdown();
+            }
+            return;
+        }
+        if (error_code.category() == http::make_error_code(http::error::end_of_stream).category()) {
+            // 请求格式错误, 回复后关闭连接
+            HttpResponse response;
+            response.message.version(11);
+            SetStatus(response, error_code == http::error::body_limit ? http::status::payload_too_large
+                                                                      : http::status::bad_request);
+            response.message.keep_alive(false);
+            response.message.prepare_payload();
+            PushResponse(std::move(response), false);
+            return;
+        }
+        if (error_code != beast::error::timeout && error_code != asio::error::operation_aborted) {
+            NET_LOG_WARN("Error code: {}. Message: {}", error_code.value(), error_code.message());
+        }
+        stream_.close();
+        return;
+    }
+
+    Dispatch(parser_->get());
+    if (!closing_ && responses_.size() < options_.max_pipeline) {
+        AsyncRead();
+    }
+}
+
+void HttpConnection::Dispatch(const HttpRequest& request) {
+    HttpResponse response;
+    response.message.version(request.version());
+    response.message.set(http::field::server, BOOST_BEAST_VERSION_STRING);
+    response.message.keep_alive(request.keep_alive());
+
+    std::string_view path(request.target().data(), request.target().size());
+    path = path.substr(0, path.find('?'));
+    const auto match = router_.Find(request.method(), path);
+    if (match.handler) {
+        try {
+            (*match.handler)(request, match.params, response);
+        } catch (const std::exception& e) {
+            NET_LOG_ERROR("Handler exception: {}", e.what());
+            response.file.Reset();
+            response.message.erase(http::field::content_length);
+            SetStatus(response, http::status::internal_server_error);
+        }
+    } else {
+        SetStatus(response, match.path_found ? http::status::method_not_allowed : http::status::not_found);
+    }
+
+    // 处理函数已设置 Content-Length (如文件响应或 HEAD) 时保留, 否则按消息体计算
+    if (!response.HasFile() && response.message.find(http::field::content_length) == response.message.end()) {
+        response.message.prepare_payload();
+    }
+    PushResponse(std::move(response), request.method() == http::verb::head);
+}
+
+void HttpConnection::PushResponse(HttpResponse response, bool head_only) {
+    if (!response.message.keep_alive()) {
+        closing_ = true;
+    }
+    responses_.push_back({std::move(response), head_only});
+    if (!writing_) {
+        AsyncWrite();
+    }
+}
+
+void HttpConnection::AsyncWrite() {
+    writing_ = true;
+    auto& pending = responses_.front();
+    if (!pending.head_only && !pending.response.HasFile()) {
+        http::async_write(stream_, pending.response.message,
+                          [shared_this = shared_from_this()](const beast::error_code& error_code, std::size_t) {
+                              if (error_code) {
+                                  shared_this->stream_.close();
+                                  return;
+                              }
+                              shared_this->FinishResponse();
+                          });
+        return;
+    }
+
+    header_serializer_ = std::make_unique<http::response_serializer<http::string_body>>(pending.response.message);
+    http::async_write_header(
+        stream_, *header_serializer_,
+        [shared_this = shared_from_this()](const beast::error_code& error_code, std::size_t) {
+            shared_this->header_serializer_.reset();
+            if (error_code) {
+                shared_this->stream_.close();
+                return;
+            }
+            const auto& pending = shared_this->responses_.front();
+            if (!pending.head_only && pending.response.HasFile()) {
+                shared_this->SendFile();
+            } else {
+                shared_this->FinishResponse();
+            }
+        });
+}
+
+void HttpConnection::SendFile() {
+    HttpResponse& response = responses_.front().response;
+    auto& socket = stream_.socket();
+
+#if defined(__linux__)
+    boost::system::error_code error_code;
+    socket.native_non_blocking(true, error_code);
+    while (response.file_length > 0 && !error_code) {
+        auto offset = static_cast<off_t>(response.file_offset);
+        const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(response.file_length, kFileChunkSize));
+        const ssize_t sent = ::sendfile(socket.native_handle(), response.file.Get(), &offset, chunk);
+        if (sent > 0) {
+            response.file_offset += static_cast<std::uint64_t>(sent);
+            response.file_length -= static_cast<std::uint64_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // socket 发送缓冲区已满, 可写后继续
+            socket.async_wait(tcp::socket::wait_write,
+                              [shared_this = shared_from_this()](const boost::system::error_code& error_code) {
+                                  if (error_code) {
+                                      shared_this->stream_.close();
+                                      return;
+                                  }
+                                  shared_this->SendFile();
+                              });
+            return;
+        } else {
+            // 出错或文件被截断, 已声明的长度无法满足, 只能关闭连接
+            error_code = sent < 0 ? boost::system::error_code(errno, boost::system::system_category())
+                                  : asio::error::make_error_code(asio::error::eof);
+        }
+    }
+    if (error_code) {
+        NET_LOG_WARN("Error code: {}. Message: {}", error_code.value(), error_code.message());
+        stream_.close();
+        return;
+    }
+    FinishResponse();
+#else
+    // 没有 sendfile 时分块读取文件后写出
+    if (response.file_length == 0) {
+        FinishResponse();
+        return;
+    }
+    if (!file_buffer_) {
+        file_buffer_ = std::make_unique<char[]>(kFileChunkSize);
+    }
+    const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(response.file_length, kFileChunkSize));
+    const ssize_t size =
+        ::pread(response.file.Get(), file_buffer_.get(), chunk, static_cast<off_t>(response.file_offset));
+    if (size <= 0) {
+        stream_.close();
+        return;
+    }
+    response.file_offset += static_cast<std::uint64_t>(size);
+    response.file_length -= static_cast<std::uint64_t>(size);
+    asio::async_write(
+        socket, asio::buffer(file_buffer_.get(), static_cast<std::size_t>(size)),
+        [shared_this = shared_from_this()](const boost::system::error_code& error_code, std::size_t) {
+            if (error_code) {
+                shared_this->stream_.close();
+                return;
+            }
+            shared_this->SendFile();
+        });
+#endif
+}
+
+void HttpConnection::FinishResponse() {
+    const bool keep_alive = responses_.front().response.message.keep_alive();
+    responses_.pop_front();
+    writing_ = false;
+    if (!keep_alive) {
+        Shutdown();
+        return;
+    }
+
+    if (!responses_.empty()) {
+        AsyncWrite();
+    } else if (closing_ && !reading_) {
+        Shutdown();
+        return;
+    } else if (reading_) {
+        StartIdleTimer();
+    }
+    // 流水线已满时暂停的读取在此恢复
+    if (!closing_ && !reading_ && responses_.size() < options_.max_pipeline) {
+        AsyncRead();
+    }
+}
+
+void HttpConnection::StartIdleTimer() {
+    idle_timer_.expires_after(options_.keep_alive_timeout);
+    idle_timer_.async_wait([weak_this = weak_from_this()](const boost::system::error_code& error_code) {
+        auto shared_this = weak_this.lock();
+        if (error_code || !shared_this) {
+            return;
+        }
+        // 取消或重新计时前已经到期的回调仍会执行, 只在连接仍然空闲且计时确实到期时关闭
+        if (!shared_this->reading_ || !shared_this->responses_.empty() ||
+            shared_this->idle_timer_.expiry() > std::chrono::steady_clock::now()) {
+            return;
+        }
+        shared_this->stream_.close();
+    });
+}
+
+void HttpConnection::Shutdown() {
+    // 只关闭发送端, 由客户端先关闭连接, 避免服务器出现大量 TIME_WAIT
+    beast::error_code error_code;
+    stream_.socket().shutdown(tcp::socket::shutdown_send, error_code);
+    stream_.cancel();
+    idle_timer_.cancel();
+}
+
+}  // namespace network
@@ -0,0 +1,14 @@
+#include "network/http/http_message.h"
+
+#include <unistd.h>
+
+namespace network {
+
+void FileHandle::Reset() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+}  // namespace network
@@ -0,0 +1,27 @@
+#include "network/http/http_server.h"
+
+#include <fmt/base.h>
+
+#include "network/base/async_log.h"
+
+namespace network {
+
+HttpServer::HttpServer(asio::io_context& io_context, unsigned short port, const HttpServerOptions& options)
+    : io_context_(io_context), acceptor_(io_context, tcp::endpoint(tcp::v4(), port)), options_(options) {
+    fmt::println("[{}]: Http server start success on port {}", __func__, Port());
+}
+
+void HttpServer::StartAccept() {
+    acceptor_.async_accept(asio::make_strand(io_context_),
+                           [this](const boost::system::error_code& error_code, tcp::socket socket) {
+                               if (!error_code) {
+                                   std::make_shared<HttpConnection>(std::move(socket), router_, options_)->Start();
+                               } else {
+                                   NET_LOG_WARN("Accept error code: {}. Message: {}", error_code.value(),
+                                                error_code.message());
+                               }
+                               StartAccept();
+                           });
+}
+
+}  // namespace network
@@ -0,0 +1,140 @@
+#include "network/http/router.h"
+
+#include <stdexcept>
+
+namespace network {
+
+namespace {
+
+/// @brief 按 '/' 切分路径, 忽略空段
+std::vector<std::string_view> SplitPath(std::string_view path) {
+    std::vector<std::string_view> segments;
+    std::size_t begin = 0;
+    while (begin < path.size()) {
+        std::size_t end = path.find('/', begin);
+        if (end == std::string_view::npos) {
+            end = path.size();
+        }
+        if (end > begin) {
+            segments.push_back(path.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+    return segments;
+}
+
+}  // namespace
+
+Router::Router() : root_(std::make_unique<Node>()) {}
+
+Router::~Router() = default;
+
+void Router::Add(http::verb method, std::string_view pattern, HttpHandler handler) {
+    if (pattern.find_first_of(":*") == std::string_view::npos) {
+        static_routes_[std::string(pattern)][method] = std::move(handler);
+        return;
+    }
+
+    const auto segments = SplitPath(pattern);
+    Node* node = root_.get();
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        const std::string_view segment = segments[i];
+        if (segment.front() == '*') {
+            if (i + 1 != segments.size()) {
+                throw std::invalid_argument("Wildcard must be the last segment: " + std::string(pattern));
+            }
+            if (!node->wildcard_name.empty() && node->wildcard_name != segment.substr(1)) {
+                throw std::invalid_argument("Conflicting wildcard name: " + std::string(pattern));
+            }
+            node->wildcard_name = segment.substr(1);
+            node->wildcard_handlers[method] = std::move(handler);
+            return;
+        }
+        if (segment.front() == ':') {
+            if (!node->param_child) {
+                node->param_child = std::make_unique<Node>();
+                node->param_name = segment.substr(1);
+            } else if (node->param_name != segment.substr(1)) {
+                throw std::invalid_argument("Conflicting parameter name: " + std::string(pattern));
+            }
+            node = node->param_child.get();
+            continue;
+        }
+        auto& child = node->children[std::string(segment)];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    node->handlers[method] = std::move(handler);
+}
+
+const HttpHandler* Router::FindHandler(const Handlers& handlers, http::verb method) {
+    auto iter = handlers.find(method);
+    if (iter == handlers.end() && method == http::verb::head) {
+        iter = handlers.find(http::verb::get);
+    }
+    return iter == handlers.end() ? nullptr : &iter->second;
+}
+
+Router::Match Router::Find(http::verb method, std::string_view path) const {
+    Match match;
+    auto iter = static_routes_.find(path);
+    if (iter != static_routes_.end()) {
+        match.handler = FindHandler(iter->second, method);
+        if (match.handler) {
+            return match;
+        }
+        match.path_found = true;
+    }
+
+    const auto segments = SplitPath(path);
+    if (!MatchNode(*root_, segments, 0, method, match)) {
+        match.params.clear();
+    }
+    return match;
+}
+
+bool Router::MatchNode(const Node& node, const std::vector<std::string_view>& segments, std::size_t index,
+                       http::verb method, Match& match) const {
+    if (index == segments.size() && !node.handlers.empty()) {
+        match.handler = FindHandler(node.handlers, method);
+        if (match.handler) {
+            return true;
+        }
+        match.path_found = true;
+    }
+
+    if (index < segments.size()) {
+        auto iter = node.children.find(segments[index]);
+        if (iter != node.children.end() && MatchNode(*iter->second, segments, index + 1, method, match)) {
+            return true;
+        }
+        if (node.param_child) {
+            match.params[node.param_name] = std::string(segments[index]);
+            if (MatchNode(*node.param_child, segments, index + 1, method, match)) {
+                return true;
+            }
+            match.params.erase(node.param_name);
+        }
+    }
+
+    if (!node.wildcard_name.empty()) {
+        // 剩余的段 (可以为空) 原样交给通配参数
+        std::string_view rest;
+        if (index < segments.size()) {
+            const char* begin = segments[index].data();
+            rest = std::string_view(begin, static_cast<std::size_t>(segments.back().data() +
+                                                                    segments.back().size() - begin));
+        }
+        match.handler = FindHandler(node.wildcard_handlers, method);
+        if (match.handler) {
+            match.params[node.wildcard_name] = std::string(rest);
+            return true;
+        }
+        match.path_found = true;
+    }
+    return false;
+}
+
+}  // namespace network
@@ -0,0 +1,208 @@
+#include "network/http/static_file_handler.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace network {
+
+namespace {
+
+struct ByteRange {
+    std::uint64_t first;
+    std::uint64_t last;  // 包含
+};
+
+std::string_view MimeType(std::string_view path) {
+    static constexpr std::pair<std::string_view, std::string_view> kTypes[] = {
+        {".html", "text/html"},
+        {".htm", "text/html"},
+        {".css", "text/css"},
+        {".js", "application/javascript"},
+        {".json", "application/json"},
+        {".txt", "text/plain"},
+        {".xml", "application/xml"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".ico", "image/vnd.microsoft.icon"},
+        {".pdf", "application/pdf"},
+        {".wasm", "application/wasm"},
+    };
+    const auto dot = path.rfind('.');
+    if (dot != std::string_view::npos) {
+        const std::string_view extension = path.substr(dot);
+        for (const auto& [ext, type] : kTypes) {
+            if (ext == extension) {
+                return type;
+            }
+        }
+    }
+    return "application/octet-stream";
+}
+
+std::optional<std::uint64_t> ParseNumber(std::string_view text) {
+    std::uint64_t value = 0;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size() || text.empty()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// @brief 解析单个字节范围, 格式非法或有多个范围时返回 std::nullopt 表示忽略 Range
+/// 范围不可满足时返回 first > last
+std::optional<ByteRange> ParseRange(std::string_view header, std::uint64_t size) {
+    constexpr std::string_view kPrefix = "bytes=";
+    if (!header.starts_with(kPrefix) || header.find(',') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    header.remove_prefix(kPrefix.size());
+    const auto dash = header.find('-');
+    if (dash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const std::string_view first_text = header.substr(0, dash);
+    const std::string_view last_text = header.substr(dash + 1);
+
+    if (first_text.empty()) {
+        // 后缀范围: 最后 n 个字节
+        const auto suffix = ParseNumber(last_text);
+        if (!suffix) {
+            return std::nullopt;
+        }
+        if (*suffix == 0 || size == 0) {
+            return ByteRange{1, 0};
+        }
+        return ByteRange{size - std::min(*suffix, size), size - 1};
+    }
+
+    const auto first = ParseNumber(first_text);
+    if (!first) {
+        return std::nullopt;
+    }
+    std::uint64_t last = size == 0 ? 0 : size - 1;
+    if (!last_text.empty()) {
+        const auto parsed = ParseNumber(last_text);
+        if (!parsed || *parsed < *first) {
+            return std::nullopt;
+        }
+        last = std::min(*parsed, last);
+    }
+    if (*first >= size) {
+        return ByteRange{1, 0};
+    }
+    return ByteRange{*first, last};
+}
+
+/// @brief 把请求路径映射到 root 下的文件, 包含 ".." 段时返回 std::nullopt
+std::optional<std::filesystem::path> ResolvePath(const std::filesystem::path& root, std::string_view relative) {
+    std::filesystem::path path = root;
+    std::size_t begin = 0;
+    while (begin <= relative.size()) {
+        std::size_t end = relative.find('/', begin);
+        if (end == std::string_view::npos) {
+            end = relative.size();
+        }
+        const std::string_view segment = relative.substr(begin, end - begin);
+        if (segment == ".." || segment.find('\0') != std::string_view::npos) {
+            return std::nullopt;
+        }
+        if (!segment.empty() && segment != ".") {
+            path /= segment;
+        }
+        begin = end + 1;
+    }
+    return path;
+}
+
+void SetError(HttpResponse& response, http::status status) {
+    response.message.result(status);
+    response.message.set(http::field::content_type, "text/plain");
+    response.message.body() = std::string(http::obsolete_reason(status)) + "\r\n";
+}
+
+}  // namespace
+
+HttpHandler MakeStaticFileHandler(std::filesystem::path root, std::string param_name) {
+    return [root = std::move(root), param_name = std::move(param_name)](
+               const HttpRequest& request, const RouteParams& params, HttpResponse& response) {
+        if (request.method() != http::verb::get && request.method() != http::verb::head) {
+            SetError(response, http::status::method_not_allowed);
+            response.message.set(http::field::allow, "GET, HEAD");
+            return;
+        }
+        auto param = params.find(param_name);
+        auto path = ResolvePath(root, param == params.end() ? std::string_view{} : param->second);
+        if (!path) {
+            SetError(response, http::status::forbidden);
+            return;
+        }
+
+        std::error_code error_code;
+        if (std::filesystem::is_directory(*path, error_code)) {
+            *path /= "index.html";
+        }
+        FileHandle file(::open(path->c_str(), O_RDONLY | O_CLOEXEC));
+        struct stat file_stat {};
+        if (!file.IsOpen() || ::fstat(file.Get(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+            SetError(response, http::status::not_found);
+            return;
+        }
+
+        const auto size = static_cast<std::uint64_t>(file_stat.st_size);
+        const auto mtime_ns = static_cast<std::uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000ull +
+                              static_cast<std::uint64_t>(file_stat.st_mtim.tv_nsec);
+        const std::string etag = fmt::format("\"{:x}-{:x}\"", size, mtime_ns);
+        response.message.set(http::field::etag, etag);
+        response.message.set(http::field::accept_ranges, "bytes");
+        const std::string_view mime_type = MimeType(path->native());
+        response.message.set(http::field::content_type, beast::string_view(mime_type.data(), mime_type.size()));
+
+        // If-None-Match 可以是逗号分隔的列表或 *
+        const auto if_none_match = request[http::field::if_none_match];
+        if (!if_none_match.empty() &&
+            (if_none_match == "*" ||
+             std::string_view(if_none_match.data(), if_none_match.size()).find(etag) != std::string_view::npos)) {
+            response.message.result(http::status::not_modified);
+            return;
+        }
+
+        std::uint64_t offset = 0;
+        std::uint64_t length = size;
+        const auto range_header = request[http::field::range];
+        const auto if_range = request[http::field::if_range];
+        if (!range_header.empty() && (if_range.empty() || if_range == etag)) {
+            if (auto range = ParseRange(std::string_view(range_header.data(), range_header.size()), size)) {
+                if (range->first > range->last) {
+                    SetError(response, http::status::range_not_satisfiable);
+                    response.message.set(http::field::content_range, fmt::format("bytes */{}", size));
+                    return;
+                }
+                offset = range->first;
+                length = range->last - range->first + 1;
+                response.message.result(http::status::partial_content);
+                response.message.set(http::field::content_range,
+                                     fmt::format("bytes {}-{}/{}", range->first, range->last, size));
+            }
+        }
+
+        response.message.content_length(length);
+        if (request.method() == http::verb::get && length > 0) {
+            response.file = std::move(file);
+            response.file_offset = offset;
+            response.file_length = length;
+        }
+    };
+}
+
+}  // namespace network
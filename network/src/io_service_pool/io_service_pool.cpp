@@ -2,9 +2,14 @@
 
 #include <fmt/base.h>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace network {
 
-IOServicePool::IOServicePool(std::size_t size) : io_services_(size) {
+IOServicePool::IOServicePool(std::size_t size) : loads_(size), io_services_(size) {
     fmt::println("[{}]: Create {} io_context.", __func__, size);
 
     works_.reserve(size);
@@ -18,12 +23,46 @@ IOServicePool::IOServicePool(std::size_t size) : io_services_(size) {
     }
 }
 
-IOServicePool::~IOServicePool() { fmt::println("[{}]: IOServicePool Exit.", __func__); }
+IOServicePool::~IOServicePool() {
+    Stop();
+    fmt::println("[{}]: IOServicePool Exit.", __func__);
+}
+
+IOServicePool::IOService& IOServicePool::GetIOService() { return io_services_[NextIndex()]; }
 
-IOServicePool::IOService& IOServicePool::GetIOService() {
-    auto& io_service = io_services_[curr_idx_++];
-    curr_idx_ %= io_services_.size();
-    return io_service;
+std::size_t IOServicePool::NextIndex() {
+    if (policy_.load(std::memory_order_relaxed) == LoadBalancePolicy::kLeastLoaded) {
+        // 负载相同时从轮转位置开始选, 避免集中到第一个 io_context
+        const std::size_t start = curr_idx_.fetch_add(1, std::memory_order_relaxed);
+        std::size_t best = start % io_services_.size();
+        for (std::size_t i = 1; i < io_services_.size(); ++i) {
+            const std::size_t index = (start + i) % io_services_.size();
+            if (Load(index) < Load(best)) {
+                best = index;
+            }
+        }
+        return best;
+    }
+    return curr_idx_.fetch_add(1, std::memory_order_relaxed) % io_services_.size();
+}
+
+bool IOServicePool::PinThreads() {
+#if defined(__linux__)
+    const std::size_t cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    bool success = true;
+    for (std::size_t i = 0; i < threads_.size(); ++i) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(i % cpu_count, &cpu_set);
+        if (::pthread_setaffinity_np(threads_[i].native_handle(), sizeof(cpu_set), &cpu_set) != 0) {
+            fmt::println("[{}]: Pin io thread {} to cpu {} failed", __func__, i, i % cpu_count);
+            success = false;
+        }
+    }
+    return success;
+#else
+    return false;
+#endif
 }
 
 void IOServicePool::Stop() {
@@ -34,7 +73,9 @@ void IOServicePool::Stop() {
         work.reset();
     }
     for (auto& thread : threads_) {
-        thread.join();
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
 }
 
@@ -5,7 +5,10 @@
 namespace network {
 
 void IOServicePoolServer::StartAccept() {
-    auto session = std::make_shared<IOServicePoolSession>(IOServicePool::GetInstance().GetIOService(), this);
+    auto& pool = IOServicePool::GetInstance();
+    const std::size_t index = pool.NextIndex();
+    auto session = std::make_shared<IOServicePoolSession>(pool.GetIOService(index), this);
+    session->SetLoadToken(pool.AcquireLoad(index));
     acceptor_.async_accept(session->Socket(), [this, session](const boost::system::error_code& error_code) {
         HandleAccept(session, error_code);
         StartAccept();
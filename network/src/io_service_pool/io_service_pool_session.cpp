@@ -1,21 +1,20 @@
 #include "network/io_service_pool/io_service_pool_session.h"
 
-#include <fmt/base.h>
+#include "network/base/async_log.h"
 
 namespace network {
 
 IOServicePoolSession::~IOServicePoolSession() {
-    fmt::println("[{}]: Session {} destruct uuid = {}", __func__, reinterpret_cast<uint64_t>(this), uuid_);
+    NET_LOG_DEBUG("Session {} destruct id = {}", reinterpret_cast<uint64_t>(this), id_);
 }
 
 void IOServicePoolSession::Start() {
-    fmt::println("[{}]: Session {} start uuid = {}", __func__, reinterpret_cast<uint64_t>(this), uuid_);
+    NET_LOG_DEBUG("Session {} start id = {}", reinterpret_cast<uint64_t>(this), id_);
     AsyncRead();
 }
 
 void IOServicePoolSession::AsyncRead() {
-    ::memset(data_, 0, kMaxLength);
-    socket_.async_read_some(asio::buffer(data_, kMaxLength),
+    socket_.async_read_some(recv_buffer_.Prepare(),
                             [shared_this = std::static_pointer_cast<IOServicePoolSession>(shared_from_this())](
                                 const boost::system::error_code& error_code, std::size_t bytes_transferred) {
                                 shared_this->HandleRead(error_code, bytes_transferred);
@@ -23,10 +22,11 @@ void IOServicePoolSession::AsyncRead() {
 }
 
 void IOServicePoolSession::AsyncWrite() {
-    asio::async_write(
-        socket_, asio::buffer(send_queue_.front()->Data(), send_queue_.front()->Size()),
-        [shared_this = std::static_pointer_cast<IOServicePoolSession>(shared_from_this())](
-            const boost::system::error_code& error_code, std::size_t) { shared_this->HandleWrite(error_code); });
+    asio::async_write(socket_, write_buffers_,
+                      [shared_this = std::static_pointer_cast<IOServicePoolSession>(shared_from_this())](
+                          const boost::system::error_code& error_code, std::size_t) {
+                          shared_this->HandleWrite(error_code);
+                      });
 }
 
 }  // namespace network
@@ -1,85 +1,161 @@
 #include "network/logic_system.h"
 
+#include <algorithm>
+
 #include <fmt/base.h>
 #include <nlohmann/json.hpp>
 
+#include "network/base/async_log.h"
 #include "network/utils.h"
 
 namespace network {
 
-void LogicSystem::PostMsgToQueue(std::unique_ptr<LogicNode> msg) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    msg_queue_.push(std::move(msg));
+bool LogicSystem::PostMsgToQueue(std::unique_ptr<LogicNode> msg) {
+    Shard& shard = ShardOf(*msg->session_);
+    std::shared_ptr<Session> session = msg->session_;
+    msg->enqueue_time_ = Clock::now();
+
+    bool below_watermark = true;
+    std::unique_lock<std::mutex> lock(shard.mutex_);
+    shard.msg_queue_.push_back(std::move(msg));
+    const std::size_t queue_size = shard.msg_queue_.size();
+    shard.queue_depth_.store(queue_size, std::memory_order_relaxed);
+
+    if (queue_size >= kHighWatermark) {
+        below_watermark = false;
+        auto& paused = shard.paused_sessions_;
+        if (std::find(paused.begin(), paused.end(), session) == paused.end()) {
+            paused.push_back(std::move(session));
+            shard.paused_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 
-    if (msg_queue_.size() == 1) {
-        consume_.notify_one();
+    if (queue_size == 1) {
+        shard.consume_.notify_one();
     }
+    return below_watermark;
+}
+
+LogicShardMetrics LogicSystem::ShardMetrics(std::size_t index) const {
+    const Shard& shard = *shards_[index];
+    LogicShardMetrics metrics;
+    metrics.queue_depth = shard.queue_depth_.load(std::memory_order_relaxed);
+    metrics.processed = shard.processed_.load(std::memory_order_relaxed);
+    metrics.paused = shard.paused_.load(std::memory_order_relaxed);
+    metrics.total_wait_ns = shard.total_wait_ns_.load(std::memory_order_relaxed);
+    metrics.max_wait_ns = shard.max_wait_ns_.load(std::memory_order_relaxed);
+    metrics.total_run_ns = shard.total_run_ns_.load(std::memory_order_relaxed);
+    return metrics;
 }
 
-LogicSystem::LogicSystem() {
+LogicSystem::LogicSystem(std::size_t shard_count) {
+    fmt::println("[{}]: Create {} logic shards.", __func__, shard_count);
     RegisterCallBack();
-    work_thread_ = std::thread(&LogicSystem::DealMsg, this);
+
+    shards_.reserve(shard_count);
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        shards_.emplace_back(std::make_unique<Shard>());
+    }
+    for (auto& shard : shards_) {
+        shard->work_thread_ = std::thread(&LogicSystem::DealMsg, this, std::ref(*shard));
+    }
 }
 
 LogicSystem::~LogicSystem() {
-    is_stop_ = true;
-    consume_.notify_one();
-    work_thread_.join();
+    is_stop_.store(true);
+    for (auto& shard : shards_) {
+        // 加锁后通知, 避免工作线程检查完条件还未等待时错过通知
+        std::lock_guard<std::mutex> lock(shard->mutex_);
+        shard->consume_.notify_one();
+    }
+    for (auto& shard : shards_) {
+        shard->work_thread_.join();
+    }
     fmt::println("[{}]: LogicSystem Exit.", __func__);
 }
 
 void LogicSystem::RegisterCallBack() {
     callback_map_[MsgId::kMsgHelloWorld] = [this](const std::shared_ptr<Session>& session,
-                                                  const std::string& msg_data) {
+                                                  std::string_view msg_data) {
         HelloWorldCallBack(session, msg_data);
     };
 }
 
-void LogicSystem::HelloWorldCallBack(const std::shared_ptr<Session>& session, const std::string& msg_data) {
+void LogicSystem::HelloWorldCallBack(const std::shared_ptr<Session>& session, std::string_view msg_data) {
     auto reader = nlohmann::json::parse(msg_data);
     auto msg_id = reader["id"].get<MsgId>();
 
     // 打印消息
     auto receive_msg =
         fmt::format("Server receive msg id = {}, data = \"{}\"", msg_id, reader["data"].get<std::string>());
-    fmt::println("[{}]: {}", __func__, receive_msg);
+    NET_LOG_DEBUG("{}", receive_msg);
     reader["data"] = receive_msg;
 
     session->Send(reader.dump(), msg_id);
 }
 
-void LogicSystem::DealMsg() {
+LogicSystem::Shard& LogicSystem::ShardOf(const Session& session) {
+    return *shards_[session.GetId() % shards_.size()];
+}
+
+void LogicSystem::DealMsg(Shard& shard) {
     for (;;) {
-        std::unique_lock<std::mutex> lock(mutex_);
+        std::unique_ptr<LogicNode> msg_node;
+        std::vector<std::shared_ptr<Session>> resume_sessions;
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex_);
 
-        // 队列为空用条件变量等待
-        while (msg_queue_.empty() && !is_stop_) {
-            consume_.wait(lock);
-        }
+            // 队列为空用条件变量等待
+            shard.consume_.wait(lock, [this, &shard]() { return !shard.msg_queue_.empty() || is_stop_.load(); });
 
-        // 关闭状态, 及时处理清空队列
-        if (is_stop_) {
-            while (!msg_queue_.empty()) {
-                DealFirstMsg();
+            // 关闭状态且队列已清空
+            if (shard.msg_queue_.empty()) {
+                break;
             }
 
-            break;
+            msg_node = std::move(shard.msg_queue_.front());
+            shard.msg_queue_.pop_front();
+            shard.queue_depth_.store(shard.msg_queue_.size(), std::memory_order_relaxed);
+
+            // 回落到低水位, 恢复被暂停的会话
+            if (!shard.paused_sessions_.empty() && shard.msg_queue_.size() <= kLowWatermark) {
+                resume_sessions.swap(shard.paused_sessions_);
+            }
         }
 
-        // 正常处理一条消息
-        DealFirstMsg();
+        for (auto& session : resume_sessions) {
+            session->ResumeRead();
+        }
+        DealOneMsg(shard, *msg_node);
     }
 }
 
-void LogicSystem::DealFirstMsg() {
-    auto& msg_node = msg_queue_.front();
-    auto msg_id = msg_node->recv_node_->GetMsgId();
-    fmt::println("[{}] recv msg id = {}", __func__, msg_id);
-    auto iter = callback_map_.find(msg_id);
-    if (iter != callback_map_.end()) {
-        iter->second(msg_node->session_, std::string(msg_node->recv_node_->Data(), msg_node->recv_node_->Size()));
+void LogicSystem::DealOneMsg(Shard& shard, const LogicNode& msg_node) {
+    const auto start = Clock::now();
+    auto msg_id = msg_node.msg_id_;
+    if (msg_node.is_chunk_) {
+        auto iter = stream_callback_map_.find(msg_id);
+        if (iter != stream_callback_map_.end()) {
+            iter->second(msg_node.session_,
+                         MsgChunk{msg_id, msg_node.flags_, msg_node.offset_, msg_node.last_, msg_node.Body()});
+        }
+    } else {
+        NET_LOG_DEBUG("recv msg id = {}", msg_id);
+        auto iter = callback_map_.find(msg_id);
+        if (iter != callback_map_.end()) {
+            iter->second(msg_node.session_, msg_node.Body());
+        }
+    }
+    const auto end = Clock::now();
+
+    const auto wait_ns = static_cast<std::uint64_t>((start - msg_node.enqueue_time_).count());
+    shard.total_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+    shard.total_run_ns_.fetch_add(static_cast<std::uint64_t>((end - start).count()), std::memory_order_relaxed);
+    // 只有分片的工作线程写入, 不需要 CAS
+    if (wait_ns > shard.max_wait_ns_.load(std::memory_order_relaxed)) {
+        shard.max_wait_ns_.store(wait_ns, std::memory_order_relaxed);
     }
-    msg_queue_.pop();
+    shard.processed_.fetch_add(1, std::memory_order_relaxed);
 }
 
 }  // namespace network
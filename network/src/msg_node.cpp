@@ -9,10 +9,22 @@ namespace network {
 namespace asio = boost::asio;
 
 MsgHead MsgHead::ParseHead(const char* data) {
-    using MsgType = std::pair<std::underlying_type<MsgId>::type, MsgSizeType>;
-    const auto head = *reinterpret_cast<const MsgType*>(data);
-    return MsgHead{static_cast<MsgId>(asio::detail::socket_ops::network_to_host_short(head.first)),
-                   asio::detail::socket_ops::network_to_host_short(head.second)};
+    // 头部可能位于接收缓冲区的任意偏移处, 用 memcpy 读取避免非对齐访问
+    std::underlying_type<MsgId>::type id;
+    MsgSizeType length;
+    ::memcpy(&id, data, sizeof(id));
+    ::memcpy(&length, data + sizeof(id), sizeof(length));
+    return MsgHead{static_cast<MsgId>(asio::detail::socket_ops::network_to_host_short(id)),
+                   asio::detail::socket_ops::network_to_host_short(length)};
+}
+
+FrameHead FrameHead::ParseHead(const char* data) {
+    std::underlying_type<MsgId>::type id;
+    std::uint32_t length;
+    ::memcpy(&id, data + 2, sizeof(id));
+    ::memcpy(&length, data + 4, sizeof(length));
+    return FrameHead{static_cast<MsgId>(asio::detail::socket_ops::network_to_host_short(id)),
+                     static_cast<std::uint8_t>(data[1]), asio::detail::socket_ops::network_to_host_long(length)};
 }
 
 std::size_t MsgNode::Copy(const char* src, std::size_t len) {
@@ -30,4 +42,15 @@ SendNode::SendNode(const char* msg, MsgSizeType max_len, MsgId msg_id) : MsgNode
     ::memcpy(data_ + kHeadLength, msg, max_len);
 }
 
+SendNode::SendNode(const char* msg, std::size_t max_len, MsgId msg_id, std::uint8_t flags)
+    : MsgNode(max_len + kFrameHeadLength) {
+    const auto id = asio::detail::socket_ops::host_to_network_short(pyc::ToUnderlying(msg_id));
+    const auto length = asio::detail::socket_ops::host_to_network_long(static_cast<std::uint32_t>(max_len));
+    data_[0] = static_cast<char>(kFrameV2Magic);
+    data_[1] = static_cast<char>(flags);
+    ::memcpy(data_ + 2, &id, sizeof(id));
+    ::memcpy(data_ + 4, &length, sizeof(length));
+    ::memcpy(data_ + kFrameHeadLength, msg, max_len);
+}
+
 }  // namespace network
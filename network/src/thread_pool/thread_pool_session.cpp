@@ -1,6 +1,6 @@
 #include "network/thread_pool/thread_pool_session.h"
 
-#include <fmt/base.h>
+#include "network/base/async_log.h"
 
 namespace network {
 
@@ -8,18 +8,17 @@ ThreadPoolSession::ThreadPoolSession(asio::io_context& io_context, Server* serve
     : Session(io_context, server), strand_(io_context.get_executor()) {}
 
 ThreadPoolSession::~ThreadPoolSession() {
-    fmt::println("[{}]: Session {} destruct uuid = {}", __func__, reinterpret_cast<uint64_t>(this), uuid_);
+    NET_LOG_DEBUG("Session {} destruct id = {}", reinterpret_cast<uint64_t>(this), id_);
 }
 
 void ThreadPoolSession::Start() {
-    fmt::println("[{}]: Session {} start uuid = {}", __func__, reinterpret_cast<uint64_t>(this), uuid_);
+    NET_LOG_DEBUG("Session {} start id = {}", reinterpret_cast<uint64_t>(this), id_);
     AsyncRead();
 }
 
 void ThreadPoolSession::AsyncRead() {
-    ::memset(data_, 0, kMaxLength);
     socket_.async_read_some(
-        asio::buffer(data_, kMaxLength),
+        recv_buffer_.Prepare(),
         asio::bind_executor(strand_,
                             [shared_this = std::static_pointer_cast<ThreadPoolSession>(shared_from_this())](
                                 const boost::system::error_code& error_code, std::size_t bytes_transferred) {
@@ -27,8 +26,26 @@ void ThreadPoolSession::AsyncRead() {
                             }));
 }
 
+void ThreadPoolSession::ResumeRead() {
+    if (is_stop_.load()) {
+        return;
+    }
+    asio::post(strand_, [shared_this = std::static_pointer_cast<ThreadPoolSession>(shared_from_this())]() {
+        shared_this->AsyncRead();
+    });
+}
+
+void ThreadPoolSession::Close() {
+    if (is_stop_.load()) {
+        return;
+    }
+    asio::post(strand_, [shared_this = std::static_pointer_cast<ThreadPoolSession>(shared_from_this())]() {
+        shared_this->Stop();
+    });
+}
+
 void ThreadPoolSession::AsyncWrite() {
-    asio::async_write(socket_, asio::buffer(send_queue_.front()->Data(), send_queue_.front()->Size()),
+    asio::async_write(socket_, write_buffers_,
                       asio::bind_executor(
                           strand_, [shared_this = std::static_pointer_cast<ThreadPoolSession>(shared_from_this())](
                                        const boost::system::error_code& error_code, std::size_t) {
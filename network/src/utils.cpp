@@ -4,6 +4,8 @@ namespace network {
 
 const char* ToString(MsgId msg_id) {
     switch (msg_id) {
+        case MsgId::kMsgHeartbeat:
+            return "MsgHeartbeat";
         case MsgId::kMsgHelloWorld:
             return "MsgHelloWorld";
         default:
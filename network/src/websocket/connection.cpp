@@ -1,19 +1,13 @@
 #include "network/websocket/connection.h"
 
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
-#include <fmt/base.h>
-
+#include "network/base/async_log.h"
 #include "network/websocket/connection_manager.h"
 
 namespace network {
 
 Connection::Connection(asio::io_context& io_context)
     : io_context_(io_context),
-      websocket_(std::make_unique<websocket::stream<beast::tcp_stream>>(asio::make_strand(io_context))) {
-    boost::uuids::uuid uuid = boost::uuids::random_generator()();
-    uuid_ = boost::uuids::to_string(uuid);
-}
+      websocket_(std::make_unique<websocket::stream<beast::tcp_stream>>(asio::make_strand(io_context))) {}
 
 void Connection::StartAccept() {
     websocket_->async_accept([shared_this = shared_from_this()](const beast::error_code& error_code) {
@@ -21,9 +15,40 @@ void Connection::StartAccept() {
     });
 }
 
+void Connection::WatchIdle(const IdlePolicy& policy) {
+    std::weak_ptr<Connection> weak_this = shared_from_this();
+    idle_watch_ = IdleTimerWheel::ForIoContext(io_context_).Watch(
+        policy,
+        [weak_this]() {
+            if (auto shared_this = weak_this.lock()) {
+                // websocket 流只能在所属 strand 上操作
+                asio::post(shared_this->websocket_->get_executor(), [shared_this]() {
+                    shared_this->websocket_->async_ping({}, [](const beast::error_code&) {});
+                });
+            }
+        },
+        [weak_this]() {
+            if (auto shared_this = weak_this.lock()) {
+                NET_LOG_INFO("Connection id = {} idle timeout", shared_this->GetId());
+                shared_this->Close();
+            }
+        });
+    if (idle_watch_) {
+        websocket_->control_callback([weak_watch = std::weak_ptr<IdleWatch>(idle_watch_)](
+                                         websocket::frame_type, beast::string_view) {
+            if (auto watch = weak_watch.lock()) {
+                watch->Touch();
+            }
+        });
+    }
+}
+
 void Connection::HandleAccept(const beast::error_code& error_code) {
     if (error_code) {
-        fmt::println("[{}]: Error code: {}. Message: {}", __func__, error_code.value(), error_code.message());
+        NET_LOG_WARN("Error code: {}. Message: {}", error_code.value(), error_code.message());
+        if (idle_watch_) {
+            idle_watch_->Cancel();
+        }
         return;
     }
 
@@ -40,50 +65,104 @@ void Connection::AsyncRead() {
 
 void Connection::HandleRead(const beast::error_code& error_code) {
     if (error_code) {
-        fmt::println("[{}]: Error code: {}. Message: {}", __func__, error_code.value(), error_code.message());
-        ConnectionManager::GetInstance().RemoveConnection(GetUuid());
+        NET_LOG_WARN("Error code: {}. Message: {}", error_code.value(), error_code.message());
+        Remove();
         return;
     }
 
-    websocket_->text(websocket_->got_text());
+    if (idle_watch_) {
+        idle_watch_->Touch();
+    }
     std::string recv_data = beast::buffers_to_string(recv_buffer_.data());
     recv_buffer_.consume(recv_buffer_.size());  // 清空
-    fmt::println("[{}]: Received data: {}", __func__, recv_data);
+    NET_LOG_DEBUG("Received data: {}", recv_data);
 
-    AsyncSend(std::move(recv_data));
+    Send(MakeWsFrame(std::move(recv_data), websocket_->got_text()));
     AsyncRead();
 }
 
-void Connection::AsyncSend(std::string msg) {
-    std::lock_guard<std::mutex> lock(send_mutex_);
-    bool is_sending = !send_queue_.empty();
-    send_queue_.push(std::move(msg));
-    if (is_sending) {
+bool Connection::Send(WsFramePtr frame) {
+    if (closed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    bool start_write = false;
+    bool overflow = false;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        if (send_queue_.size() < send_options_.max_frames) {
+            start_write = send_queue_.empty();
+            send_queue_.push_back(std::move(frame));
+        } else {
+            overflow = true;
+        }
+    }
+    if (overflow) {
+        // 队列已满, 慢速消费者
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        if (send_options_.overflow == OverflowPolicy::kDisconnect) {
+            NET_LOG_WARN("Connection id = {} send queue is full, disconnect", id_);
+            Close();
+        }
+        return false;
+    }
+
+    // 队列由空变为非空的线程负责在 strand 上发起写入
+    if (start_write) {
+        asio::post(websocket_->get_executor(),
+                   [shared_this = shared_from_this()]() { shared_this->AsyncWrite(); });
+    }
+    return true;
+}
+
+void Connection::Close() {
+    if (closed_.exchange(true)) {
         return;
     }
-    AsyncWrite();
+    // 关闭底层 socket, 挂起的读写以错误结束后移出 ConnectionManager
+    asio::post(websocket_->get_executor(), [shared_this = shared_from_this()]() {
+        beast::get_lowest_layer(*shared_this->websocket_).close();
+    });
 }
 
 void Connection::AsyncWrite() {
-    websocket_->async_write(asio::buffer(send_queue_.front()),
-                            [shared_this = shared_from_this()](const beast::error_code& error_code, std::size_t) {
-                                shared_this->HandleSend(error_code);
-                            });
+    WsFramePtr frame;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        frame = send_queue_.front();
+    }
+    websocket_->text(frame->text);
+    // 回调持有 frame, 保证写入期间消息体有效
+    websocket_->async_write(
+        asio::buffer(frame->payload),
+        [shared_this = shared_from_this(), frame](const beast::error_code& error_code, std::size_t) {
+            shared_this->HandleSend(error_code);
+        });
 }
 
 void Connection::HandleSend(const beast::error_code& error_code) {
     if (error_code) {
-        fmt::println("[{}]: Error code: {}. Message: {}", __func__, error_code.value(), error_code.message());
-        ConnectionManager::GetInstance().RemoveConnection(GetUuid());
+        NET_LOG_WARN("Error code: {}. Message: {}", error_code.value(), error_code.message());
+        Remove();
         return;
     }
 
-    std::lock_guard<std::mutex> lock(send_mutex_);
-    send_queue_.pop();
-    if (send_queue_.empty()) {
-        return;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        send_queue_.pop_front();
+        if (send_queue_.empty()) {
+            return;
+        }
     }
     AsyncWrite();
 }
 
+void Connection::Remove() {
+    closed_.store(true, std::memory_order_relaxed);
+    if (idle_watch_) {
+        idle_watch_->Cancel();
+    }
+    ConnectionManager::GetInstance().RemoveConnection(GetId());
+}
+
 }  // namespace network
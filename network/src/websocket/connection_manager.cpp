@@ -1,11 +1,122 @@
 #include "network/websocket/connection_manager.h"
 
+#include <algorithm>
+#include <mutex>
+
 namespace network {
 
 void ConnectionManager::AddConnection(const std::shared_ptr<Connection>& connection) {
-    connections_[connection->GetUuid()] = connection;
+    connections_.Add(connection->GetId(), connection);
+}
+
+void ConnectionManager::RemoveConnection(SessionId id) {
+    // 连接在锁外析构
+    auto connection = connections_.Remove(id);
+    std::unique_lock<std::shared_mutex> lock(rooms_mutex_);
+    auto iter = joined_rooms_.find(id);
+    if (iter == joined_rooms_.end()) {
+        return;
+    }
+    auto rooms = std::move(iter->second);
+    joined_rooms_.erase(iter);
+    for (const auto& room : rooms) {
+        LeaveLocked(room, id);
+    }
+}
+
+bool ConnectionManager::Join(const std::string& room, const std::shared_ptr<Connection>& connection) {
+    std::unique_lock<std::shared_mutex> lock(rooms_mutex_);
+    // RemoveConnection 先移出 connections_ 再取 rooms_mutex_, 持锁时仍已登记的连接会由之后的 RemoveConnection 清理
+    if (connections_.Find(connection->GetId()) != connection) {
+        return false;
+    }
+    if (rooms_[room].emplace(connection->GetId(), connection).second) {
+        joined_rooms_[connection->GetId()].push_back(room);
+    }
+    return true;
 }
 
-void ConnectionManager::RemoveConnection(const std::string& uuid) { connections_.erase(uuid); }
+void ConnectionManager::Leave(const std::string& room, SessionId id) {
+    std::unique_lock<std::shared_mutex> lock(rooms_mutex_);
+    auto iter = joined_rooms_.find(id);
+    if (iter != joined_rooms_.end()) {
+        std::erase(iter->second, room);
+        if (iter->second.empty()) {
+            joined_rooms_.erase(iter);
+        }
+    }
+    LeaveLocked(room, id);
+}
+
+void ConnectionManager::LeaveLocked(const std::string& room, SessionId id) {
+    auto iter = rooms_.find(room);
+    if (iter == rooms_.end()) {
+        return;
+    }
+    iter->second.erase(id);
+    if (iter->second.empty()) {
+        rooms_.erase(iter);
+    }
+}
+
+std::size_t ConnectionManager::RoomSize(const std::string& room) const {
+    std::shared_lock<std::shared_mutex> lock(rooms_mutex_);
+    auto iter = rooms_.find(room);
+    return iter == rooms_.end() ? 0 : iter->second.size();
+}
+
+std::size_t ConnectionManager::Broadcast(const WsFramePtr& frame) {
+    broadcasts_.fetch_add(1, std::memory_order_relaxed);
+    std::size_t delivered = 0;
+    connections_.ForEach([&](const std::shared_ptr<Connection>& connection) {
+        if (Deliver(*connection, frame)) {
+            delivered++;
+        }
+    });
+    return delivered;
+}
+
+std::size_t ConnectionManager::Broadcast(const std::string& room, const WsFramePtr& frame) {
+    broadcasts_.fetch_add(1, std::memory_order_relaxed);
+    std::vector<std::shared_ptr<Connection>> members;
+    {
+        std::shared_lock<std::shared_mutex> lock(rooms_mutex_);
+        auto iter = rooms_.find(room);
+        if (iter == rooms_.end()) {
+            return 0;
+        }
+        members.reserve(iter->second.size());
+        for (const auto& [id, weak_connection] : iter->second) {
+            if (auto connection = weak_connection.lock()) {
+                members.push_back(std::move(connection));
+            }
+        }
+    }
+
+    std::size_t delivered = 0;
+    for (const auto& connection : members) {
+        if (Deliver(*connection, frame)) {
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+bool ConnectionManager::Deliver(Connection& connection, const WsFramePtr& frame) {
+    if (connection.Send(frame)) {
+        deliveries_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+BroadcastMetrics ConnectionManager::Metrics() const {
+    BroadcastMetrics metrics;
+    metrics.broadcasts = broadcasts_.load(std::memory_order_relaxed);
+    metrics.deliveries = deliveries_.load(std::memory_order_relaxed);
+    metrics.dropped = dropped_.load(std::memory_order_relaxed);
+    return metrics;
+}
 
 }  // namespace network
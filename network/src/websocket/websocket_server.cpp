@@ -2,6 +2,7 @@
 
 #include <fmt/base.h>
 
+#include "network/base/async_log.h"
 #include "network/websocket/connection.h"
 
 namespace network {
@@ -15,9 +16,11 @@ void WebsocketServer::StartAccept() {
     auto connection = std::make_shared<Connection>(io_context_);
     acceptor_.async_accept(connection->Socket(), [this, connection](const boost::system::error_code& error_code) {
         if (!error_code) {
+            connection->SetSendQueueOptions(send_options_);
+            connection->WatchIdle(idle_policy_);
             connection->StartAccept();
         } else {
-            fmt::println("[async_accept]: Error code: {}. Message: {}", error_code.value(), error_code.message());
+            NET_LOG_WARN("Accept error code: {}. Message: {}", error_code.value(), error_code.message());
         }
         StartAccept();
     });
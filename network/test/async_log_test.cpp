@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/base/async_log.h"
+
+namespace {
+
+std::string ReadAll(std::FILE* file) {
+    std::string content;
+    std::rewind(file);
+    char buffer[4096];
+    std::size_t size = 0;
+    while ((size = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, size);
+    }
+    return content;
+}
+
+int Evaluate(int& count) { return ++count; }
+
+}  // namespace
+
+TEST(AsyncLogTest, WriteAndRateLimitTest) {
+    auto& log = network::AsyncLog::GetInstance();
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    log.SetOutput(file);
+    const auto before = log.Metrics();
+
+    NET_LOG_WARN("hello {}", 42);
+    // 同一日志点在一秒内超过限额的部分被丢弃, 循环可能跨过一次窗口边界
+    for (int i = 0; i < 300; i++) {
+        NET_LOG_INFO("repeat {}", i);
+    }
+    // 低于编译期级别的日志不求值参数
+    int evaluated = 0;
+    NET_LOG_DEBUG("debug {}", Evaluate(evaluated));
+    EXPECT_EQ(evaluated, 0);
+    log.Flush();
+
+    const auto after = log.Metrics();
+    EXPECT_GE(after.written - before.written, 2U);
+    EXPECT_LE(after.written - before.written, 301U);
+    EXPECT_GE(after.suppressed - before.suppressed, 300U - 2 * network::AsyncLog::kDefaultRatePerSite);
+
+    const std::string content = ReadAll(file);
+    EXPECT_NE(content.find("[WARN][TestBody]: hello 42\n"), std::string::npos);
+    EXPECT_NE(content.find("[INFO][TestBody]: repeat 0\n"), std::string::npos);
+    EXPECT_EQ(content.find("debug"), std::string::npos);
+
+    log.SetOutput(stdout);
+    std::fclose(file);
+}
+
+TEST(AsyncLogTest, ConcurrentPushTest) {
+    auto& log = network::AsyncLog::GetInstance();
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    log.SetOutput(file);
+    const auto before = log.Metrics();
+
+    // 写线程与生产者并发时待写计数不能下溢, 否则之后的日志全部被当作队列已满丢弃
+    constexpr int kThreads = 4;
+    constexpr int kLines = 5000;
+    network::LogRateLimiter limiter(kThreads * kLines);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&log, &limiter, t]() {
+            for (int i = 0; i < kLines; i++) {
+                log.Log(network::LogLevel::kInfo, limiter, "producer", "{} {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    log.Flush();
+
+    const auto after = log.Metrics();
+    EXPECT_EQ(after.dropped - before.dropped, 0U);
+    EXPECT_EQ(after.written - before.written, static_cast<std::uint64_t>(kThreads * kLines));
+
+    log.SetOutput(stdout);
+    std::fclose(file);
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/base/buffer_pool.h"
+#include "network/base/recv_buffer.h"
+#include "network/msg_node.h"
+
+namespace {
+
+using network::Buffer;
+using network::BufferPool;
+using network::BufferSlice;
+using network::MsgId;
+using network::RecvBuffer;
+
+/// @brief 按线上格式编码一条消息
+std::string Encode(const std::string& body, MsgId id = MsgId::kMsgHelloWorld) {
+    network::SendNode node(body.data(), static_cast<network::MsgSizeType>(body.size()), id);
+    return std::string(node.Data(), node.Size());
+}
+
+/// @brief 按 v2 格式编码一帧
+std::string EncodeV2(const std::string& body, std::uint8_t flags, MsgId id = MsgId::kMsgHelloWorld) {
+    network::SendNode node(body.data(), body.size(), id, flags);
+    return std::string(node.Data(), node.Size());
+}
+
+/// @brief 模拟一次读取, 最多写入 Prepare 返回的空间
+void Feed(RecvBuffer& recv_buffer, const std::string& data) {
+    auto buffer = recv_buffer.Prepare();
+    ASSERT_GE(buffer.size(), data.size());
+    ::memcpy(buffer.data(), data.data(), data.size());
+    recv_buffer.Commit(data.size());
+}
+
+}  // namespace
+
+TEST(BufferPoolTest, ReuseTest) {
+    auto pool = std::make_shared<BufferPool>();
+    Buffer* first = nullptr;
+    {
+        auto buffer = pool->Acquire();
+        first = buffer.Get();
+        EXPECT_EQ(buffer->UseCount(), 1);
+        EXPECT_EQ(pool->FreeCount(), 0);
+    }
+    EXPECT_EQ(pool->FreeCount(), 1);
+
+    auto buffer = pool->Acquire();
+    EXPECT_EQ(buffer.Get(), first);
+    EXPECT_EQ(pool->FreeCount(), 0);
+    EXPECT_EQ(pool->AllocatedCount(), 1);
+}
+
+TEST(BufferPoolTest, SliceTest) {
+    auto pool = std::make_shared<BufferPool>();
+    BufferSlice slice;
+    {
+        auto buffer = pool->Acquire();
+        ::memcpy(buffer->Data(), "hello world", 11);
+        slice = BufferSlice(buffer, 6, 5);
+        EXPECT_EQ(buffer->UseCount(), 2);
+    }
+    // 内存块由 BufferSlice 持有, 尚未归还
+    EXPECT_EQ(pool->FreeCount(), 0);
+    EXPECT_EQ(slice.View(), "world");
+
+    slice = BufferSlice();
+    EXPECT_EQ(pool->FreeCount(), 1);
+}
+
+TEST(BufferPoolTest, OutlivePoolTest) {
+    BufferSlice slice;
+    {
+        auto pool = std::make_shared<BufferPool>();
+        auto buffer = pool->Acquire();
+        ::memcpy(buffer->Data(), "data", 4);
+        slice = BufferSlice(buffer, 0, 4);
+    }
+    EXPECT_EQ(slice.View(), "data");
+}
+
+TEST(RecvBufferTest, FrameTest) {
+    auto pool = std::make_shared<BufferPool>();
+    RecvBuffer recv_buffer(pool);
+    RecvBuffer::Piece piece;
+
+    // 一次读取包含两条完整消息和半条消息
+    const std::string third = Encode("third");
+    Feed(recv_buffer, Encode("first") + Encode("second") + third.substr(0, 3));
+
+    ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+    EXPECT_EQ(piece.head.id, MsgId::kMsgHelloWorld);
+    EXPECT_EQ(piece.data.View(), "first");
+    EXPECT_TRUE(piece.frame_end);
+    ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+    EXPECT_EQ(piece.data.View(), "second");
+    EXPECT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kNeedMore);
+
+    Feed(recv_buffer, third.substr(3));
+    ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+    EXPECT_EQ(piece.data.View(), "third");
+    EXPECT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kNeedMore);
+    EXPECT_EQ(recv_buffer.Readable(), 0);
+}
+
+TEST(RecvBufferTest, InvalidHeadTest) {
+    RecvBuffer recv_buffer(std::make_shared<BufferPool>());
+    RecvBuffer::Piece piece;
+
+    Feed(recv_buffer, Encode("x", static_cast<MsgId>(0x7fff)));
+    EXPECT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kInvalid);
+}
+
+TEST(RecvBufferTest, CompactTest) {
+    auto pool = std::make_shared<BufferPool>();
+    RecvBuffer recv_buffer(pool);
+    RecvBuffer::Piece piece;
+
+    const std::string frame = Encode(std::string(network::kMaxLength, 'a'));
+    // 剩余空间不小于 kMaxWholeFrameLength 时才继续读入同一内存块
+    const std::size_t frames_per_buffer =
+        (Buffer::kCapacity - RecvBuffer::kMaxWholeFrameLength) / frame.size() + 1;
+    const std::size_t frame_count = frames_per_buffer * 3;
+    std::vector<BufferSlice> bodies;
+    for (std::size_t i = 0; i < frame_count; i++) {
+        Feed(recv_buffer, frame);
+        ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+        EXPECT_EQ(piece.data.View(), frame.substr(network::kHeadLength));
+        // 第一个内存块中的消息一直被持有, 空间不足时必须切换到新的内存块,
+        // 之后的内存块未被引用, 原地复用
+        if (i < frames_per_buffer) {
+            bodies.push_back(std::move(piece.data));
+        } else {
+            piece.data = BufferSlice();
+        }
+    }
+    EXPECT_EQ(pool->AllocatedCount(), 2);
+    for (const auto& slice : bodies) {
+        EXPECT_EQ(slice.View(), frame.substr(network::kHeadLength));
+    }
+}
+
+TEST(RecvBufferTest, FrameV2Test) {
+    RecvBuffer recv_buffer(std::make_shared<BufferPool>());
+    RecvBuffer::Piece piece;
+
+    // v1 和 v2 帧混用
+    Feed(recv_buffer, EncodeV2("v2 frame", network::kFrameContinuation) + Encode("v1 frame"));
+    ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+    EXPECT_EQ(piece.head.id, MsgId::kMsgHelloWorld);
+    EXPECT_EQ(piece.head.flags, network::kFrameContinuation);
+    EXPECT_EQ(piece.data.View(), "v2 frame");
+    EXPECT_TRUE(piece.frame_end);
+    ASSERT_EQ(recv_buffer.Next(piece), RecvBuffer::ParseResult::kFrame);
+    EXPECT_EQ(piece.head.flags, 0);
+    EXPECT_EQ(piece.data.View(), "v1 frame");
+}
+
+TEST(RecvBufferTest, StreamTest) {
+    RecvBuffer recv_buffer(std::make_shared<BufferPool>());
+    RecvBuffer::Piece piece;
+
+    // 大帧按到达的数据分片交出, 不等待收全
+    std::string body(1024 * 1024, '\0');
+    for (std::size_t i = 0; i < body.size(); i++) {
+        body[i] = static_cast<char>(i % 251);
+    }
+    const std::string frame = EncodeV2(body, 0);
+    std::string received;
+    std::size_t offset = 0;
+    bool frame_end = false;
+    while (offset < frame.size()) {
+        const std::size_t length = std::min<std::size_t>(3000, frame.size() - offset);
+        Feed(recv_buffer, frame.substr(offset, length));
+        offset += length;
+        while (recv_buffer.Next(piece) == RecvBuffer::ParseResult::kFrame) {
+            EXPECT_EQ(piece.offset, received.size());
+            EXPECT_EQ(piece.head.length, body.size());
+            received.append(piece.data.View());
+            frame_end = piece.frame_end;
+        }
+    }
+    EXPECT_TRUE(frame_end);
+    EXPECT_EQ(received, body);
+}
@@ -0,0 +1,220 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "network/http/http_server.h"
+#include "network/http/static_file_handler.h"
+
+namespace {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using asio::ip::tcp;
+using network::HttpRequest;
+using network::HttpResponse;
+using network::RouteParams;
+using network::Router;
+
+HttpRequest MakeRequest(http::verb method, std::string target) {
+    HttpRequest request{method, target, 11};
+    request.set(http::field::host, "127.0.0.1");
+    return request;
+}
+
+http::response<http::string_body> Read(tcp::socket& socket, beast::flat_buffer& buffer, bool head = false) {
+    http::response_parser<http::string_body> parser;
+    parser.skip(head);
+    http::read(socket, buffer, parser);
+    return parser.release();
+}
+
+}  // namespace
+
+TEST(HttpRouterTest, MatchTest) {
+    Router router;
+    std::string hit;
+    auto handler = [&hit](std::string name) {
+        return [&hit, name](const HttpRequest&, const RouteParams&, HttpResponse&) { hit = name; };
+    };
+    router.Get("/users", handler("list"));
+    router.Get("/users/me", handler("me"));
+    router.Get("/users/:id", handler("user"));
+    router.Post("/users/:id", handler("update"));
+    router.Get("/users/:id/files/*path", handler("files"));
+
+    auto call = [&](http::verb method, std::string_view path) {
+        hit.clear();
+        auto match = router.Find(method, path);
+        if (match.handler) {
+            HttpResponse response;
+            (*match.handler)(HttpRequest{}, match.params, response);
+        }
+        return match;
+    };
+
+    EXPECT_TRUE(call(http::verb::get, "/users").handler);
+    EXPECT_EQ(hit, "list");
+    // 静态段优先于参数
+    EXPECT_TRUE(call(http::verb::get, "/users/me").handler);
+    EXPECT_EQ(hit, "me");
+    auto match = call(http::verb::get, "/users/42");
+    EXPECT_EQ(hit, "user");
+    EXPECT_EQ(match.params["id"], "42");
+    call(http::verb::post, "/users/42");
+    EXPECT_EQ(hit, "update");
+    // HEAD 使用 GET 的处理函数
+    call(http::verb::head, "/users/42");
+    EXPECT_EQ(hit, "user");
+
+    match = call(http::verb::get, "/users/7/files/a/b.txt");
+    EXPECT_EQ(hit, "files");
+    EXPECT_EQ(match.params["id"], "7");
+    EXPECT_EQ(match.params["path"], "a/b.txt");
+
+    match = call(http::verb::delete_, "/users/42");
+    EXPECT_FALSE(match.handler);
+    EXPECT_TRUE(match.path_found);
+    match = call(http::verb::get, "/groups");
+    EXPECT_FALSE(match.handler);
+    EXPECT_FALSE(match.path_found);
+}
+
+TEST(HttpServerTest, KeepAliveAndStaticFileTest) {
+    const auto root = std::filesystem::temp_directory_path() / ("http_server_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(root);
+    const std::string content = "0123456789abcdefghij";
+    std::ofstream(root / "data.txt") << content;
+
+    asio::io_context io_context;
+    network::HttpServer server(io_context, 0);
+    server.GetRouter().Get("/hello", [](const HttpRequest&, const RouteParams&, HttpResponse& response) {
+        response.message.body() = "hello";
+    });
+    server.GetRouter().Get("/static/*path", network::MakeStaticFileHandler(root));
+    server.StartAccept();
+    std::thread runner([&io_context]() { io_context.run(); });
+
+    asio::io_context client_context;
+    tcp::socket socket(client_context);
+    socket.connect(tcp::endpoint(asio::ip::address_v4::loopback(), server.Port()));
+    beast::flat_buffer buffer;
+
+    // 流水线: 一次写出多个请求, 在同一个连接上按顺序收到响应
+    std::string requests;
+    for (const char* target : {"/hello", "/missing", "/static/data.txt"}) {
+        std::ostringstream stream;
+        stream << MakeRequest(http::verb::get, target);
+        requests += stream.str();
+    }
+    asio::write(socket, asio::buffer(requests));
+    auto response = Read(socket, buffer);
+    EXPECT_EQ(response.result(), http::status::ok);
+    EXPECT_EQ(response.body(), "hello");
+    EXPECT_TRUE(response.keep_alive());
+    EXPECT_EQ(Read(socket, buffer).result(), http::status::not_found);
+    response = Read(socket, buffer);
+    EXPECT_EQ(response.result(), http::status::ok);
+    EXPECT_EQ(response.body(), content);
+    const std::string etag(response[http::field::etag]);
+    EXPECT_FALSE(etag.empty());
+
+    // 范围请求
+    auto request = MakeRequest(http::verb::get, "/static/data.txt");
+    request.set(http::field::range, "bytes=2-5");
+    http::write(socket, request);
+    response = Read(socket, buffer);
+    EXPECT_EQ(response.result(), http::status::partial_content);
+    EXPECT_EQ(response.body(), "2345");
+    EXPECT_EQ(response[http::field::content_range], "bytes 2-5/20");
+
+    request.set(http::field::range, "bytes=-3");
+    http::write(socket, request);
+    EXPECT_EQ(Read(socket, buffer).body(), "hij");
+
+    request.set(http::field::range, "bytes=100-");
+    http::write(socket, request);
+    EXPECT_EQ(Read(socket, buffer).result(), http::status::range_not_satisfiable);
+
+    // 条件请求
+    request = MakeRequest(http::verb::get, "/static/data.txt");
+    request.set(http::field::if_none_match, etag);
+    http::write(socket, request);
+    EXPECT_EQ(Read(socket, buffer).result(), http::status::not_modified);
+
+    // HEAD 只返回头部
+    http::write(socket, MakeRequest(http::verb::head, "/static/data.txt"));
+    response = Read(socket, buffer, true);
+    EXPECT_EQ(response.result(), http::status::ok);
+    EXPECT_EQ(response[http::field::content_length], std::to_string(content.size()));
+
+    http::write(socket, MakeRequest(http::verb::get, "/static/../data.txt"));
+    EXPECT_EQ(Read(socket, buffer).result(), http::status::forbidden);
+
+    // 客户端要求关闭时服务器回复后关闭连接
+    request = MakeRequest(http::verb::get, "/hello");
+    request.keep_alive(false);
+    http::write(socket, request);
+    response = Read(socket, buffer);
+    EXPECT_FALSE(response.keep_alive());
+    beast::error_code error_code;
+    http::response<http::string_body> extra;
+    http::read(socket, buffer, extra, error_code);
+    EXPECT_EQ(error_code, http::error::end_of_stream);
+
+    socket.close();
+    io_context.stop();
+    runner.join();
+    std::filesystem::remove_all(root);
+}
+
+TEST(HttpServerTest, SlowClientLargeFileTest) {
+    // 写出响应期间不做空闲计时, 读取前停顿超过 keep_alive_timeout 的客户端仍能收到完整的大文件
+    const auto root = std::filesystem::temp_directory_path() / ("http_slow_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(root);
+    const std::string content(32 << 20, 'x');
+    std::ofstream(root / "large.bin", std::ios::binary) << content;
+
+    asio::io_context io_context;
+    network::HttpServerOptions options;
+    options.keep_alive_timeout = std::chrono::seconds(1);
+    network::HttpServer server(io_context, 0, options);
+    server.GetRouter().Get("/static/*path", network::MakeStaticFileHandler(root));
+    server.StartAccept();
+    std::thread runner([&io_context]() { io_context.run(); });
+
+    asio::io_context client_context;
+    tcp::socket socket(client_context);
+    socket.connect(tcp::endpoint(asio::ip::address_v4::loopback(), server.Port()));
+    beast::flat_buffer buffer;
+
+    http::write(socket, MakeRequest(http::verb::get, "/static/large.bin"));
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    http::response_parser<http::string_body> parser;
+    parser.body_limit(content.size());
+    beast::error_code error_code;
+    http::read(socket, buffer, parser, error_code);
+    EXPECT_FALSE(error_code) << error_code.message();
+    EXPECT_EQ(parser.get().result(), http::status::ok);
+    EXPECT_EQ(parser.get().body().size(), content.size());
+    EXPECT_TRUE(parser.get().keep_alive());
+
+    // 响应写完后开始空闲计时, 超时后服务器关闭连接
+    const auto start = std::chrono::steady_clock::now();
+    http::response<http::string_body> extra;
+    http::read(socket, buffer, extra, error_code);
+    EXPECT_TRUE(error_code);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+    socket.close();
+    io_context.stop();
+    runner.join();
+    std::filesystem::remove_all(root);
+}
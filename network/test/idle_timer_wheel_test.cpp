@@ -0,0 +1,76 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "network/base/idle_timer_wheel.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using network::IdlePolicy;
+using network::IdleTimerWheel;
+
+namespace asio = boost::asio;
+
+/// @brief 等待条件成立, 最长等待 timeout, 返回条件是否成立
+template <typename Predicate>
+bool WaitFor(Predicate predicate, std::chrono::milliseconds timeout = 5s) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(IdleTimerWheelTest, TimeoutTest) {
+    asio::io_context io_context;
+    auto& wheel = IdleTimerWheel::ForIoContext(io_context);
+    EXPECT_EQ(&wheel, &IdleTimerWheel::ForIoContext(io_context));
+    wheel.SetTick(5ms);
+
+    // 未启用的策略不检测
+    EXPECT_EQ(wheel.Watch(IdlePolicy{}, [] {}, [] {}), nullptr);
+
+    std::atomic<int> heartbeats{0};
+    std::atomic<int> timeouts{0};
+    auto idle = wheel.Watch(IdlePolicy{100ms, 15ms}, [&] { heartbeats++; }, [&] { timeouts++; });
+    // 测试线程被调度延迟时也不应超时, idle_timeout 远大于 Touch 的间隔
+    std::atomic<int> active_timeouts{0};
+    auto active = wheel.Watch(IdlePolicy{500ms, 0ms}, [] {}, [&] { active_timeouts++; });
+    std::atomic<int> cancelled_timeouts{0};
+    auto cancelled = wheel.Watch(IdlePolicy{20ms, 0ms}, [] {}, [&] { cancelled_timeouts++; });
+    cancelled->Cancel();
+    EXPECT_EQ(wheel.Metrics().watched, 3);
+
+    std::thread runner([&]() {
+        auto guard = asio::make_work_guard(io_context);
+        io_context.run();
+    });
+    // 空闲的连接先发送心跳再超时
+    EXPECT_TRUE(WaitFor([&]() {
+        active->Touch();
+        return timeouts.load() == 1;
+    }));
+    EXPECT_GE(heartbeats, 1);
+    EXPECT_EQ(active_timeouts, 0);
+    EXPECT_EQ(cancelled_timeouts, 0);
+
+    // 停止活动后超时
+    EXPECT_TRUE(WaitFor([&]() { return active_timeouts.load() == 1; }));
+    io_context.stop();
+    runner.join();
+    EXPECT_EQ(timeouts, 1);
+    EXPECT_EQ(cancelled_timeouts, 0);
+
+    auto metrics = wheel.Metrics();
+    EXPECT_EQ(metrics.watched, 0);
+    EXPECT_EQ(metrics.reaped, 2);
+    EXPECT_EQ(metrics.heartbeats, static_cast<std::uint64_t>(heartbeats.load()));
+}
@@ -0,0 +1,52 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "network/base/latency_histogram.h"
+
+using network::LatencyHistogram;
+
+TEST(LatencyHistogramTest, PercentileTest) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.ValueAtPercentile(50), 0);
+
+    for (std::uint64_t i = 1; i <= 1000; i++) {
+        histogram.Record(i * 1000);
+    }
+    EXPECT_EQ(histogram.Count(), 1000);
+    EXPECT_EQ(histogram.Min(), 1000);
+    EXPECT_EQ(histogram.Max(), 1000000);
+    EXPECT_DOUBLE_EQ(histogram.Mean(), 500500.0);
+
+    // 相对误差不超过 1 / kSubBuckets
+    auto expect_near = [&](double percentile, double expected) {
+        const auto value = static_cast<double>(histogram.ValueAtPercentile(percentile));
+        EXPECT_GE(value, expected);
+        EXPECT_LE(value, expected * (1.0 + 1.0 / LatencyHistogram::kSubBuckets));
+    };
+    expect_near(50, 500000);
+    expect_near(99, 990000);
+    expect_near(99.9, 999000);
+    EXPECT_EQ(histogram.ValueAtPercentile(100), 1000000);
+    expect_near(0, 1000);
+}
+
+TEST(LatencyHistogramTest, MergeTest) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    for (std::uint64_t i = 0; i < 2 * LatencyHistogram::kSubBuckets; i++) {
+        first.Record(i);
+    }
+    second.Record(UINT64_MAX);
+    first.Merge(second);
+    EXPECT_EQ(first.Count(), 2 * LatencyHistogram::kSubBuckets + 1);
+    EXPECT_EQ(first.Min(), 0);
+    EXPECT_EQ(first.Max(), UINT64_MAX);
+    // 小值精确记录
+    EXPECT_EQ(first.ValueAtPercentile(50), LatencyHistogram::kSubBuckets);
+    EXPECT_EQ(first.ValueAtPercentile(100), UINT64_MAX);
+
+    first.Reset();
+    EXPECT_EQ(first.Count(), 0);
+    EXPECT_EQ(first.Max(), 0);
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "network/io_service_pool/io_service_pool_session.h"
+#include "network/logic_system.h"
+
+namespace {
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+using network::LogicSystem;
+using network::MsgId;
+
+std::uint64_t TotalProcessed() {
+    auto& logic_system = LogicSystem::GetInstance();
+    std::uint64_t processed = 0;
+    for (std::size_t i = 0; i < logic_system.ShardCount(); i++) {
+        processed += logic_system.ShardMetrics(i).processed;
+    }
+    return processed;
+}
+
+}  // namespace
+
+TEST(LogicSystemTest, SessionOrderTest) {
+    constexpr int kCount = 100;
+    asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto session = std::make_shared<network::IOServicePoolSession>(io_context, nullptr);
+    session->Socket().connect(acceptor.local_endpoint());
+    tcp::socket peer = acceptor.accept();
+
+    auto pool = std::make_shared<network::BufferPool>();
+    const std::uint64_t processed = TotalProcessed();
+    for (int i = 0; i < kCount; i++) {
+        nlohmann::json root;
+        root["id"] = MsgId::kMsgHelloWorld;
+        root["data"] = std::to_string(i);
+        const std::string body = root.dump();
+        auto buffer = pool->Acquire();
+        ::memcpy(buffer->Data(), body.data(), body.size());
+        EXPECT_TRUE(LogicSystem::GetInstance().PostMsgToQueue(std::make_unique<network::LogicNode>(
+            session, MsgId::kMsgHelloWorld, network::BufferSlice(buffer, 0, body.size()))));
+    }
+    while (TotalProcessed() < processed + kCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    io_context.run();
+
+    // 同一会话的消息按投递顺序处理, 回复也按顺序发送
+    for (int i = 0; i < kCount; i++) {
+        char head_data[network::kHeadLength];
+        asio::read(peer, asio::buffer(head_data));
+        const auto head = network::MsgHead::ParseHead(head_data);
+        std::string body(head.length, '\0');
+        asio::read(peer, asio::buffer(body));
+        const auto reader = nlohmann::json::parse(body);
+        EXPECT_NE(reader["data"].get<std::string>().find("\"" + std::to_string(i) + "\""), std::string::npos);
+    }
+}
+
+TEST(LogicSystemTest, LargeMessageTest) {
+    asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto session = std::make_shared<network::IOServicePoolSession>(io_context, nullptr);
+    session->Socket().connect(acceptor.local_endpoint());
+    tcp::socket peer = acceptor.accept();
+    session->Start();
+
+    // 超过 kMaxLength 的消息拆成多个 v2 帧发送, 由会话组装后交给普通回调
+    nlohmann::json root;
+    root["id"] = MsgId::kMsgHelloWorld;
+    root["data"] = std::string(3 * network::kMaxLength, 'x');
+    const std::string request = root.dump();
+    const std::size_t half = request.size() / 2;
+    network::SendNode first(request.data(), half, MsgId::kMsgHelloWorld, network::kFrameContinuation);
+    network::SendNode second(request.data() + half, request.size() - half, MsgId::kMsgHelloWorld, 0);
+    asio::write(peer, asio::buffer(first.Data(), first.Size()));
+    asio::write(peer, asio::buffer(second.Data(), second.Size()));
+
+    const std::uint64_t processed = TotalProcessed();
+    while (TotalProcessed() < processed + 1) {
+        io_context.run_for(std::chrono::milliseconds(1));
+    }
+    io_context.run_for(std::chrono::milliseconds(10));
+
+    // 回复同样超过 kMaxLength, 以 v2 帧发送
+    char head_data[network::kFrameHeadLength];
+    asio::read(peer, asio::buffer(head_data));
+    ASSERT_EQ(static_cast<std::uint8_t>(head_data[0]), network::kFrameV2Magic);
+    const auto head = network::FrameHead::ParseHead(head_data);
+    EXPECT_EQ(head.flags, 0);
+    std::string body(head.length, '\0');
+    asio::read(peer, asio::buffer(body));
+    const auto reader = nlohmann::json::parse(body);
+    EXPECT_NE(reader["data"].get<std::string>().find(root["data"].get<std::string>()), std::string::npos);
+}
+
+TEST(LogicSystemTest, InterleavedChunkTest) {
+    asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto sender = std::make_shared<network::IOServicePoolSession>(io_context, nullptr);
+    auto receiver = std::make_shared<network::IOServicePoolSession>(io_context, nullptr);
+    sender->Socket().connect(acceptor.local_endpoint());
+    acceptor.accept(receiver->Socket());
+    receiver->Start();
+
+    // 分片之间插入其他 id 的单帧消息和心跳, 接收方分别处理, 不关闭连接
+    nlohmann::json root;
+    root["id"] = MsgId::kMsgHelloWorld;
+    root["data"] = std::string(3 * network::kMaxLength, 'x');
+    const std::string request = root.dump();
+    const std::size_t half = request.size() / 2;
+    const std::string other(2 * network::kMaxLength, 'y');
+    const std::uint64_t processed = TotalProcessed();
+    EXPECT_TRUE(sender->SendChunk(request.data(), half, MsgId::kMsgHelloWorld, false));
+    sender->Send("small", MsgId::kMaxId);
+    // 时间轮线程发送的心跳同样可能插在分片之间
+    sender->Send("", 0, MsgId::kMsgHeartbeat);
+    sender->Send(other, MsgId::kMaxId);
+    EXPECT_TRUE(sender->SendChunk(request.data() + half, request.size() - half, MsgId::kMsgHelloWorld, true));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (TotalProcessed() < processed + 3 && std::chrono::steady_clock::now() < deadline) {
+        io_context.run_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(TotalProcessed(), processed + 3);
+    EXPECT_TRUE(receiver->Socket().is_open());
+}
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/io_service_pool/io_service_pool_session.h"
+#include "network/io_service_pool/reuse_port_server.h"
+
+namespace {
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+using network::IOServicePool;
+
+std::size_t TotalLoad(const IOServicePool& pool) {
+    std::size_t load = 0;
+    for (std::size_t i = 0; i < pool.Size(); i++) {
+        load += pool.Load(i);
+    }
+    return load;
+}
+
+}  // namespace
+
+TEST(ReusePortServerTest, AcceptTest) {
+    constexpr std::size_t kClients = 8;
+    // 使用单独的 io_context 池, 停止时不影响其他测试使用的全局实例
+    IOServicePool pool(2);
+    asio::io_context io_context;
+    {
+        network::ReusePortServer<network::IOServicePoolSession> server(io_context, 0, false, pool);
+        server.StartAccept();
+#if defined(__linux__)
+        EXPECT_TRUE(server.IsReusePort());
+#endif
+        // 每个 acceptor 预先创建一个等待连接的会话
+        const std::size_t acceptors = server.IsReusePort() ? pool.Size() : 1;
+
+        std::vector<tcp::socket> clients;
+        for (std::size_t i = 0; i < kClients; i++) {
+            clients.emplace_back(io_context);
+            clients.back().connect(tcp::endpoint(asio::ip::address_v4::loopback(), server.Port()));
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (TotalLoad(pool) != kClients + acceptors && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(TotalLoad(pool), kClients + acceptors);
+        pool.Stop();
+    }
+}
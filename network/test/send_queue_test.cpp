@@ -0,0 +1,101 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/base/mpsc_queue.h"
+#include "network/io_service_pool/io_service_pool_session.h"
+#include "network/msg_node.h"
+
+namespace {
+
+using network::MpscQueue;
+using network::MsgId;
+using network::SendNode;
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+
+struct Item : network::MpscNode {
+    Item(int producer, int seq) : producer_(producer), seq_(seq) {}
+
+    int producer_;
+    int seq_;
+};
+
+}  // namespace
+
+TEST(MpscQueueTest, OrderTest) {
+    MpscQueue<Item> queue;
+    EXPECT_EQ(queue.Pop(), nullptr);
+    for (int i = 0; i < 3; i++) {
+        queue.Push(std::make_unique<Item>(0, i));
+    }
+    for (int i = 0; i < 3; i++) {
+        auto item = queue.Pop();
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(item->seq_, i);
+    }
+    EXPECT_EQ(queue.Pop(), nullptr);
+
+    // 析构时释放队列中剩余的节点
+    queue.Push(std::make_unique<Item>(0, 0));
+}
+
+TEST(MpscQueueTest, MultiProducerTest) {
+    constexpr int kProducers = 4;
+    constexpr int kCount = 10000;
+    MpscQueue<Item> queue;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kCount; i++) {
+                queue.Push(std::make_unique<Item>(p, i));
+            }
+        });
+    }
+
+    // 每个生产者的消息保持入队顺序
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kCount) {
+        auto item = queue.Pop();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(item->seq_, next[item->producer_]);
+        next[item->producer_]++;
+        received++;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+TEST(SessionSendTest, BatchWriteTest) {
+    constexpr int kCount = 200;
+    asio::io_context io_context;
+    tcp::acceptor acceptor(io_context, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto session = std::make_shared<network::IOServicePoolSession>(io_context, nullptr);
+    session->Socket().connect(acceptor.local_endpoint());
+    tcp::socket peer = acceptor.accept();
+
+    // 批量写入上限很小, 确保分多次写入
+    session->SetMaxWriteBytes(256);
+    std::string expected;
+    for (int i = 0; i < kCount; i++) {
+        const std::string body = "message " + std::to_string(i);
+        session->Send(body, MsgId::kMsgHelloWorld);
+        SendNode node(body.data(), static_cast<network::MsgSizeType>(body.size()), MsgId::kMsgHelloWorld);
+        expected.append(node.Data(), node.Size());
+    }
+    io_context.run();
+
+    std::string received(expected.size(), '\0');
+    asio::read(peer, asio::buffer(received));
+    EXPECT_EQ(received, expected);
+}
@@ -0,0 +1,74 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/base/session_registry.h"
+
+namespace {
+
+using network::NextSessionId;
+using network::SessionId;
+using network::SessionRegistry;
+
+struct FakeSession {
+    SessionId id_{NextSessionId()};
+};
+
+}  // namespace
+
+TEST(SessionRegistryTest, BasicTest) {
+    SessionRegistry<FakeSession> registry;
+    auto first = std::make_shared<FakeSession>();
+    auto second = std::make_shared<FakeSession>();
+    EXPECT_LT(first->id_, second->id_);
+
+    EXPECT_TRUE(registry.Add(first->id_, first));
+    EXPECT_FALSE(registry.Add(first->id_, first));
+    EXPECT_TRUE(registry.Add(second->id_, second));
+    EXPECT_EQ(registry.Size(), 2);
+    EXPECT_EQ(registry.Find(first->id_), first);
+
+    std::size_t visited = 0;
+    registry.ForEach([&](const std::shared_ptr<FakeSession>&) { visited++; });
+    EXPECT_EQ(visited, 2);
+
+    EXPECT_EQ(registry.Remove(first->id_), first);
+    EXPECT_EQ(registry.Remove(first->id_), nullptr);
+    EXPECT_EQ(registry.Find(first->id_), nullptr);
+    EXPECT_EQ(registry.Size(), 1);
+}
+
+TEST(SessionRegistryTest, RemoveInForEachTest) {
+    SessionRegistry<FakeSession> registry;
+    for (int i = 0; i < 100; i++) {
+        auto session = std::make_shared<FakeSession>();
+        registry.Add(session->id_, session);
+    }
+    // 回调在锁外执行, 可以删除会话
+    registry.ForEach([&](const std::shared_ptr<FakeSession>& session) { registry.Remove(session->id_); });
+    EXPECT_EQ(registry.Size(), 0);
+}
+
+TEST(SessionRegistryTest, ConcurrentTest) {
+    constexpr int kThreads = 4;
+    constexpr int kCount = 10000;
+    SessionRegistry<FakeSession> registry;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&registry]() {
+            for (int i = 0; i < kCount; i++) {
+                auto session = std::make_shared<FakeSession>();
+                ASSERT_TRUE(registry.Add(session->id_, session));
+                if (i % 2 == 0) {
+                    ASSERT_EQ(registry.Remove(session->id_), session);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(registry.Size(), kThreads * kCount / 2);
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "network/websocket/connection_manager.h"
+#include "network/websocket/websocket_server.h"
+
+namespace {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+using asio::ip::tcp;
+using network::ConnectionManager;
+
+using Client = websocket::stream<tcp::socket>;
+
+std::string ReadText(Client& client) {
+    beast::flat_buffer buffer;
+    client.read(buffer);
+    return beast::buffers_to_string(buffer.data());
+}
+
+/// @brief 等待 manager 中的连接数达到 size, 超时返回 false
+bool WaitForSize(const ConnectionManager& manager, std::size_t size) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (manager.Size() != size && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return manager.Size() == size;
+}
+
+/// @brief 建立一个不读取数据的客户端, 返回服务端对应的连接
+std::shared_ptr<network::Connection> ConnectSlowClient(ConnectionManager& manager, Client& client,
+                                                       unsigned short port) {
+    std::vector<network::SessionId> before;
+    manager.ForEach([&](const std::shared_ptr<network::Connection>& connection) {
+        before.push_back(connection->GetId());
+    });
+    client.next_layer().connect(tcp::endpoint(asio::ip::address_v4::loopback(), port));
+    client.handshake("127.0.0.1", "/");
+    if (!WaitForSize(manager, before.size() + 1)) {
+        return nullptr;
+    }
+    std::shared_ptr<network::Connection> result;
+    manager.ForEach([&](const std::shared_ptr<network::Connection>& connection) {
+        if (std::find(before.begin(), before.end(), connection->GetId()) == before.end()) {
+            result = connection;
+        }
+    });
+    return result;
+}
+
+}  // namespace
+
+TEST(WebsocketBroadcastTest, RoomTest) {
+    constexpr std::size_t kClients = 3;
+    auto& manager = ConnectionManager::GetInstance();
+    const std::size_t base_size = manager.Size();
+    const auto base_metrics = manager.Metrics();
+
+    asio::io_context io_context;
+    network::WebsocketServer server(io_context, 0);
+    server.StartAccept();
+    std::thread runner([&io_context]() { io_context.run(); });
+
+    asio::io_context client_context;
+    std::vector<std::unique_ptr<Client>> clients;
+    for (std::size_t i = 0; i < kClients; i++) {
+        clients.push_back(std::make_unique<Client>(client_context));
+        clients.back()->next_layer().connect(tcp::endpoint(asio::ip::address_v4::loopback(), server.Port()));
+        clients.back()->handshake("127.0.0.1", "/");
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (manager.Size() != base_size + kClients && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(manager.Size(), base_size + kClients);
+
+    // 除一个连接外都加入房间
+    std::vector<std::shared_ptr<network::Connection>> connections;
+    manager.ForEach([&](const std::shared_ptr<network::Connection>& connection) {
+        connections.push_back(connection);
+    });
+    ASSERT_GE(connections.size(), kClients);
+    const std::size_t members = kClients - 1;
+    for (std::size_t i = 0; i < members; i++) {
+        EXPECT_TRUE(manager.Join("room", connections[i]));
+    }
+    EXPECT_EQ(manager.RoomSize("room"), members);
+
+    EXPECT_EQ(manager.Broadcast("room", network::MakeWsFrame("room")), members);
+    EXPECT_EQ(manager.Broadcast(network::MakeWsFrame("all")), connections.size());
+
+    // 房间成员先收到房间消息, 再收到全体消息
+    std::size_t room_received = 0;
+    for (auto& client : clients) {
+        std::string first = ReadText(*client);
+        if (first == "room") {
+            room_received++;
+            EXPECT_EQ(ReadText(*client), "all");
+        } else {
+            EXPECT_EQ(first, "all");
+        }
+    }
+    EXPECT_EQ(room_received, members);
+
+    auto metrics = manager.Metrics();
+    EXPECT_EQ(metrics.broadcasts - base_metrics.broadcasts, 2);
+    EXPECT_EQ(metrics.deliveries - base_metrics.deliveries, members + connections.size());
+
+    // 断开的连接自动退出房间
+    connections.clear();
+    for (auto& client : clients) {
+        client->close(websocket::close_code::normal);
+    }
+    while (manager.Size() != base_size && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(manager.Size(), base_size);
+    EXPECT_EQ(manager.RoomSize("room"), 0);
+
+    io_context.stop();
+    runner.join();
+}
+
+TEST(WebsocketBroadcastTest, SendQueueOverflow) {
+    // 客户端不读取, 大消息填满 socket 缓冲区后积压在发送队列中
+    constexpr std::size_t kFrames = 32;
+    const auto frame = network::MakeWsFrame(std::string(4 << 20, 'x'));
+    auto& manager = ConnectionManager::GetInstance();
+    const std::size_t base_size = manager.Size();
+
+    asio::io_context io_context;
+    network::WebsocketServer drop_server(io_context, 0);
+    drop_server.SetSendQueueOptions({2, network::OverflowPolicy::kDrop});
+    drop_server.StartAccept();
+    network::WebsocketServer disconnect_server(io_context, 0);
+    disconnect_server.SetSendQueueOptions({2, network::OverflowPolicy::kDisconnect});
+    disconnect_server.StartAccept();
+    std::thread runner([&io_context]() { io_context.run(); });
+
+    asio::io_context client_context;
+    Client drop_client(client_context);
+    auto drop_connection = ConnectSlowClient(manager, drop_client, drop_server.Port());
+    ASSERT_TRUE(drop_connection);
+    Client disconnect_client(client_context);
+    auto disconnect_connection = ConnectSlowClient(manager, disconnect_client, disconnect_server.Port());
+    ASSERT_TRUE(disconnect_connection);
+
+    // kDrop: 丢弃放不下的消息, 连接保持
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < kFrames; i++) {
+        if (drop_connection->Send(frame)) {
+            accepted++;
+        }
+    }
+    EXPECT_GT(drop_connection->Dropped(), 0);
+    EXPECT_EQ(accepted + drop_connection->Dropped(), kFrames);
+    EXPECT_EQ(manager.Find(drop_connection->GetId()), drop_connection);
+
+    // kDisconnect: 第一次溢出后关闭连接, 之后的消息都被拒绝, 连接移出 manager 后不能再加入房间
+    std::size_t rejected = 0;
+    for (std::size_t i = 0; i < kFrames; i++) {
+        if (!disconnect_connection->Send(frame)) {
+            rejected++;
+        }
+    }
+    EXPECT_EQ(disconnect_connection->Dropped(), 1);
+    EXPECT_GT(rejected, disconnect_connection->Dropped());
+    ASSERT_TRUE(WaitForSize(manager, base_size + 1));
+    EXPECT_EQ(manager.Find(disconnect_connection->GetId()), nullptr);
+    EXPECT_FALSE(manager.Join("overflow", disconnect_connection));
+    EXPECT_EQ(manager.RoomSize("overflow"), 0);
+
+    drop_connection->Close();
+    ASSERT_TRUE(WaitForSize(manager, base_size));
+    io_context.stop();
+    runner.join();
+}